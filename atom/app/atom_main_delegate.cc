@@ -12,6 +12,8 @@
 #include "atom/app/atom_content_client.h"
 #include "atom/browser/atom_browser_client.h"
 #include "atom/browser/relauncher.h"
+#include "atom/common/asar/archive.h"
+#include "atom/common/asar/extraction_cache.h"
 #include "atom/common/atom_command_line.h"
 #include "atom/utility/atom_content_utility_client.h"
 #include "base/base_switches.h"
@@ -299,6 +301,10 @@ void AtomMainDelegate::PreSandboxStartup() {
     PathService::OverrideAndCreateIfNeeded(
         component_updater::DIR_COMPONENT_USER,
         path.Append(FILE_PATH_LITERAL("Extensions")), false, true);
+    asar::Archive::SetIndexCacheDirectory(
+        path.Append(FILE_PATH_LITERAL("AsarIndexCache")));
+    asar::SetExtractionCacheDirectory(
+        path.Append(FILE_PATH_LITERAL("AsarExtractCache")));
   }
 
   MuonCrashReporterClient::InitForProcess();
@@ -37,6 +37,7 @@
 #include "base/path_service.h"
 #include "base/strings/string_util.h"
 #include "brave/browser/brave_content_browser_client.h"
+#include "brave/common/workers/message_port_registry.h"
 #include "brave/common/workers/v8_worker_thread.h"
 #include "brave/common/workers/worker_bindings.h"
 #include "chrome/common/chrome_paths.h"
@@ -801,8 +802,24 @@ void App::SendMemoryPressureAlert() {
 void App::PostMessage(int worker_id,
                       v8::Local<v8::Value> message,
                       mate::Arguments* args) {
-  if (!brave::WorkerBindings::OnMessage(isolate(), worker_id, message))
-    args->ThrowError("Eror serializing message");
+  v8::Local<v8::Value> transfer_list = v8::Undefined(isolate());
+  args->GetNext(&transfer_list);
+  // Throws on failure.
+  brave::WorkerBindings::OnMessage(isolate(), worker_id, message,
+                                   transfer_list);
+}
+
+v8::Local<v8::Value> App::CreateMessageChannel() {
+  int port1, port2;
+  brave::MessagePortRegistry::GetInstance()->CreateChannel(&port1, &port2);
+  mate::Dictionary channel = mate::Dictionary::CreateEmpty(isolate());
+  channel.Set("port1", port1);
+  channel.Set("port2", port2);
+  return channel.GetHandle();
+}
+
+bool App::ConnectWorkerPort(int worker_id, int port_id) {
+  return brave::WorkerBindings::ConnectPort(worker_id, port_id);
 }
 
 void App::StopWorker(mate::Arguments* args) {
@@ -963,6 +980,8 @@ void App::BuildPrototype(
       .SetMethod("sendMemoryPressureAlert", &App::SendMemoryPressureAlert)
       .SetMethod("_postMessage", &App::PostMessage)
       .SetMethod("_startWorker", &App::StartWorker)
+      .SetMethod("createMessageChannel", &App::CreateMessageChannel)
+      .SetMethod("_connectWorkerPort", &App::ConnectWorkerPort)
       .SetMethod("stopWorker", &App::StopWorker)
       .SetMethod("disableHardwareAcceleration",
                  &App::DisableHardwareAcceleration);
@@ -131,6 +131,8 @@ class App : public AtomBrowserClient::Delegate,
                   mate::Arguments* args);
   void StartWorker(mate::Arguments* args);
   void StopWorker(mate::Arguments* args);
+  v8::Local<v8::Value> CreateMessageChannel();
+  bool ConnectWorkerPort(int worker_id, int port_id);
 
 #if defined(OS_WIN)
   // Get the current Jump List settings.
@@ -2,14 +2,23 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <memory>
+#include <utility>
 
 #include "atom/browser/api/atom_api_cookies.h"
 
 #include "atom/browser/atom_browser_context.h"
 #include "atom/common/native_mate_converters/callback.h"
+#include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "base/files/file.h"
+#include "base/memory/ref_counted.h"
+#include "base/optional.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "base/task_scheduler/post_task.h"
 #include "base/time/time.h"
 #include "base/values.h"
 #include "content/public/browser/browser_context.h"
@@ -32,6 +41,9 @@ struct Converter<atom::api::Cookies::Error> {
                                    atom::api::Cookies::Error val) {
     if (val == atom::api::Cookies::SUCCESS)
       return v8::Null(isolate);
+    else if (val == atom::api::Cookies::EXPORT_FAILED)
+      return v8::Exception::Error(
+          StringToV8(isolate, "Exporting cookies failed"));
     else
       return v8::Exception::Error(StringToV8(isolate, "Setting cookie failed"));
   }
@@ -64,43 +76,67 @@ namespace api {
 
 namespace {
 
-// Returns whether |domain| matches |filter|.
-bool MatchesDomain(std::string filter, const std::string& domain) {
-  // Add a leading '.' character to the filter domain if it doesn't exist.
-  if (net::cookie_util::DomainIsHostOnly(filter))
-    filter.insert(0, ".");
+// Cookies delivered per callback by Cookies::Query, unless asked otherwise.
+const size_t kDefaultQueryChunkSize = 1000;
 
-  std::string sub_domain(domain);
+// Returns whether |domain| is |filter| or one of its subdomains. |filter|
+// starts with a '.' character.
+bool MatchesDomain(base::StringPiece filter, base::StringPiece domain) {
   // Strip any leading '.' character from the input cookie domain.
-  if (!net::cookie_util::DomainIsHostOnly(sub_domain))
-    sub_domain = sub_domain.substr(1);
-
-  // Now check whether the domain argument is a subdomain of the filter domain.
-  for (sub_domain.insert(0, "."); sub_domain.length() >= filter.length();) {
-    if (sub_domain == filter)
-      return true;
-    const size_t next_dot = sub_domain.find('.', 1);  // Skip over leading dot.
-    sub_domain.erase(0, next_dot);
-  }
-  return false;
+  if (!domain.empty() && domain[0] == '.')
+    domain.remove_prefix(1);
+
+  // The leading '.' of |filter| makes any suffix match a subdomain.
+  return domain == filter.substr(1) || domain.ends_with(filter);
 }
 
-// Returns whether |cookie| matches |filter|.
-bool MatchesCookie(const base::DictionaryValue* filter,
-                   const net::CanonicalCookie& cookie) {
+// A cookie filter read once from its JS object, so matching a cookie does no
+// dictionary lookups or allocations.
+struct CookieFilter {
+  std::string url;
+  base::Optional<std::string> name;
+  base::Optional<std::string> path;
+  // Always starts with a '.' character.
+  base::Optional<std::string> domain;
+  base::Optional<bool> secure;
+  base::Optional<bool> session;
+
+  // Returns whether |cookie| matches the filter.
+  bool Matches(const net::CanonicalCookie& cookie) const {
+    if (name && *name != cookie.Name())
+      return false;
+    if (path && *path != cookie.Path())
+      return false;
+    if (domain && !MatchesDomain(*domain, cookie.Domain()))
+      return false;
+    if (secure && *secure != cookie.IsSecure())
+      return false;
+    if (session && *session != !cookie.IsPersistent())
+      return false;
+    return true;
+  }
+};
+
+CookieFilter CompileCookieFilter(const base::DictionaryValue& filter) {
+  CookieFilter compiled;
   std::string str;
   bool b;
-  if (filter->GetString("name", &str) && str != cookie.Name())
-    return false;
-  if (filter->GetString("path", &str) && str != cookie.Path())
-    return false;
-  if (filter->GetString("domain", &str) && !MatchesDomain(str, cookie.Domain()))
-    return false;
-  if (filter->GetBoolean("secure", &b) && b != cookie.IsSecure())
-    return false;
-  if (filter->GetBoolean("session", &b) && b != !cookie.IsPersistent())
-    return false;
-  return true;
+  filter.GetString("url", &compiled.url);
+  if (filter.GetString("name", &str))
+    compiled.name = str;
+  if (filter.GetString("path", &str))
+    compiled.path = str;
+  if (filter.GetString("domain", &str)) {
+    // Add a leading '.' character to the filter domain if it doesn't exist.
+    if (net::cookie_util::DomainIsHostOnly(str))
+      str.insert(0, ".");
+    compiled.domain = str;
+  }
+  if (filter.GetBoolean("secure", &b))
+    compiled.secure = b;
+  if (filter.GetBoolean("session", &b))
+    compiled.session = b;
+  return compiled;
 }
 
 // Helper to returns the CookieStore.
@@ -115,33 +151,70 @@ void RunCallbackInUI(const base::Closure& callback) {
 }
 
 // Remove cookies from |list| not matching |filter|, and pass it to |callback|.
-void FilterCookies(std::unique_ptr<base::DictionaryValue> filter,
+void FilterCookies(const CookieFilter& filter,
                    const Cookies::GetCallback& callback,
                    const net::CookieList& list) {
   net::CookieList result;
   for (const auto& cookie : list) {
-    if (MatchesCookie(filter.get(), cookie))
+    if (filter.Matches(cookie))
       result.push_back(cookie);
   }
-  RunCallbackInUI(base::Bind(callback, Cookies::SUCCESS, result));
+  RunCallbackInUI(
+      base::Bind(callback, Cookies::SUCCESS, base::Passed(&result)));
+}
+
+// Passes the cookies from |list| matching |filter| to |callback| in chunks of
+// |chunk_size|, each in its own UI task so converting them doesn't block the
+// UI thread in one go.
+void FilterCookiesInChunks(const CookieFilter& filter,
+                           size_t chunk_size,
+                           const Cookies::QueryCallback& callback,
+                           const net::CookieList& list) {
+  net::CookieList chunk;
+  for (const auto& cookie : list) {
+    if (!filter.Matches(cookie))
+      continue;
+    chunk.push_back(cookie);
+    if (chunk.size() == chunk_size) {
+      RunCallbackInUI(
+          base::Bind(callback, Cookies::SUCCESS, base::Passed(&chunk), false));
+      chunk = net::CookieList();
+    }
+  }
+  RunCallbackInUI(
+      base::Bind(callback, Cookies::SUCCESS, base::Passed(&chunk), true));
+}
+
+// Asks the cookie store for the cookies of |filter|'s url in IO thread, and
+// passes them to |callback|.
+void GetCookiesForFilterOnIO(
+    scoped_refptr<net::URLRequestContextGetter> getter,
+    const CookieFilter& filter,
+    net::CookieStore::GetCookieListCallback callback) {
+  // Empty url will match all url cookies.
+  if (filter.url.empty())
+    GetCookieStore(getter)->GetAllCookiesAsync(std::move(callback));
+  else
+    GetCookieStore(getter)->GetAllCookiesForURLAsync(GURL(filter.url),
+        std::move(callback));
 }
 
 // Receives cookies matching |filter| in IO thread.
 void GetCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
-                    std::unique_ptr<base::DictionaryValue> filter,
+                    const CookieFilter& filter,
                     const Cookies::GetCallback& callback) {
-  std::string url;
-  filter->GetString("url", &url);
-
-  auto filtered_callback =
-      base::Bind(FilterCookies, base::Passed(&filter), callback);
+  GetCookiesForFilterOnIO(getter, filter,
+                          base::Bind(FilterCookies, filter, callback));
+}
 
-  // Empty url will match all url cookies.
-  if (url.empty())
-    GetCookieStore(getter)->GetAllCookiesAsync(filtered_callback);
-  else
-    GetCookieStore(getter)->GetAllCookiesForURLAsync(GURL(url),
-        filtered_callback);
+// Receives cookies matching |filter| in chunks in IO thread.
+void QueryCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                      const CookieFilter& filter,
+                      size_t chunk_size,
+                      const Cookies::QueryCallback& callback) {
+  GetCookiesForFilterOnIO(
+      getter, filter,
+      base::Bind(FilterCookiesInChunks, filter, chunk_size, callback));
 }
 
 // Removes cookie with |url| and |name| in IO thread.
@@ -158,10 +231,11 @@ void OnSetCookie(const Cookies::SetCallback& callback, bool success) {
       base::Bind(callback, success ? Cookies::SUCCESS : Cookies::FAILED));
 }
 
-// Sets cookie with |details| in IO thread.
-void SetCookieOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
-                   std::unique_ptr<base::DictionaryValue> details,
-                   const Cookies::SetCallback& callback) {
+// Creates the cookie described by |details|, or null if it is invalid.
+std::unique_ptr<net::CanonicalCookie> CreateCookie(
+    const base::DictionaryValue* details,
+    bool* secure_source,
+    bool* modify_http_only) {
   std::string url, name, value, domain, path;
   bool secure = false;
   bool http_only = false;
@@ -197,17 +271,185 @@ void SetCookieOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
         base::Time::FromDoubleT(last_access_date);
   }
 
+  details->GetBoolean("secure_source", secure_source);
+  details->GetBoolean("modify_http_only", modify_http_only);
+
+  return net::CanonicalCookie::CreateSanitizedCookie(
+      GURL(url), name, value, domain, path, creation_time, expiration_time,
+      last_access_time, secure, http_only, net::CookieSameSite::DEFAULT_MODE,
+      net::COOKIE_PRIORITY_DEFAULT);
+}
+
+// Sets cookie with |details| in IO thread.
+void SetCookieOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                   std::unique_ptr<base::DictionaryValue> details,
+                   const Cookies::SetCallback& callback) {
   bool secure_source = false;
   bool modify_http_only = false;
-  details->GetBoolean("secure_source", &secure_source);
-  details->GetBoolean("modify_http_only", &modify_http_only);
-
+  std::unique_ptr<net::CanonicalCookie> cookie =
+      CreateCookie(details.get(), &secure_source, &modify_http_only);
   GetCookieStore(getter)->SetCanonicalCookieAsync(
-      net::CanonicalCookie::CreateSanitizedCookie(
-          GURL(url), name, value, domain, path, creation_time, expiration_time,
-          last_access_time, secure, http_only,
-          net::CookieSameSite::DEFAULT_MODE, net::COOKIE_PRIORITY_DEFAULT),
-      secure_source, modify_http_only, base::Bind(OnSetCookie, callback));
+      std::move(cookie), secure_source, modify_http_only,
+      base::Bind(OnSetCookie, callback));
+}
+
+// Counts down the mutations of one setBatch or removeBatch call in IO thread,
+// and flushes the store once when they are all done.
+class CookieBatch : public base::RefCounted<CookieBatch> {
+ public:
+  CookieBatch(scoped_refptr<net::URLRequestContextGetter> getter,
+              size_t size,
+              const Cookies::BatchCallback& callback)
+      : getter_(getter), pending_(size), callback_(callback) {}
+
+  void OnDone(int index, bool success) {
+    if (!success)
+      failed_.push_back(index);
+    if (--pending_ == 0)
+      Flush();
+  }
+
+  void OnRemoved(int index) { OnDone(index, true); }
+
+  void Flush() {
+    Cookies::Error error = failed_.empty() ? Cookies::SUCCESS : Cookies::FAILED;
+    GetCookieStore(getter_)->FlushStore(base::BindOnce(
+        RunCallbackInUI, base::Bind(callback_, error, failed_)));
+  }
+
+ private:
+  friend class base::RefCounted<CookieBatch>;
+
+  ~CookieBatch() {}
+
+  scoped_refptr<net::URLRequestContextGetter> getter_;
+  size_t pending_;
+  std::vector<int> failed_;
+  Cookies::BatchCallback callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(CookieBatch);
+};
+
+// Sets all cookies of |details_list| in one IO task.
+void SetCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                    std::unique_ptr<base::ListValue> details_list,
+                    const Cookies::BatchCallback& callback) {
+  scoped_refptr<CookieBatch> batch(
+      new CookieBatch(getter, details_list->GetSize(), callback));
+  if (details_list->empty()) {
+    batch->Flush();
+    return;
+  }
+
+  net::CookieStore* store = GetCookieStore(getter);
+  for (size_t i = 0; i < details_list->GetSize(); ++i) {
+    const base::DictionaryValue* details = nullptr;
+    bool secure_source = false;
+    bool modify_http_only = false;
+    std::unique_ptr<net::CanonicalCookie> cookie;
+    int index = static_cast<int>(i);
+    if (details_list->GetDictionary(i, &details))
+      cookie = CreateCookie(details, &secure_source, &modify_http_only);
+    if (!cookie) {
+      batch->OnDone(index, false);
+      continue;
+    }
+    store->SetCanonicalCookieAsync(
+        std::move(cookie), secure_source, modify_http_only,
+        base::Bind(&CookieBatch::OnDone, batch, index));
+  }
+}
+
+// Removes all cookies of |cookies|, given as {url, name}, in one IO task.
+void RemoveCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                       std::unique_ptr<base::ListValue> cookies,
+                       const Cookies::BatchCallback& callback) {
+  scoped_refptr<CookieBatch> batch(
+      new CookieBatch(getter, cookies->GetSize(), callback));
+  if (cookies->empty()) {
+    batch->Flush();
+    return;
+  }
+
+  net::CookieStore* store = GetCookieStore(getter);
+  for (size_t i = 0; i < cookies->GetSize(); ++i) {
+    const base::DictionaryValue* cookie = nullptr;
+    std::string url, name;
+    int index = static_cast<int>(i);
+    if (!cookies->GetDictionary(i, &cookie) ||
+        !cookie->GetString("url", &url) || !cookie->GetString("name", &name)) {
+      batch->OnDone(index, false);
+      continue;
+    }
+    store->DeleteCookieAsync(GURL(url), name,
+                             base::Bind(&CookieBatch::OnRemoved, batch, index));
+  }
+}
+
+// Writes |list| to |path| in the Netscape cookies.txt format, a piece at a
+// time. Returns the number of cookies written, or -1 on failure.
+int WriteCookiesToFile(const base::FilePath& path,
+                       const net::CookieList& list) {
+  const size_t kWriteChunkSize = 64 * 1024;
+
+  base::File file(path, base::File::FLAG_CREATE_ALWAYS |
+                            base::File::FLAG_WRITE);
+  if (!file.IsValid())
+    return -1;
+
+  std::string buffer("# Netscape HTTP Cookie File\n");
+  for (const auto& cookie : list) {
+    if (cookie.IsHttpOnly())
+      buffer.append("#HttpOnly_");
+    buffer.append(cookie.Domain());
+    buffer.append(net::cookie_util::DomainIsHostOnly(cookie.Domain()) ?
+                  "\tFALSE\t" : "\tTRUE\t");
+    buffer.append(cookie.Path());
+    buffer.append(cookie.IsSecure() ? "\tTRUE\t" : "\tFALSE\t");
+    buffer.append(base::Int64ToString(
+        cookie.IsPersistent() ? cookie.ExpiryDate().ToTimeT() : 0));
+    buffer.push_back('\t');
+    buffer.append(cookie.Name());
+    buffer.push_back('\t');
+    buffer.append(cookie.Value());
+    buffer.push_back('\n');
+
+    if (buffer.size() >= kWriteChunkSize) {
+      if (file.WriteAtCurrentPos(buffer.data(), buffer.size()) !=
+          static_cast<int>(buffer.size()))
+        return -1;
+      buffer.clear();
+    }
+  }
+  if (file.WriteAtCurrentPos(buffer.data(), buffer.size()) !=
+      static_cast<int>(buffer.size()))
+    return -1;
+  return static_cast<int>(list.size());
+}
+
+void WriteCookiesToFileInBackground(const base::FilePath& path,
+                                    const Cookies::ExportCallback& callback,
+                                    const net::CookieList& list) {
+  int count = WriteCookiesToFile(path, list);
+  RunCallbackInUI(base::Bind(
+      callback, count < 0 ? Cookies::EXPORT_FAILED : Cookies::SUCCESS,
+      std::max(count, 0)));
+}
+
+// Hands the cookie list over to a blocking thread to be written.
+void OnCookiesForExport(const base::FilePath& path,
+                        const Cookies::ExportCallback& callback,
+                        const net::CookieList& list) {
+  base::PostTaskWithTraits(
+      FROM_HERE, {base::MayBlock(), base::TaskPriority::BACKGROUND},
+      base::BindOnce(WriteCookiesToFileInBackground, path, callback, list));
+}
+
+void ExportCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                       const base::FilePath& path,
+                       const Cookies::ExportCallback& callback) {
+  GetCookieStore(getter)->GetAllCookiesAsync(
+      base::Bind(OnCookiesForExport, path, callback));
 }
 
 }  // namespace
@@ -234,11 +476,40 @@ void Cookies::GetAll(const base::DictionaryValue& filter,
 
 void Cookies::Get(const base::DictionaryValue& filter,
                   const GetCallback& callback) {
-  std::unique_ptr<base::DictionaryValue> copied(filter.CreateDeepCopy());
   auto getter = base::RetainedRef(request_context_getter_);
   content::BrowserThread::PostTask(
       BrowserThread::IO, FROM_HERE,
-      base::Bind(GetCookiesOnIO, getter, Passed(&copied), callback));
+      base::Bind(GetCookiesOnIO, getter, CompileCookieFilter(filter),
+                 callback));
+}
+
+void Cookies::Query(mate::Arguments* args,
+                    const base::DictionaryValue& filter) {
+  size_t chunk_size = kDefaultQueryChunkSize;
+  mate::Dictionary options;
+  v8::Local<v8::Value> next = args->PeekNext();
+  if (!next.IsEmpty() && !next->IsFunction() && args->GetNext(&options)) {
+    int size;
+    if (options.Get("chunkSize", &size)) {
+      if (size <= 0) {
+        args->ThrowError("chunkSize must be positive");
+        return;
+      }
+      chunk_size = size;
+    }
+  }
+
+  QueryCallback callback;
+  if (!args->GetNext(&callback)) {
+    args->ThrowError();
+    return;
+  }
+
+  auto getter = base::RetainedRef(request_context_getter_);
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(QueryCookiesOnIO, getter, CompileCookieFilter(filter),
+                 chunk_size, callback));
 }
 
 void Cookies::Remove(const GURL& url, const std::string& name,
@@ -258,6 +529,32 @@ void Cookies::Set(const base::DictionaryValue& details,
       base::Bind(SetCookieOnIO, getter, Passed(&copied), callback));
 }
 
+void Cookies::SetBatch(const base::ListValue& details_list,
+                       const BatchCallback& callback) {
+  std::unique_ptr<base::ListValue> copied(details_list.CreateDeepCopy());
+  auto getter = base::RetainedRef(request_context_getter_);
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(SetCookiesOnIO, getter, Passed(&copied), callback));
+}
+
+void Cookies::RemoveBatch(const base::ListValue& cookies,
+                          const BatchCallback& callback) {
+  std::unique_ptr<base::ListValue> copied(cookies.CreateDeepCopy());
+  auto getter = base::RetainedRef(request_context_getter_);
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(RemoveCookiesOnIO, getter, Passed(&copied), callback));
+}
+
+void Cookies::ExportAll(const base::FilePath& path,
+                        const ExportCallback& callback) {
+  auto getter = base::RetainedRef(request_context_getter_);
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(ExportCookiesOnIO, getter, path, callback));
+}
+
 // static
 mate::Handle<Cookies> Cookies::Create(
     v8::Isolate* isolate,
@@ -271,8 +568,12 @@ void Cookies::BuildPrototype(v8::Isolate* isolate,
   prototype->SetClassName(mate::StringToV8(isolate, "Cookies"));
   mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
       .SetMethod("get", &Cookies::Get)
+      .SetMethod("query", &Cookies::Query)
       .SetMethod("remove", &Cookies::Remove)
       .SetMethod("set", &Cookies::Set)
+      .SetMethod("setBatch", &Cookies::SetBatch)
+      .SetMethod("removeBatch", &Cookies::RemoveBatch)
+      .SetMethod("exportAll", &Cookies::ExportAll)
       .SetMethod("getAll", &Cookies::GetAll);
 }
 
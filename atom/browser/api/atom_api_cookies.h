@@ -6,6 +6,7 @@
 #define ATOM_BROWSER_API_ATOM_API_COOKIES_H_
 
 #include <string>
+#include <vector>
 
 #include "atom/browser/api/trackable_object.h"
 #include "base/callback.h"
@@ -14,6 +15,12 @@
 
 namespace base {
 class DictionaryValue;
+class FilePath;
+class ListValue;
+}
+
+namespace mate {
+class Arguments;
 }
 
 namespace net {
@@ -31,10 +38,17 @@ class Cookies : public mate::TrackableObject<Cookies> {
   enum Error {
     SUCCESS,
     FAILED,
+    EXPORT_FAILED,
   };
 
   using GetCallback = base::Callback<void(Error, const net::CookieList&)>;
   using SetCallback = base::Callback<void(Error)>;
+  // Called once per chunk of matching cookies, |done| is true for the last.
+  using QueryCallback =
+      base::Callback<void(Error, const net::CookieList&, bool done)>;
+  // Gets the indices of the cookies that could not be set.
+  using BatchCallback = base::Callback<void(Error, const std::vector<int>&)>;
+  using ExportCallback = base::Callback<void(Error, int count)>;
 
   static mate::Handle<Cookies> Create(v8::Isolate* isolate,
                                       AtomBrowserContext* browser_context);
@@ -49,9 +63,15 @@ class Cookies : public mate::TrackableObject<Cookies> {
 
   void GetAll(const base::DictionaryValue& filter, const GetCallback& callback);
   void Get(const base::DictionaryValue& filter, const GetCallback& callback);
+  void Query(mate::Arguments* args, const base::DictionaryValue& filter);
   void Remove(const GURL& url, const std::string& name,
               const base::Closure& callback);
   void Set(const base::DictionaryValue& details, const SetCallback& callback);
+  void SetBatch(const base::ListValue& details_list,
+                const BatchCallback& callback);
+  void RemoveBatch(const base::ListValue& cookies,
+                   const BatchCallback& callback);
+  void ExportAll(const base::FilePath& path, const ExportCallback& callback);
 
  private:
   net::URLRequestContextGetter* request_context_getter_;
@@ -4,6 +4,7 @@
 
 #include "atom/browser/api/atom_api_importer.h"
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -31,7 +32,8 @@ namespace api {
 
 Importer::Importer(v8::Isolate* isolate)
   : importer_host_(NULL),
-  import_did_succeed_(false) {
+  import_did_succeed_(false),
+  weak_factory_(this) {
     Init(isolate);
     profile_writer_ = new ProfileWriter(NULL);
 }
@@ -39,6 +41,8 @@ Importer::Importer(v8::Isolate* isolate)
 Importer::~Importer() {
   if (importer_host_)
     importer_host_->set_observer(NULL);
+  // The writer outlives us while the import host holds on to it.
+  profile_writer_->Initialize(nullptr);
 }
 
 void Importer::InitializeImporter() {
@@ -128,6 +132,19 @@ void Importer::StartImport(
                                       profile_writer_.get());
 }
 
+void Importer::SetStreamingOptions(const base::DictionaryValue& options) {
+  int chunk_size = 0;
+  int max_pending_chunks = 0;
+  options.GetInteger("chunkSize", &chunk_size);
+  options.GetInteger("maxPendingChunks", &max_pending_chunks);
+  profile_writer_->SetStreamingOptions(std::max(chunk_size, 0),
+                                       std::max(max_pending_chunks, 0));
+}
+
+void Importer::ChunkProcessed() {
+  profile_writer_->ChunkProcessed();
+}
+
 void Importer::InitializePage() {
   DCHECK_CURRENTLY_ON(BrowserThread::UI);
 
@@ -191,7 +208,14 @@ void Importer::ImportEnded() {
   importer_host_->set_observer(NULL);
   importer_host_ = NULL;
 
-  if (import_did_succeed_) {
+  // Chunks still being streamed belong to this import.
+  profile_writer_->RunAfterPendingChunks(
+      base::BindOnce(&Importer::EmitImportEnded, weak_factory_.GetWeakPtr(),
+                     import_did_succeed_));
+}
+
+void Importer::EmitImportEnded(bool import_did_succeed) {
+  if (import_did_succeed) {
     Emit("import-success");
   } else {
     Emit("import-dismiss");
@@ -205,7 +229,9 @@ void Importer::BuildPrototype(v8::Isolate* isolate,
   mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
       .SetMethod("initialize", &Importer::InitializeImporter)
       .SetMethod("importData", &Importer::ImportData)
-      .SetMethod("importHTML", &Importer::ImportHTML);
+      .SetMethod("importHTML", &Importer::ImportHTML)
+      .SetMethod("setStreamingOptions", &Importer::SetStreamingOptions)
+      .SetMethod("chunkProcessed", &Importer::ChunkProcessed);
 }
 
 }  // namespace api
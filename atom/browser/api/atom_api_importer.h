@@ -12,6 +12,7 @@
 #include "atom/browser/api/event_emitter.h"
 #include "atom/browser/api/trackable_object.h"
 #include "base/callback.h"
+#include "base/memory/weak_ptr.h"
 #include "base/values.h"
 #include "chrome/browser/importer/importer_progress_observer.h"
 #include "chrome/browser/profiles/profile.h"
@@ -48,6 +49,9 @@ class Importer: public mate::EventEmitter<Importer>,
   void ImportHTML(const base::FilePath& path);
   void StartImport(const importer::SourceProfile& source_profile,
                    uint16_t imported_items);
+  void SetStreamingOptions(const base::DictionaryValue& options);
+  void ChunkProcessed();
+  void EmitImportEnded(bool import_did_succeed);
 
   // importer::ImporterProgressObserver:
   void ImportStarted() override;
@@ -65,6 +69,8 @@ class Importer: public mate::EventEmitter<Importer>,
 
   bool import_did_succeed_;
 
+  base::WeakPtrFactory<Importer> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(Importer);
 };
 
@@ -2,6 +2,7 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -41,6 +42,7 @@
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/options_switches.h"
+#include "base/lazy_instance.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "brave/browser/brave_browser_context.h"
@@ -48,8 +50,13 @@
 #include "brave/browser/guest_view/tab_view/tab_view_guest.h"
 #include "brave/browser/password_manager/brave_password_manager_client.h"
 #include "brave/browser/plugins/brave_plugin_service_filter.h"
+#include "brave/browser/renderer_host/message_port_message_filter.h"
 #include "brave/browser/renderer_preferences_helper.h"
+#include "brave/browser/resource_coordinator/guest_tab_manager.h"
 #include "brave/common/extensions/shared_memory_bindings.h"
+#include "brave/common/extensions/shared_memory_ring.h"
+#include "brave/common/extensions/structured_clone.h"
+#include "brave/common/workers/message_port_registry.h"
 #include "brightray/browser/inspectable_web_contents.h"
 #include "brightray/browser/inspectable_web_contents_view.h"
 #include "chrome/browser/browser_process.h"
@@ -400,6 +407,30 @@ struct FrameDispatchHelper {
 
 namespace {
 
+// A frame gets a ring for each script context that sends through one, which
+// in practice is one or two. Each can map up to 64MB, so a frame can't ask
+// for more than this.
+const size_t kMaxReceiveRingsPerFrame = 4;
+
+// The shared memory rings of a frame, see brave::SharedMemoryRing. Each ring
+// belongs to a script context of the frame, which creates it and closes it
+// when the context goes away.
+struct FrameRings {
+  FrameRings() : send_ring_id(0) {}
+
+  bool empty() const { return !send_ring && receive_rings.empty(); }
+
+  // Read by the script context that handles messages from the browser.
+  int send_ring_id;
+  std::unique_ptr<brave::SharedMemoryRing> send_ring;
+  // By the ring id chosen by the renderer.
+  std::map<int, std::unique_ptr<brave::SharedMemoryRing>> receive_rings;
+};
+
+// By render process id and frame routing id.
+base::LazyInstance<std::map<std::pair<int, int>, FrameRings>>::Leaky
+    g_frame_rings = LAZY_INSTANCE_INITIALIZER;
+
 mate::Handle<api::Session> SessionFromOptions(v8::Isolate* isolate,
     const mate::Dictionary& options) {
   mate::Handle<api::Session> session;
@@ -1326,6 +1357,14 @@ void WebContents::RenderViewReady() {
   Emit("render-view-ready");
 }
 
+void WebContents::RenderFrameDeleted(
+    content::RenderFrameHost* render_frame_host) {
+  g_frame_rings.Get().erase(std::make_pair(
+      render_frame_host->GetProcess()->GetID(),
+      render_frame_host->GetRoutingID()));
+  mate::internal::ForgetSender(render_frame_host);
+}
+
 void WebContents::RenderViewDeleted(content::RenderViewHost* render_view_host) {
   Emit("render-view-deleted", render_view_host->GetProcess()->GetID());
 }
@@ -1534,7 +1573,14 @@ bool WebContents::OnMessageReceived(const IPC::Message& message,
     IPC_MESSAGE_HANDLER(AtomViewHostMsg_Message, OnRendererMessage)
     IPC_MESSAGE_FORWARD_DELAY_REPLY(AtomViewHostMsg_Message_Sync, &helper,
                                     FrameDispatchHelper::OnRendererMessageSync)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_Message_Cloned,
+                        OnRendererMessageCloned)
     IPC_MESSAGE_HANDLER(AtomViewHostMsg_Message_Shared, OnRendererMessageShared)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_SetupRing, OnRendererSetupRing)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_SetupBrowserRing,
+                        OnRendererSetupBrowserRing)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_CloseRing, OnRendererCloseRing)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_Message_Ring, OnRendererMessageRing)
     IPC_MESSAGE_HANDLER_CODE(ViewHostMsg_SetCursor, OnCursorChange,
                              handled = false)
     IPC_MESSAGE_UNHANDLED(handled = false)
@@ -2288,14 +2334,17 @@ void WebContents::SetAutoDiscardable(bool auto_discardable) {
   Emit("set-auto-discardable", auto_discardable);
 }
 
-void WebContents::Discard() {
+bool WebContents::Discard() {
   auto tab_helper = extensions::TabHelper::FromWebContents(web_contents());
-  if (tab_helper) {
-    if (!Emit("will-discard") && tab_helper->Discard())
-      Emit("discarded");
-    else
-      Emit("discard-aborted");
+  if (!tab_helper)
+    return false;
+
+  if (!Emit("will-discard") && tab_helper->Discard()) {
+    Emit("discarded");
+    return true;
   }
+  Emit("discard-aborted");
+  return false;
 }
 
 #if BUILDFLAG(ENABLE_EXTENSIONS)
@@ -2338,6 +2387,80 @@ bool WebContents::SendIPCSharedMemory(int render_process_id,
       rfh->GetRoutingID(), channel, memory_handle));
 }
 
+bool WebContents::SendIPCClonedInternal(mate::Arguments* args) {
+  auto rfh = web_contents()->GetMainFrame();
+  return SendIPCCloned(
+      rfh->GetProcess()->GetID(), rfh->GetRoutingID(), args);
+}
+
+// static
+bool WebContents::SendIPCCloned(int render_process_id,
+                                int render_frame_id,
+                                mate::Arguments* args) {
+  base::string16 channel;
+  v8::Local<v8::Value> arguments;
+  if (!args->GetNext(&channel) || !args->GetNext(&arguments)) {
+    args->ThrowError();
+    return false;
+  }
+
+  auto rfh =
+      content::RenderFrameHost::FromID(render_process_id, render_frame_id);
+  if (!rfh)
+    return false;
+
+  // Throws on failure.
+  std::vector<uint8_t> data;
+  if (!brave::SerializeValue(args->isolate(), arguments, &data))
+    return false;
+
+  return rfh->Send(
+      new AtomViewMsg_Message_Cloned(rfh->GetRoutingID(), channel, data));
+}
+
+bool WebContents::SendIPCRingInternal(mate::Arguments* args) {
+  auto rfh = web_contents()->GetMainFrame();
+  return SendIPCRing(
+      rfh->GetProcess()->GetID(), rfh->GetRoutingID(), args);
+}
+
+// static
+bool WebContents::SendIPCRing(int render_process_id,
+                              int render_frame_id,
+                              mate::Arguments* args) {
+  base::string16 channel;
+  v8::Local<v8::Value> value;
+  if (!args->GetNext(&channel) || !args->GetNext(&value)) {
+    args->ThrowError();
+    return false;
+  }
+
+  auto rfh =
+      content::RenderFrameHost::FromID(render_process_id, render_frame_id);
+  if (!rfh)
+    return false;
+
+  // The frame has no script context reading a ring yet, or any more.
+  auto frame = g_frame_rings.Get().find(
+      std::make_pair(render_process_id, render_frame_id));
+  if (frame == g_frame_rings.Get().end() || !frame->second.send_ring)
+    return false;
+  FrameRings& rings = frame->second;
+
+  uint64_t sequence;
+  uint64_t position;
+  uint32_t size;
+  // Returns false with nothing sent when the renderer is behind, throws if
+  // |value| can't be serialized.
+  if (!rings.send_ring->Write(args->isolate(), value, &sequence, &position,
+                              &size))
+    return false;
+
+  return rfh->Send(new AtomViewMsg_Message_Ring(
+      rfh->GetRoutingID(), rings.send_ring_id, channel, sequence, position,
+      size));
+}
+
 bool WebContents::SendIPCMessageInternal(const base::string16& channel,
                                          const base::ListValue& args) {
   auto rfh = web_contents()->GetMainFrame();
@@ -2359,6 +2482,18 @@ bool WebContents::SendIPCMessage(int render_process_id,
   return rfh->Send(new AtomViewMsg_Message(rfh->GetRoutingID(), channel, args));
 }
 
+void WebContents::ConnectMessagePort(int port_id) {
+  auto rfh = web_contents() ? web_contents()->GetMainFrame() : nullptr;
+  if (!rfh || !rfh->GetProcess() || !rfh->IsRenderFrameLive()) {
+    brave::MessagePortRegistry::GetInstance()->Close(
+        port_id, brave::MessagePortRegistry::kBrowserProcessId);
+    return;
+  }
+  content::BrowserThread::PostTask(content::BrowserThread::IO, FROM_HERE,
+      base::Bind(&brave::MessagePortMessageFilter::ConnectPort,
+                 rfh->GetProcess()->GetID(), rfh->GetRoutingID(), port_id));
+}
+
 void WebContents::SendInputEvent(v8::Isolate* isolate,
                                  v8::Local<v8::Value> input_event) {
   const auto view = web_contents()->GetRenderWidgetHostView();
@@ -2656,6 +2791,9 @@ void WebContents::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("_reload", &WebContents::Reload)
       .SetMethod("_send", &WebContents::SendIPCMessageInternal)
       .SetMethod("_sendShared", &WebContents::SendIPCSharedMemoryInternal)
+      .SetMethod("_sendRing", &WebContents::SendIPCRingInternal)
+      .SetMethod("_sendCloned", &WebContents::SendIPCClonedInternal)
+      .SetMethod("connectMessagePort", &WebContents::ConnectMessagePort)
       .SetMethod("downloadURL", &WebContents::DownloadURL)
       .SetMethod("getURL", &WebContents::GetURL)
       .SetMethod("getTitle", &WebContents::GetTitle)
@@ -2801,6 +2939,17 @@ void WebContents::OnRendererMessageSync(content::RenderFrameHost* sender,
   EmitWithSender(base::UTF16ToUTF8(channel), sender, message, args);
 }
 
+void WebContents::OnRendererMessageCloned(content::RenderFrameHost* sender,
+                                          const base::string16& channel,
+                                          const std::vector<uint8_t>& data) {
+  v8::HandleScope handle_scope(isolate());
+  v8::Local<v8::Value> args;
+  if (!brave::DeserializeValue(isolate(), data).ToLocal(&args) ||
+      !args->IsArray())
+    return;
+  EmitWithSender(base::UTF16ToUTF8(channel), sender, nullptr, args);
+}
+
 void WebContents::OnRendererMessageShared(
     content::RenderFrameHost* sender,
     const base::string16& channel,
@@ -2814,6 +2963,85 @@ void WebContents::OnRendererMessageShared(
   Emit("ipc-message", args);
 }
 
+void WebContents::OnRendererSetupRing(content::RenderFrameHost* sender,
+                                      int ring_id,
+                                      const base::SharedMemoryHandle& handle,
+                                      uint32_t capacity) {
+  auto& receive_rings =
+      g_frame_rings.Get()[std::make_pair(sender->GetProcess()->GetID(),
+                                         sender->GetRoutingID())]
+          .receive_rings;
+  // Messages to a rejected ring are dropped like those to an unknown one.
+  if (!receive_rings.count(ring_id) &&
+      receive_rings.size() >= kMaxReceiveRingsPerFrame)
+    return;
+
+  auto ring = brave::SharedMemoryRing::Open(handle, capacity);
+  if (!ring)
+    return;
+  receive_rings[ring_id] = std::move(ring);
+}
+
+void WebContents::OnRendererSetupBrowserRing(
+    content::RenderFrameHost* sender,
+    int ring_id,
+    const base::SharedMemoryHandle& handle,
+    uint32_t capacity) {
+  auto ring = brave::SharedMemoryRing::Open(handle, capacity);
+  if (!ring)
+    return;
+  // Only one context of a frame handles messages from the browser, a newer
+  // one takes over from the last.
+  FrameRings& rings = g_frame_rings.Get()[std::make_pair(
+      sender->GetProcess()->GetID(), sender->GetRoutingID())];
+  rings.send_ring_id = ring_id;
+  rings.send_ring = std::move(ring);
+}
+
+void WebContents::OnRendererCloseRing(content::RenderFrameHost* sender,
+                                      int ring_id) {
+  auto frame = g_frame_rings.Get().find(std::make_pair(
+      sender->GetProcess()->GetID(), sender->GetRoutingID()));
+  if (frame == g_frame_rings.Get().end())
+    return;
+
+  FrameRings& rings = frame->second;
+  rings.receive_rings.erase(ring_id);
+  if (rings.send_ring && rings.send_ring_id == ring_id)
+    rings.send_ring.reset();
+  if (rings.empty())
+    g_frame_rings.Get().erase(frame);
+}
+
+void WebContents::OnRendererMessageRing(content::RenderFrameHost* sender,
+                                        int ring_id,
+                                        const base::string16& channel,
+                                        uint64_t sequence,
+                                        uint64_t position,
+                                        uint32_t size) {
+  auto frame = g_frame_rings.Get().find(std::make_pair(
+      sender->GetProcess()->GetID(), sender->GetRoutingID()));
+  if (frame == g_frame_rings.Get().end())
+    return;
+  auto ring = frame->second.receive_rings.find(ring_id);
+  if (ring == frame->second.receive_rings.end())
+    return;
+
+  v8::HandleScope handle_scope(isolate());
+  v8::Local<v8::Value> value;
+  if (!ring->second->Read(isolate(), sequence, position, size)
+           .ToLocal(&value))
+    return;
+
+  std::vector<v8::Local<v8::Value>> args = {
+    mate::StringToV8(isolate(), channel),
+    value,
+  };
+
+  // webContents.emit(channel, new Event(), args...);
+  Emit("ipc-message", args);
+}
+
 // static
 mate::Handle<WebContents> WebContents::FromTabID(v8::Isolate* isolate,
     int tab_id) {
@@ -3064,6 +3292,71 @@ namespace {
 
 using atom::api::WebContents;
 
+v8::Local<v8::Value> GetIPCSenderStats(v8::Isolate* isolate) {
+  mate::internal::SenderStats stats = mate::internal::GetSenderStats();
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("created", stats.created);
+  dict.Set("reused", stats.reused);
+  dict.Set("cached", stats.cached);
+  return dict.GetHandle();
+}
+
+resource_coordinator::GuestTabManager* GetGuestTabManager() {
+  return static_cast<resource_coordinator::GuestTabManager*>(
+      g_browser_process->GetTabManager());
+}
+
+void SetTabDiscardPolicy(mate::Arguments* args) {
+  mate::Dictionary options;
+  if (!args->GetNext(&options)) {
+    args->ThrowError("`options` is a required field");
+    return;
+  }
+
+  resource_coordinator::GuestTabManager::DiscardPolicy policy =
+      GetGuestTabManager()->discard_policy();
+  options.Get("enabled", &policy.enabled);
+  options.Get("discardOnModeratePressure",
+              &policy.discard_on_moderate_pressure);
+  double memory_budget;
+  if (options.Get("memoryBudget", &memory_budget)) {
+    if (memory_budget < 0) {
+      args->ThrowError("`memoryBudget` must not be negative");
+      return;
+    }
+    policy.memory_budget = static_cast<uint64_t>(memory_budget);
+  }
+  int check_interval;
+  if (options.Get("checkInterval", &check_interval)) {
+    if (check_interval < 0) {
+      args->ThrowError("`checkInterval` must not be negative");
+      return;
+    }
+    policy.check_interval = base::TimeDelta::FromMilliseconds(check_interval);
+  }
+  int min_inactive_time;
+  if (options.Get("minInactiveTime", &min_inactive_time)) {
+    if (min_inactive_time < 0) {
+      args->ThrowError("`minInactiveTime` must not be negative");
+      return;
+    }
+    policy.min_inactive_time =
+        base::TimeDelta::FromMilliseconds(min_inactive_time);
+  }
+  GetGuestTabManager()->SetDiscardPolicy(policy);
+}
+
+v8::Local<v8::Value> GetTabDiscardStats(v8::Isolate* isolate) {
+  const resource_coordinator::GuestTabManager::DiscardStats& stats =
+      GetGuestTabManager()->discard_stats();
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("runs", static_cast<int>(stats.runs));
+  dict.Set("tabsDiscarded", static_cast<int>(stats.tabs_discarded));
+  dict.Set("tabsVetoed", static_cast<int>(stats.tabs_vetoed));
+  dict.Set("bytesReclaimed", static_cast<double>(stats.bytes_reclaimed));
+  return dict.GetHandle();
+}
+
 void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context, void* priv) {
   v8::Isolate* isolate = context->GetIsolate();
@@ -3075,6 +3368,9 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   dict.SetMethod("fromId", &mate::TrackableObject<WebContents>::FromWeakMapID);
   dict.SetMethod("getAllWebContents",
                  &mate::TrackableObject<WebContents>::GetAll);
+  dict.SetMethod("getIPCSenderStats", &GetIPCSenderStats);
+  dict.SetMethod("setTabDiscardPolicy", &SetTabDiscardPolicy);
+  dict.SetMethod("getTabDiscardStats", &GetTabDiscardStats);
 }
 
 }  // namespace
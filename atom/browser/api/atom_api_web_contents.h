@@ -244,7 +244,8 @@ class WebContents : public mate::TrackableObject<WebContents>,
   void SetTabIndex(int index);
   void SetPinned(bool pinned);
   void SetAutoDiscardable(bool auto_discardable);
-  void Discard();
+  // Returns false if "will-discard" was prevented or discarding failed.
+  bool Discard();
 
   // Zoom
   void SetZoomLevel(double zoom);
@@ -268,6 +269,16 @@ class WebContents : public mate::TrackableObject<WebContents>,
                                   int render_frame_id,
                                   const base::string16& channel,
                                   base::SharedMemory* shared_memory);
+  // Like SendIPCMessage, with the arguments structured-cloned.
+  static bool SendIPCCloned(int render_process_id,
+                            int render_frame_id,
+                            mate::Arguments* args);
+  // Writes a value into the shared memory ring of the frame. Returns false
+  // without sending it if the frame has not read enough of the previous ones,
+  // or has no script context reading a ring.
+  static bool SendIPCRing(int render_process_id,
+                          int render_frame_id,
+                          mate::Arguments* args);
 
   // Send WebInputEvent to the page.
   void SendInputEvent(v8::Isolate* isolate, v8::Local<v8::Value> input_event);
@@ -471,6 +482,7 @@ class WebContents : public mate::TrackableObject<WebContents>,
   void BeforeUnloadFired(const base::TimeTicks& proceed_time) override;
   void RenderViewReady() override;
   void RenderViewDeleted(content::RenderViewHost*) override;
+  void RenderFrameDeleted(content::RenderFrameHost* render_frame_host) override;
   void RenderProcessGone(base::TerminationStatus status) override;
   void DocumentAvailableInMainFrame() override;
   void DocumentOnLoadCompletedInMainFrame() override;
@@ -534,6 +546,10 @@ class WebContents : public mate::TrackableObject<WebContents>,
                                    base::SharedMemory* shared_memory);
   bool SendIPCMessageInternal(const base::string16& channel,
                               const base::ListValue& args);
+  bool SendIPCRingInternal(mate::Arguments* args);
+  bool SendIPCClonedInternal(mate::Arguments* args);
+  // Hands the message port |port_id| to the main frame.
+  void ConnectMessagePort(int port_id);
   AtomBrowserContext* GetBrowserContext() const;
 
   uint32_t GetNextRequestId() {
@@ -554,10 +570,31 @@ class WebContents : public mate::TrackableObject<WebContents>,
                              const base::ListValue& args,
                              IPC::Message* message);
 
+  // Called when received a structured-cloned message from renderer.
+  void OnRendererMessageCloned(content::RenderFrameHost* sender,
+                               const base::string16& channel,
+                               const std::vector<uint8_t>& data);
+
   void OnRendererMessageShared(content::RenderFrameHost* sender,
                                const base::string16& channel,
                                const base::SharedMemoryHandle& shared_memory);
 
+  void OnRendererSetupRing(content::RenderFrameHost* sender,
+                           int ring_id,
+                           const base::SharedMemoryHandle& handle,
+                           uint32_t capacity);
+  void OnRendererSetupBrowserRing(content::RenderFrameHost* sender,
+                                  int ring_id,
+                                  const base::SharedMemoryHandle& handle,
+                                  uint32_t capacity);
+  void OnRendererCloseRing(content::RenderFrameHost* sender, int ring_id);
+  void OnRendererMessageRing(content::RenderFrameHost* sender,
+                             int ring_id,
+                             const base::string16& channel,
+                             uint64_t sequence,
+                             uint64_t position,
+                             uint32_t size);
+
   v8::Global<v8::Value> session_;
   v8::Global<v8::Value> devtools_web_contents_;
   v8::Global<v8::Value> debugger_;
@@ -4,7 +4,11 @@
 
 #include "atom/browser/api/atom_api_web_request.h"
 
+#include <string>
+#include <vector>
+
 #include "atom/browser/net/atom_network_delegate.h"
+#include "atom/browser/net/web_request_rules.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
@@ -25,6 +29,47 @@
 
 using content::BrowserThread;
 
+namespace {
+
+void SetRulesOnIOThread(
+    const scoped_refptr<net::URLRequestContextGetter>& getter,
+    const std::vector<atom::WebRequestRule>& rules) {
+  auto delegate = static_cast<atom::AtomNetworkDelegate*>(
+      getter->GetURLRequestContext()->network_delegate());
+  delegate->SetRulesInIO(rules);
+}
+
+void SetSimpleBatchListenerOnIOThread(
+    const scoped_refptr<net::URLRequestContextGetter>& getter,
+    atom::AtomNetworkDelegate::SimpleEvent type,
+    const atom::URLPatterns& patterns,
+    const atom::AtomNetworkDelegate::BatchOptions& options,
+    const atom::AtomNetworkDelegate::SimpleBatchListener& listener) {
+  auto delegate = static_cast<atom::AtomNetworkDelegate*>(
+      getter->GetURLRequestContext()->network_delegate());
+  delegate->SetSimpleBatchListenerInIO(type, patterns, options, listener);
+}
+
+std::unique_ptr<base::DictionaryValue> GetBatchStatsOnIOThread(
+    const scoped_refptr<net::URLRequestContextGetter>& getter) {
+  auto delegate = static_cast<atom::AtomNetworkDelegate*>(
+      getter->GetURLRequestContext()->network_delegate());
+  atom::AtomNetworkDelegate::BatchStats stats = delegate->GetBatchStatsInIO();
+  std::unique_ptr<base::DictionaryValue> result(new base::DictionaryValue);
+  result->SetDouble("batched", stats.batched);
+  result->SetDouble("delivered", stats.delivered);
+  result->SetDouble("dropped", stats.dropped);
+  return result;
+}
+
+void OnGetBatchStats(
+    const base::Callback<void(const base::DictionaryValue&)>& callback,
+    std::unique_ptr<base::DictionaryValue> stats) {
+  callback.Run(*stats);
+}
+
+}  // namespace
+
 namespace mate {
 
 template<>
@@ -38,6 +83,91 @@ struct Converter<URLPattern> {
   }
 };
 
+template<>
+struct Converter<atom::WebRequestRule> {
+  static bool FromV8(v8::Isolate* isolate, v8::Local<v8::Value> val,
+                     atom::WebRequestRule* out) {
+    mate::Dictionary dict;
+    std::string action;
+    if (!ConvertFromV8(isolate, val, &dict) || !dict.Get("action", &action))
+      return false;
+
+    if (action == "block") {
+      out->action = atom::WebRequestRule::kBlock;
+    } else if (action == "redirect") {
+      out->action = atom::WebRequestRule::kRedirect;
+      if (!dict.Get("redirectURL", &out->redirect_url) ||
+          !out->redirect_url.is_valid())
+        return false;
+    } else if (action == "upgradeScheme") {
+      out->action = atom::WebRequestRule::kUpgradeScheme;
+    } else if (action == "modifyHeaders") {
+      out->action = atom::WebRequestRule::kModifyHeaders;
+      // { name: value } sets a header, { name: null } removes it.
+      base::DictionaryValue headers;
+      if (!dict.Get("requestHeaders", &headers))
+        return false;
+      for (base::DictionaryValue::Iterator it(headers); !it.IsAtEnd();
+           it.Advance()) {
+        std::string value;
+        if (it.value().GetAsString(&value))
+          out->set_request_headers[it.key()] = value;
+        else if (it.value().is_none())
+          out->remove_request_headers.push_back(it.key());
+      }
+    } else {
+      return false;
+    }
+
+    // A rule without patterns matches every URL, so patterns that are given
+    // but can't be parsed must fail the rule rather than be ignored.
+    atom::URLPatterns patterns;
+    if (!GetOptionalPatterns(isolate, dict, "urls", &patterns))
+      return false;
+    out->url_patterns = atom::URLPatternMatcher(patterns);
+    atom::URLPatterns first_party_patterns;
+    if (!GetOptionalPatterns(isolate, dict, "firstPartyUrls",
+                             &first_party_patterns))
+      return false;
+    out->first_party_patterns = atom::URLPatternMatcher(first_party_patterns);
+    std::vector<std::string> resource_types;
+    if (dict.Get("resourceTypes", &resource_types))
+      out->resource_types.insert(resource_types.begin(), resource_types.end());
+    return true;
+  }
+
+ private:
+  // Leaves |out| empty if |key| is not set, fails if it is not valid.
+  static bool GetOptionalPatterns(v8::Isolate* isolate,
+                                  const mate::Dictionary& dict,
+                                  const char* key,
+                                  atom::URLPatterns* out) {
+    v8::Local<v8::Value> value;
+    if (!dict.Get(key, &value) || value->IsUndefined())
+      return true;
+    return ConvertFromV8(isolate, value, out);
+  }
+};
+
+template<>
+struct Converter<atom::AtomNetworkDelegate::BatchOptions> {
+  static bool FromV8(v8::Isolate* isolate, v8::Local<v8::Value> val,
+                     atom::AtomNetworkDelegate::BatchOptions* out) {
+    mate::Dictionary dict;
+    if (!ConvertFromV8(isolate, val, &dict))
+      return false;
+    int interval = 100;
+    int size = 100;
+    dict.Get("interval", &interval);
+    dict.Get("size", &size);
+    if (interval < 0 || size <= 0)
+      return false;
+    out->interval = base::TimeDelta::FromMilliseconds(interval);
+    out->max_size = size;
+    return true;
+  }
+};
+
 template<>
 struct Converter<net::URLFetcher::RequestType> {
   static bool FromV8(v8::Isolate* isolate, v8::Handle<v8::Value> val,
@@ -150,14 +280,54 @@ void WebRequest::Fetch(mate::Arguments* args) {
 
 template<AtomNetworkDelegate::SimpleEvent type>
 void WebRequest::SetSimpleListener(mate::Arguments* args) {
-  SetListener<AtomNetworkDelegate::SimpleListener>(
-      &AtomNetworkDelegate::SetSimpleListenerInIO, type, args);
+  // { urls, batch }.
+  URLPatterns patterns;
+  AtomNetworkDelegate::BatchOptions batch_options;
+  mate::Dictionary dict;
+  bool batched = false;
+  if (args->GetNext(&dict)) {
+    dict.Get("urls", &patterns);
+    v8::Local<v8::Value> batch;
+    if (dict.Get("batch", &batch) && !batch->IsUndefined()) {
+      if (!mate::ConvertFromV8(args->isolate(), batch, &batch_options)) {
+        args->ThrowError("Invalid batch options");
+        return;
+      }
+      batched = true;
+    }
+  }
+
+  if (!batched) {
+    SetListener<AtomNetworkDelegate::SimpleListener>(
+        &AtomNetworkDelegate::SetSimpleListenerInIO, type, patterns, args);
+    return;
+  }
+
+  // Function or null.
+  v8::Local<v8::Value> value;
+  AtomNetworkDelegate::SimpleBatchListener listener;
+  if (!args->GetNext(&listener) &&
+      !(args->GetNext(&value) && value->IsNull())) {
+    args->ThrowError("Must pass null or a Function");
+    return;
+  }
+
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&SetSimpleBatchListenerOnIOThread,
+                 scoped_refptr<net::URLRequestContextGetter>(
+                     profile_->GetRequestContext()),
+                 type, patterns, batch_options, listener));
 }
 
 template<AtomNetworkDelegate::ResponseEvent type>
 void WebRequest::SetResponseListener(mate::Arguments* args) {
+  // { urls }.
+  URLPatterns patterns;
+  mate::Dictionary dict;
+  args->GetNext(&dict) && dict.Get("urls", &patterns);
+
   SetListener<AtomNetworkDelegate::ResponseListener>(
-      &AtomNetworkDelegate::SetResponseListenerInIO, type, args);
+      &AtomNetworkDelegate::SetResponseListenerInIO, type, patterns, args);
 }
 
 template<typename Listener, typename Method, typename Event>
@@ -172,12 +342,9 @@ void WebRequest::SetListenerOnIOThread(
 }
 
 template<typename Listener, typename Method, typename Event>
-void WebRequest::SetListener(Method method, Event type, mate::Arguments* args) {
-  // { urls }.
-  URLPatterns patterns;
-  mate::Dictionary dict;
-  args->GetNext(&dict) && dict.Get("urls", &patterns);
-
+void WebRequest::SetListener(Method method, Event type,
+                             const URLPatterns& patterns,
+                             mate::Arguments* args) {
   // Function or null.
   v8::Local<v8::Value> value;
   Listener listener;
@@ -195,6 +362,34 @@ void WebRequest::SetListener(Method method, Event type, mate::Arguments* args) {
           method, type, patterns, listener));
 }
 
+void WebRequest::SetRules(mate::Arguments* args) {
+  std::vector<WebRequestRule> rules;
+  if (!args->GetNext(&rules)) {
+    args->ThrowError("Must pass an array of rules");
+    return;
+  }
+
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&SetRulesOnIOThread,
+                 scoped_refptr<net::URLRequestContextGetter>(
+                     profile_->GetRequestContext()),
+                 rules));
+}
+
+void WebRequest::GetBatchStats(mate::Arguments* args) {
+  base::Callback<void(const base::DictionaryValue&)> callback;
+  if (!args->GetNext(&callback)) {
+    args->ThrowError("Must pass a Function");
+    return;
+  }
+
+  BrowserThread::PostTaskAndReplyWithResult(BrowserThread::IO, FROM_HERE,
+      base::Bind(&GetBatchStatsOnIOThread,
+                 scoped_refptr<net::URLRequestContextGetter>(
+                     profile_->GetRequestContext())),
+      base::Bind(&OnGetBatchStats, callback));
+}
+
 void WebRequest::HandleBehaviorChanged() {
 #if BUILDFLAG(ENABLE_EXTENSIONS)
   extension_web_request_api_helpers::ClearCacheOnNavigation();
@@ -239,6 +434,10 @@ void WebRequest::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("onErrorOccurred",
                  &WebRequest::SetSimpleListener<
                     AtomNetworkDelegate::kOnErrorOccurred>)
+      .SetMethod("setRules",
+                 &WebRequest::SetRules)
+      .SetMethod("getBatchStats",
+                 &WebRequest::GetBatchStats)
       .SetMethod("handleBehaviorChanged",
                  &WebRequest::HandleBehaviorChanged)
       .SetMethod("fetch",
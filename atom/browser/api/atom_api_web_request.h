@@ -51,6 +51,8 @@ class WebRequest : public mate::TrackableObject<WebRequest>,
       const mate::Dictionary&,
       v8::Local<v8::String>)> FetchCallback;
   void HandleBehaviorChanged();
+  void SetRules(mate::Arguments* args);
+  void GetBatchStats(mate::Arguments* args);
   void Fetch(mate::Arguments* args);
   void OnURLFetchComplete(const net::URLFetcher* source) override;
 
@@ -65,7 +67,9 @@ class WebRequest : public mate::TrackableObject<WebRequest>,
       Method method, Event type,
       URLPatterns patterns, Listener listener);
   template<typename Listener, typename Method, typename Event>
-  void SetListener(Method method, Event type, mate::Arguments* args);
+  void SetListener(Method method, Event type,
+                   const URLPatterns& patterns,
+                   mate::Arguments* args);
 
  private:
   Profile* profile_;
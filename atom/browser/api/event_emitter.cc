@@ -4,10 +4,14 @@
 
 #include "atom/browser/api/event_emitter.h"
 
+#include <map>
+#include <utility>
+
 #include "atom/browser/api/atom_api_web_contents.h"
 #include "atom/browser/api/event.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "base/lazy_instance.h"
 #include "brave/common/extensions/shared_memory_bindings.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/render_process_host.h"
@@ -26,6 +30,14 @@ namespace {
 
 v8::Persistent<v8::ObjectTemplate> event_template;
 
+// The senders of async renderer messages, by render process and frame id.
+// Kept until the frame is deleted so a busy frame doesn't get a new wrapper
+// and new bound methods for every message.
+using SenderMap = std::map<std::pair<int, int>, v8::Global<v8::Object>>;
+base::LazyInstance<SenderMap>::Leaky g_senders = LAZY_INSTANCE_INITIALIZER;
+
+internal::SenderStats g_sender_stats;
+
 void PreventDefault(mate::Arguments* args) {
   mate::Dictionary self(args->isolate(), args->GetThis());
   self.Set("defaultPrevented", true);
@@ -43,6 +55,48 @@ v8::Local<v8::Object> CreateEventObject(v8::Isolate* isolate) {
       isolate, event_template)->NewInstance();
 }
 
+// Returns the sender object of |render_frame_host|, a REMOTE WebContents
+// wrapper with its own send methods bound to the frame.
+v8::Local<v8::Object> GetSender(v8::Isolate* isolate,
+                                content::RenderFrameHost* render_frame_host) {
+  int render_process_id = render_frame_host->GetProcess()->GetID();
+  int render_frame_id = render_frame_host->GetRoutingID();
+  auto key = std::make_pair(render_process_id, render_frame_id);
+
+  auto it = g_senders.Get().find(key);
+  if (it != g_senders.Get().end()) {
+    ++g_sender_stats.reused;
+    return v8::Local<v8::Object>::New(isolate, it->second);
+  }
+
+  v8::EscapableHandleScope handle_scope(isolate);
+  auto web_contents =
+      content::WebContents::FromRenderFrameHost(render_frame_host);
+  // create a new wrapper so we can rebind send and sendShared
+  // without affecting other references
+  mate::Handle<WebContents> handle = WebContents::CreateFrom(
+      isolate, web_contents, WebContents::Type::REMOTE);
+
+  mate::Dictionary sender(isolate, handle->GetWrapper());
+  sender.SetMethod("_send",
+      base::Bind(&atom::api::WebContents::SendIPCMessage,
+          render_process_id, render_frame_id));
+  sender.SetMethod("_sendShared",
+      base::Bind(&atom::api::WebContents::SendIPCSharedMemory,
+          render_process_id, render_frame_id));
+  sender.SetMethod("_sendCloned",
+      base::Bind(&atom::api::WebContents::SendIPCCloned,
+          render_process_id, render_frame_id));
+  sender.SetMethod("_sendRing",
+      base::Bind(&atom::api::WebContents::SendIPCRing,
+          render_process_id, render_frame_id));
+
+  v8::Local<v8::Object> object = handle.ToV8().As<v8::Object>();
+  g_senders.Get()[key].Reset(isolate, object);
+  ++g_sender_stats.created;
+  return handle_scope.Escape(object);
+}
+
 }  // namespace
 
 namespace internal {
@@ -61,28 +115,8 @@ v8::Local<v8::Object> CreateJSEvent(
   } else {
     event = CreateEventObject(isolate);
 
-    if (render_frame_host) {
-      v8::EscapableHandleScope handle_scope(isolate);
-      auto web_contents =
-          content::WebContents::FromRenderFrameHost(render_frame_host);
-      // create a new wrapper so we can rebind send and sendShared
-      // without affecting other references
-      mate::Handle<WebContents> handle = WebContents::CreateFrom(
-          isolate, web_contents, WebContents::Type::REMOTE);
-
-      int render_process_id = render_frame_host->GetProcess()->GetID();
-      int render_frame_id = render_frame_host->GetRoutingID();
-
-      mate::Dictionary sender(isolate, handle->GetWrapper());
-      sender.SetMethod("_send",
-          base::Bind(&atom::api::WebContents::SendIPCMessage,
-              render_process_id, render_frame_id));
-      sender.SetMethod("_sendShared",
-          base::Bind(&atom::api::WebContents::SendIPCSharedMemory,
-              render_process_id, render_frame_id));
-
-      object = handle_scope.Escape(handle.ToV8());
-    }
+    if (render_frame_host)
+      object = GetSender(isolate, render_frame_host);
   }
   mate::Dictionary(isolate, event).Set("sender", object);
   return event;
@@ -98,6 +132,18 @@ v8::Local<v8::Object> CreateCustomEvent(
   return event;
 }
 
+void ForgetSender(content::RenderFrameHost* render_frame_host) {
+  g_senders.Get().erase(std::make_pair(
+      render_frame_host->GetProcess()->GetID(),
+      render_frame_host->GetRoutingID()));
+}
+
+SenderStats GetSenderStats() {
+  SenderStats stats = g_sender_stats;
+  stats.cached = g_senders.Get().size();
+  return stats;
+}
+
 v8::Local<v8::Object> CreateEventFromFlags(v8::Isolate* isolate, int flags) {
   mate::Dictionary obj = mate::Dictionary::CreateEmpty(isolate);
   obj.Set("shiftKey", static_cast<bool>(flags & ui::EF_SHIFT_DOWN));
@@ -5,6 +5,8 @@
 #ifndef ATOM_BROWSER_API_EVENT_EMITTER_H_
 #define ATOM_BROWSER_API_EVENT_EMITTER_H_
 
+#include <stdint.h>
+
 #include <vector>
 
 #include "atom/common/api/event_emitter_caller.h"
@@ -32,6 +34,17 @@ v8::Local<v8::Object> CreateCustomEvent(
     v8::Local<v8::Object> event);
 v8::Local<v8::Object> CreateEventFromFlags(v8::Isolate* isolate, int flags);
 
+// Drops the sender object cached for |render_frame_host|, which is going away.
+void ForgetSender(content::RenderFrameHost* render_frame_host);
+
+// How many sender objects async renderer messages needed.
+struct SenderStats {
+  uint64_t created = 0;  // Wrappers made on a cache miss.
+  uint64_t reused = 0;  // Messages that found their sender cached.
+  uint64_t cached = 0;  // Senders currently in the cache.
+};
+SenderStats GetSenderStats();
+
 }  // namespace internal
 
 // Provide helperers to emit event in JavaScript.
@@ -7,6 +7,7 @@
 #include <map>
 #include <set>
 
+#include "atom/browser/extensions/content_settings_updater.h"
 #include "atom/common/api/api_messages.h"
 #include "base/command_line.h"
 #include "brave/browser/api/brave_api_extension.h"
@@ -379,6 +380,7 @@ void AtomBrowserClientExtensionsPart::RenderProcessWillLaunch(
   host->AddFilter(new ExtensionMessageFilter(id, context));
   host->AddFilter(new IOThreadExtensionMessageFilter(id, context));
   host->AddFilter(new ExtensionsGuestViewMessageFilter(id, context));
+  host->AddFilter(new atom::ContentSettingsMessageFilter(id));
   if (extensions::ExtensionsClient::Get()
           ->ExtensionAPIEnabledInExtensionServiceWorkers()) {
     host->AddFilter(new ExtensionServiceWorkerMessageFilter(
@@ -392,7 +394,10 @@ void AtomBrowserClientExtensionsPart::RenderProcessWillLaunch(
         base::Bind(&AtomBrowserClientExtensionsPart::UpdateContentSettings,
                    base::Unretained(this)));
   }
-  UpdateContentSettingsForHost(host->GetID());
+  // The new process starts from scratch.
+  atom::ContentSettingsUpdater::RefreshBrowserContext(
+      host->GetBrowserContext());
+  atom::ContentSettingsUpdater::UpdateHost(host, true);
 }
 
 // static
@@ -447,26 +452,22 @@ GURL AtomBrowserClientExtensionsPart::GetEffectiveURL(
   return extension->GetResourceURL(url.path());
 }
 
-void AtomBrowserClientExtensionsPart::UpdateContentSettingsForHost(
-  int render_process_id) {
-  auto host = content::RenderProcessHost::FromID(render_process_id);
-  if (!host)
-    return;
-
-  auto context =
-      static_cast<atom::AtomBrowserContext*>(host->GetBrowserContext());
-  auto user_prefs = user_prefs::UserPrefs::Get(context);
-  const base::DictionaryValue* content_settings =
-    user_prefs->GetDictionary("content_settings");
-  host->Send(new AtomMsg_UpdateContentSettings(*content_settings));
-}
-
 void AtomBrowserClientExtensionsPart::UpdateContentSettings() {
+  // Diff the rules once per browser context, then only send to each host.
+  std::set<content::BrowserContext*> refreshed;
   for (std::map<int, void*>::iterator
       it = render_process_hosts_.begin();
       it != render_process_hosts_.end();
       ++it) {
-    UpdateContentSettingsForHost(it->first);
+    auto host = content::RenderProcessHost::FromID(it->first);
+    if (!host)
+      continue;
+
+    if (refreshed.insert(host->GetBrowserContext()).second) {
+      atom::ContentSettingsUpdater::RefreshBrowserContext(
+          host->GetBrowserContext());
+    }
+    atom::ContentSettingsUpdater::UpdateHost(host, false);
   }
 }
 
@@ -95,7 +95,6 @@ class AtomBrowserClientExtensionsPart {
 
  private:
   void UpdateContentSettings();
-  void UpdateContentSettingsForHost(int render_process_id);
 
 
   DISALLOW_COPY_AND_ASSIGN(AtomBrowserClientExtensionsPart);
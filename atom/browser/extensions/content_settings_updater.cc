@@ -0,0 +1,227 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/extensions/content_settings_updater.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "atom/common/api/api_messages.h"
+#include "base/memory/ptr_util.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/values.h"
+#include "components/prefs/pref_service.h"
+#include "components/user_prefs/user_prefs.h"
+#include "content/public/browser/browser_context.h"
+#include "content/public/browser/render_process_host.h"
+
+namespace atom {
+
+namespace {
+
+const char kContentSettingsUpdaterKey[] = "ContentSettingsUpdater";
+
+std::unique_ptr<base::DictionaryValue> CreateOperation(
+    const char* op,
+    const std::string& content_type,
+    size_t index) {
+  std::unique_ptr<base::DictionaryValue> operation(new base::DictionaryValue);
+  operation->SetString("op", op);
+  operation->SetString("contentType", content_type);
+  operation->SetInteger("index", index);
+  return operation;
+}
+
+// Appends to |ops| the operations turning |old_rules| into |new_rules|.
+// Settings changes usually touch a handful of neighbouring rules, so only
+// the range between the common prefix and suffix is rewritten.
+void DiffRules(const std::string& content_type,
+               const base::Value::ListStorage& old_rules,
+               const base::Value::ListStorage& new_rules,
+               base::ListValue* ops) {
+  size_t prefix = 0;
+  size_t max_prefix = std::min(old_rules.size(), new_rules.size());
+  while (prefix < max_prefix && old_rules[prefix] == new_rules[prefix])
+    ++prefix;
+
+  size_t suffix = 0;
+  while (suffix < max_prefix - prefix &&
+         old_rules[old_rules.size() - suffix - 1] ==
+             new_rules[new_rules.size() - suffix - 1])
+    ++suffix;
+
+  size_t old_count = old_rules.size() - prefix - suffix;
+  size_t new_count = new_rules.size() - prefix - suffix;
+  size_t replaced = std::min(old_count, new_count);
+  for (size_t i = prefix; i < prefix + replaced; ++i) {
+    auto op = CreateOperation("replace", content_type, i);
+    op->SetKey("rule", new_rules[i].Clone());
+    ops->Append(std::move(op));
+  }
+  for (size_t i = prefix + replaced; i < prefix + new_count; ++i) {
+    auto op = CreateOperation("add", content_type, i);
+    op->SetKey("rule", new_rules[i].Clone());
+    ops->Append(std::move(op));
+  }
+  // Removing at the same index repeatedly shifts the rest of the range in.
+  for (size_t i = replaced; i < old_count; ++i)
+    ops->Append(CreateOperation("remove", content_type, prefix + replaced));
+}
+
+// Returns the operations turning |old_settings| into |new_settings|, or null
+// if the full dictionary should be sent instead.
+std::unique_ptr<base::ListValue> DiffSettings(
+    const base::DictionaryValue& old_settings,
+    const base::DictionaryValue& new_settings) {
+  const base::Value::ListStorage empty;
+  std::unique_ptr<base::ListValue> ops(new base::ListValue);
+  size_t rule_count = 0;
+
+  for (base::DictionaryValue::Iterator it(new_settings); !it.IsAtEnd();
+       it.Advance()) {
+    if (!it.value().is_list())
+      return nullptr;
+    rule_count += it.value().GetList().size();
+
+    const base::Value* old_rules = old_settings.FindKey(it.key());
+    if (old_rules && !old_rules->is_list())
+      return nullptr;
+    DiffRules(it.key(), old_rules ? old_rules->GetList() : empty,
+              it.value().GetList(), ops.get());
+  }
+
+  for (base::DictionaryValue::Iterator it(old_settings); !it.IsAtEnd();
+       it.Advance()) {
+    if (new_settings.HasKey(it.key()))
+      continue;
+    if (!it.value().is_list())
+      return nullptr;
+    DiffRules(it.key(), it.value().GetList(), empty, ops.get());
+  }
+
+  // Past this point the full dictionary is about as cheap.
+  if (ops->GetSize() > rule_count / 2)
+    return nullptr;
+  return ops;
+}
+
+}  // namespace
+
+ContentSettingsUpdater::ContentSettingsUpdater() : version_(0) {
+}
+
+ContentSettingsUpdater::~ContentSettingsUpdater() {
+  for (const auto& process_version : process_versions_) {
+    auto host = content::RenderProcessHost::FromID(process_version.first);
+    if (host)
+      host->RemoveObserver(this);
+  }
+}
+
+// static
+ContentSettingsUpdater* ContentSettingsUpdater::FromBrowserContext(
+    content::BrowserContext* context) {
+  auto updater = static_cast<ContentSettingsUpdater*>(
+      context->GetUserData(kContentSettingsUpdaterKey));
+  if (!updater) {
+    updater = new ContentSettingsUpdater;
+    context->SetUserData(kContentSettingsUpdaterKey, base::WrapUnique(updater));
+  }
+  return updater;
+}
+
+// static
+void ContentSettingsUpdater::RefreshBrowserContext(
+    content::BrowserContext* context) {
+  auto user_prefs = user_prefs::UserPrefs::Get(context);
+  FromBrowserContext(context)->Refresh(
+      *user_prefs->GetDictionary("content_settings"));
+}
+
+// static
+void ContentSettingsUpdater::UpdateHost(content::RenderProcessHost* host,
+                                        bool force_full) {
+  auto updater = FromBrowserContext(host->GetBrowserContext());
+  if (!updater->settings_)
+    RefreshBrowserContext(host->GetBrowserContext());
+
+  auto inserted = updater->process_versions_.emplace(host->GetID(), 0);
+  if (inserted.second)
+    host->AddObserver(updater);
+  uint64_t& process_version = inserted.first->second;
+  if (!force_full && process_version == updater->version_)
+    return;
+
+  std::unique_ptr<IPC::Message> message;
+  if (!force_full && updater->delta_ &&
+      process_version + 1 == updater->version_) {
+    message.reset(new AtomMsg_UpdateContentSettingsDelta(
+        process_version, updater->version_, *updater->delta_));
+    UMA_HISTOGRAM_COUNTS_1M("Brave.ContentSettings.DeltaUpdateBytes",
+                            message->size());
+  } else {
+    message.reset(new AtomMsg_UpdateContentSettings(
+        *updater->settings_, updater->version_));
+    UMA_HISTOGRAM_COUNTS_1M("Brave.ContentSettings.FullUpdateBytes",
+                            message->size());
+  }
+
+  process_version = updater->version_;
+  host->Send(message.release());
+}
+
+void ContentSettingsUpdater::Refresh(const base::DictionaryValue& settings) {
+  if (settings_ && settings_->Equals(&settings))
+    return;
+
+  if (settings_)
+    delta_ = DiffSettings(*settings_, settings);
+  settings_ = settings.CreateDeepCopy();
+  ++version_;
+}
+
+void ContentSettingsUpdater::RenderProcessHostDestroyed(
+    content::RenderProcessHost* host) {
+  host->RemoveObserver(this);
+  process_versions_.erase(host->GetID());
+}
+
+ContentSettingsMessageFilter::ContentSettingsMessageFilter(
+    int render_process_id)
+    : BrowserMessageFilter(ShellMsgStart),
+      render_process_id_(render_process_id) {
+}
+
+ContentSettingsMessageFilter::~ContentSettingsMessageFilter() {
+}
+
+void ContentSettingsMessageFilter::OverrideThreadForMessage(
+    const IPC::Message& message,
+    content::BrowserThread::ID* thread) {
+  if (message.type() == AtomHostMsg_RequestContentSettings::ID)
+    *thread = content::BrowserThread::UI;
+}
+
+bool ContentSettingsMessageFilter::OnMessageReceived(
+    const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(ContentSettingsMessageFilter, message)
+    IPC_MESSAGE_HANDLER(AtomHostMsg_RequestContentSettings,
+                        OnRequestContentSettings)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  return handled;
+}
+
+void ContentSettingsMessageFilter::OnRequestContentSettings() {
+  auto host = content::RenderProcessHost::FromID(render_process_id_);
+  if (!host)
+    return;
+
+  RefreshBrowserContext(host->GetBrowserContext());
+  UpdateHost(host, true);
+}
+
+}  // namespace atom
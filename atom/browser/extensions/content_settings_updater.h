@@ -0,0 +1,99 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_EXTENSIONS_CONTENT_SETTINGS_UPDATER_H_
+#define ATOM_BROWSER_EXTENSIONS_CONTENT_SETTINGS_UPDATER_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+
+#include "base/macros.h"
+#include "base/supports_user_data.h"
+#include "content/public/browser/browser_message_filter.h"
+#include "content/public/browser/render_process_host_observer.h"
+
+namespace base {
+class DictionaryValue;
+class ListValue;
+}
+
+namespace content {
+class BrowserContext;
+class RenderProcessHost;
+}
+
+namespace atom {
+
+// Keeps the content settings of renderer processes in sync with the
+// "content_settings" pref of their browser context.
+//
+// Every change of the pref gets a new version. A renderer that has the
+// previous version is sent only the rules that changed, as a list of
+// add/remove/replace operations on one content type each; any other renderer
+// gets the full dictionary.
+class ContentSettingsUpdater : public base::SupportsUserData::Data,
+                               public content::RenderProcessHostObserver {
+ public:
+  ~ContentSettingsUpdater() override;
+
+  // Takes a new version if the content settings pref of |context| changed.
+  // Call once per pref change, before updating the hosts of |context|.
+  static void RefreshBrowserContext(content::BrowserContext* context);
+
+  // Brings |host| up to date with the last refreshed content settings of its
+  // browser context. With |force_full| the full dictionary is always sent,
+  // e.g. when the renderer process has just been launched.
+  static void UpdateHost(content::RenderProcessHost* host, bool force_full);
+
+ private:
+  ContentSettingsUpdater();
+
+  static ContentSettingsUpdater* FromBrowserContext(
+      content::BrowserContext* context);
+
+  // Takes a new version if |settings| differ from the last ones.
+  void Refresh(const base::DictionaryValue& settings);
+
+  // content::RenderProcessHostObserver:
+  void RenderProcessHostDestroyed(content::RenderProcessHost* host) override;
+
+  // The settings of |version_|.
+  std::unique_ptr<base::DictionaryValue> settings_;
+  uint64_t version_;
+
+  // Turns the settings of |version_| - 1 into the ones of |version_|, null
+  // when the change is better sent in full.
+  std::unique_ptr<base::ListValue> delta_;
+
+  // The version last sent to each render process, until it is destroyed.
+  std::map<int, uint64_t> process_versions_;
+
+  DISALLOW_COPY_AND_ASSIGN(ContentSettingsUpdater);
+};
+
+// Handles requests of renderers whose content settings went out of sync.
+class ContentSettingsMessageFilter : public content::BrowserMessageFilter {
+ public:
+  explicit ContentSettingsMessageFilter(int render_process_id);
+
+  // content::BrowserMessageFilter:
+  void OverrideThreadForMessage(const IPC::Message& message,
+                                content::BrowserThread::ID* thread) override;
+  bool OnMessageReceived(const IPC::Message& message) override;
+
+ private:
+  ~ContentSettingsMessageFilter() override;
+
+  void OnRequestContentSettings();
+
+  const int render_process_id_;
+
+  DISALLOW_COPY_AND_ASSIGN(ContentSettingsMessageFilter);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_EXTENSIONS_CONTENT_SETTINGS_UPDATER_H_
@@ -4,10 +4,10 @@
 
 #include "atom/browser/extensions/tab_helper.h"
 
-#include <map>
 #include <utility>
 #include "atom/browser/extensions/api/atom_extensions_api_client.h"
 #include "atom/browser/extensions/atom_extension_web_contents_observer.h"
+#include "atom/browser/extensions/tab_index.h"
 #include "atom/browser/native_window.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
@@ -33,7 +33,6 @@
 #include "content/public/browser/notification_source.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/render_process_host.h"
-#include "content/public/browser/render_view_host.h"
 #include "content/public/browser/web_contents.h"
 #include "extensions/browser/component_extension_resource_manager.h"
 #include "extensions/browser/extension_api_frame_id_map.h"
@@ -69,8 +68,6 @@ const char kPinnedKey[] = "pinned";
 const char kSelectedKey[] = "selected";
 }  // namespace keys
 
-static std::map<int32_t, std::pair<int, int>> render_view_map_;
-
 namespace extensions {
 
 namespace {
@@ -98,7 +95,7 @@ TabHelper::TabHelper(content::WebContents* contents)
   SessionTabHelper::CreateForWebContents(contents);
   SetWindowId(-1);
 
-  RenderViewCreated(contents->GetRenderViewHost());
+  TabIndex::GetInstance()->AddTab(session_id(), contents);
   contents->ForEachFrame(
       base::Bind(&TabHelper::SetTabId, base::Unretained(this)));
 
@@ -588,27 +585,6 @@ void TabHelper::SetOpener(int opener_tab_id) {
   opener_tab_id_ = opener_tab_id;
 }
 
-void TabHelper::RenderViewCreated(content::RenderViewHost* render_view_host) {
-  if (!render_view_host)
-    return;
-
-  // only allow one call to create
-  auto search = render_view_map_.find(session_id());
-  if (search != render_view_map_.end())
-    return;
-
-  render_view_map_[session_id()] = std::make_pair(
-      render_view_host->GetProcess()->GetID(),
-      render_view_host->GetRoutingID());
-}
-
-void TabHelper::RenderViewHostChanged(content::RenderViewHost* old_host,
-                             content::RenderViewHost* new_host) {
-  render_view_map_[session_id()] = std::make_pair(
-      new_host->GetProcess()->GetID(),
-      new_host->GetRoutingID());
-}
-
 void TabHelper::RenderFrameCreated(content::RenderFrameHost* host) {
   SetTabId(host);
   // Look up the extension API frame ID to force the mapping to be cached.
@@ -617,14 +593,23 @@ void TabHelper::RenderFrameCreated(content::RenderFrameHost* host) {
   ExtensionApiFrameIdMap::Get()->InitializeRenderFrameData(host);
 }
 
+void TabHelper::RenderFrameDeleted(content::RenderFrameHost* host) {
+  TabIndex::GetInstance()->RemoveRenderFrame(host);
+}
+
+void TabHelper::FrameDeleted(content::RenderFrameHost* host) {
+  TabIndex::GetInstance()->RemoveFrame(host);
+}
+
 void TabHelper::WebContentsDestroyed() {
   if (browser())
     SetBrowser(nullptr);
 
-  render_view_map_.erase(session_id());
+  TabIndex::GetInstance()->RemoveTab(session_id());
 }
 
 void TabHelper::SetTabId(content::RenderFrameHost* render_frame_host) {
+  TabIndex::GetInstance()->AddFrame(session_id(), render_frame_host);
   render_frame_host->Send(
       new ExtensionMsg_SetTabId(render_frame_host->GetRoutingID(),
                                 session_id()));
@@ -795,19 +780,7 @@ int TabHelper::get_index() const {
 
 // static
 content::WebContents* TabHelper::GetTabById(int32_t tab_id) {
-  auto search = render_view_map_.find(tab_id);
-  if (search == render_view_map_.end())
-    return NULL;
-
-  content::RenderViewHost* rvh =
-      content::RenderViewHost::FromID(search->second.first,
-                                      search->second.second);
-
-  if (rvh) {
-    return content::WebContents::FromRenderViewHost(rvh);
-  } else {
-    return NULL;
-  }
+  return TabIndex::GetInstance()->GetWebContents(tab_id);
 }
 
 // static
@@ -32,7 +32,6 @@ class TabViewGuest;
 namespace content {
 class BrowserContext;
 class RenderFrameHost;
-class RenderViewHost;
 }
 
 namespace mate {
@@ -88,6 +87,7 @@ class TabHelper : public content::WebContentsObserver,
   void SetTabIndex(int index);
 
   void SetAutoDiscardable(bool auto_discardable);
+  bool auto_discardable() const { return auto_discardable_; }
 
   void SetActive(bool active);
 
@@ -188,10 +188,9 @@ class TabHelper : public content::WebContentsObserver,
       std::unique_ptr<std::string> code_string);
 
   // content::WebContentsObserver overrides.
-  void RenderViewCreated(content::RenderViewHost* render_view_host) override;
-  void RenderViewHostChanged(content::RenderViewHost* old_host,
-                             content::RenderViewHost* new_host) override;
   void RenderFrameCreated(content::RenderFrameHost* host) override;
+  void RenderFrameDeleted(content::RenderFrameHost* host) override;
+  void FrameDeleted(content::RenderFrameHost* host) override;
   void WebContentsDestroyed() override;
   void DidCloneToNewWebContents(
       content::WebContents* old_web_contents,
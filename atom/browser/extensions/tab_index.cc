@@ -0,0 +1,149 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/extensions/tab_index.h"
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/render_process_host.h"
+
+using content::BrowserThread;
+
+namespace extensions {
+
+namespace {
+
+std::pair<int, int> RenderFrameKey(content::RenderFrameHost* host) {
+  return std::make_pair(host->GetProcess()->GetID(), host->GetRoutingID());
+}
+
+// Erases the entries of |map| that point to |tab_id|.
+template <typename Map>
+void EraseTab(Map* map, int32_t tab_id) {
+  for (auto it = map->begin(); it != map->end();) {
+    if (it->second == tab_id)
+      it = map->erase(it);
+    else
+      ++it;
+  }
+}
+
+}  // namespace
+
+TabIndex::FrameMaps::FrameMaps() {
+}
+
+TabIndex::FrameMaps::FrameMaps(const FrameMaps& other) = default;
+
+TabIndex::FrameMaps::~FrameMaps() {
+}
+
+int32_t TabIndex::FrameMaps::GetTabId(int frame_tree_node_id,
+                                      int render_process_id,
+                                      int render_frame_id) const {
+  auto node = by_frame_tree_node.find(frame_tree_node_id);
+  if (node != by_frame_tree_node.end())
+    return node->second;
+
+  auto frame = by_render_frame.find(
+      std::make_pair(render_process_id, render_frame_id));
+  if (frame != by_render_frame.end())
+    return frame->second;
+
+  return -1;
+}
+
+TabIndex::Snapshot::Snapshot(const FrameMaps& frames) : frames_(frames) {
+}
+
+TabIndex::Snapshot::~Snapshot() {
+}
+
+// static
+TabIndex* TabIndex::GetInstance() {
+  return base::Singleton<TabIndex>::get();
+}
+
+TabIndex::TabIndex()
+    : publish_scheduled_(false),
+      snapshot_(new Snapshot(FrameMaps())) {
+}
+
+TabIndex::~TabIndex() {
+}
+
+void TabIndex::AddTab(int32_t tab_id, content::WebContents* contents) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  web_contents_[tab_id] = contents;
+}
+
+void TabIndex::RemoveTab(int32_t tab_id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (!web_contents_.erase(tab_id))
+    return;
+
+  EraseTab(&frames_.by_frame_tree_node, tab_id);
+  EraseTab(&frames_.by_render_frame, tab_id);
+  // Right away, so the IO thread stops reporting the closed tab as soon as
+  // GetWebContents() does.
+  Publish();
+}
+
+void TabIndex::AddFrame(int32_t tab_id, content::RenderFrameHost* host) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  frames_.by_frame_tree_node[host->GetFrameTreeNodeId()] = tab_id;
+  frames_.by_render_frame[RenderFrameKey(host)] = tab_id;
+  SchedulePublish();
+}
+
+void TabIndex::RemoveRenderFrame(content::RenderFrameHost* host) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (frames_.by_render_frame.erase(RenderFrameKey(host)))
+    SchedulePublish();
+}
+
+void TabIndex::RemoveFrame(content::RenderFrameHost* host) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  size_t erased =
+      frames_.by_frame_tree_node.erase(host->GetFrameTreeNodeId()) +
+      frames_.by_render_frame.erase(RenderFrameKey(host));
+  if (erased)
+    SchedulePublish();
+}
+
+content::WebContents* TabIndex::GetWebContents(int32_t tab_id) const {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  auto it = web_contents_.find(tab_id);
+  return it == web_contents_.end() ? nullptr : it->second;
+}
+
+scoped_refptr<const TabIndex::Snapshot> TabIndex::GetSnapshot() const {
+  base::AutoLock lock(lock_);
+  return snapshot_;
+}
+
+void TabIndex::SchedulePublish() {
+  if (publish_scheduled_)
+    return;
+  publish_scheduled_ = true;
+  // The singleton is never destroyed before the UI thread.
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::BindOnce(&TabIndex::Publish, base::Unretained(this)));
+}
+
+void TabIndex::Publish() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  publish_scheduled_ = false;
+  scoped_refptr<const Snapshot> snapshot(new Snapshot(frames_));
+  {
+    base::AutoLock lock(lock_);
+    snapshot_.swap(snapshot);
+  }
+  // The previous snapshot goes away here, or with its last reader.
+}
+
+}  // namespace extensions
@@ -0,0 +1,117 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_EXTENSIONS_TAB_INDEX_H_
+#define ATOM_BROWSER_EXTENSIONS_TAB_INDEX_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/singleton.h"
+#include "base/synchronization/lock.h"
+
+namespace content {
+class RenderFrameHost;
+class WebContents;
+}
+
+namespace extensions {
+
+// The live tabs by tab id, and the tab id of every frame in them.
+//
+// TabHelper keeps the index up to date on the UI thread. Tabs are added when
+// their TabHelper is created rather than when they are inserted into a tab
+// strip, because tabs have ids, and are looked up by them, before that.
+// Other threads read an immutable snapshot of the frame maps, republished
+// once per UI task that changed them, so the IO thread can fill in the tabId
+// of webRequest events without asking the UI thread. A frame created after
+// the last snapshot is missing from it until the next one. Removing a tab
+// republishes right away.
+class TabIndex {
+ public:
+  // Tab ids by frame.
+  struct FrameMaps {
+    FrameMaps();
+    FrameMaps(const FrameMaps& other);
+    ~FrameMaps();
+
+    // Looks the frame up by frame tree node first. Returns -1 if it is in
+    // neither map.
+    int32_t GetTabId(int frame_tree_node_id,
+                     int render_process_id,
+                     int render_frame_id) const;
+
+    std::unordered_map<int, int32_t> by_frame_tree_node;
+    // By render process id and routing id.
+    std::map<std::pair<int, int>, int32_t> by_render_frame;
+  };
+
+  class Snapshot : public base::RefCountedThreadSafe<Snapshot> {
+   public:
+    explicit Snapshot(const FrameMaps& frames);
+
+    int32_t GetTabId(int frame_tree_node_id,
+                     int render_process_id,
+                     int render_frame_id) const {
+      return frames_.GetTabId(frame_tree_node_id, render_process_id,
+                              render_frame_id);
+    }
+
+   private:
+    friend class base::RefCountedThreadSafe<Snapshot>;
+
+    ~Snapshot();
+
+    const FrameMaps frames_;
+
+    DISALLOW_COPY_AND_ASSIGN(Snapshot);
+  };
+
+  static TabIndex* GetInstance();
+
+  // UI thread only.
+  void AddTab(int32_t tab_id, content::WebContents* contents);
+  // Drops the tab and all of its frames.
+  void RemoveTab(int32_t tab_id);
+  void AddFrame(int32_t tab_id, content::RenderFrameHost* host);
+  // The render frame is gone; its frame tree node may have a new one.
+  void RemoveRenderFrame(content::RenderFrameHost* host);
+  // The frame itself is gone.
+  void RemoveFrame(content::RenderFrameHost* host);
+  content::WebContents* GetWebContents(int32_t tab_id) const;
+
+  // Any thread.
+  scoped_refptr<const Snapshot> GetSnapshot() const;
+
+ private:
+  friend struct base::DefaultSingletonTraits<TabIndex>;
+
+  TabIndex();
+  ~TabIndex();
+
+  // Publishes |frames_| from a task of its own, so that a burst of changes
+  // is copied once.
+  void SchedulePublish();
+  void Publish();
+
+  std::unordered_map<int32_t, content::WebContents*> web_contents_;
+  // The frame maps as of now, copied into each snapshot.
+  FrameMaps frames_;
+  bool publish_scheduled_;
+
+  mutable base::Lock lock_;
+  // Guarded by |lock_|.
+  scoped_refptr<const Snapshot> snapshot_;
+
+  DISALLOW_COPY_AND_ASSIGN(TabIndex);
+};
+
+}  // namespace extensions
+
+#endif  // ATOM_BROWSER_EXTENSIONS_TAB_INDEX_H_
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <string>
 #include <vector>
 
 #include "atom/browser/importer/external_process_importer_client.h"
@@ -17,9 +18,13 @@ ExternalProcessImporterClient::ExternalProcessImporterClient(
     InProcessImporterBridge* bridge)
     : ::ExternalProcessImporterClient(
           importer_host, source_profile, items, bridge),
-      total_cookies_count_(0),
       bridge_(bridge),
-      cancelled_(false) {}
+      cancelled_(false),
+      weak_factory_(this) {
+  bridge_->SetRowsConsumedCallback(
+      base::BindRepeating(&ExternalProcessImporterClient::OnRowsConsumed,
+                          weak_factory_.GetWeakPtr()));
+}
 
 void ExternalProcessImporterClient::Cancel() {
   if (cancelled_)
@@ -29,23 +34,51 @@ void ExternalProcessImporterClient::Cancel() {
   ::ExternalProcessImporterClient::Cancel();
 }
 
-void ExternalProcessImporterClient::OnCookiesImportStart(
-    uint32_t total_cookies_count) {
+void ExternalProcessImporterClient::OnHistoryImportStart(
+    uint32_t total_history_rows_count) {
+}
+
+void ExternalProcessImporterClient::OnHistoryImportGroup(
+    const std::vector<ImporterURLRow>& history_rows_group,
+    int visit_source) {
   if (cancelled_)
     return;
 
-  total_cookies_count_ = total_cookies_count;
-  cookies_.reserve(total_cookies_count);
+  bridge_->SetHistoryItems(history_rows_group,
+                           static_cast<importer::VisitSource>(visit_source));
 }
+
+void ExternalProcessImporterClient::OnCookiesImportStart(
+    uint32_t total_cookies_count) {
+}
+
 void ExternalProcessImporterClient::OnCookiesImportGroup(
     const std::vector<ImportedCookieEntry>& cookies_group) {
   if (cancelled_)
     return;
 
-  cookies_.insert(cookies_.end(), cookies_group.begin(),
-                  cookies_group.end());
-  if (cookies_.size() >= total_cookies_count_)
-    bridge_->SetCookies(cookies_);
+  bridge_->SetCookies(cookies_group);
+}
+
+void ExternalProcessImporterClient::OnImportItemStats(
+    importer::ImportItem item,
+    uint32_t rows,
+    int64_t elapsed_us) {
+  if (cancelled_)
+    return;
+
+  bridge_->SetItemStats(item, rows,
+                        base::TimeDelta::FromMicroseconds(elapsed_us));
+}
+
+void ExternalProcessImporterClient::OnRowsConsumed(const std::string& item,
+                                                   size_t rows) {
+  // Only history and cookies are streamed from the utility process.
+  if (cancelled_ || (item != "history" && item != "cookies"))
+    return;
+
+  if (profile_import())
+    profile_import()->ImportRowsConsumed(rows);
 }
 
 ExternalProcessImporterClient::~ExternalProcessImporterClient() {}
@@ -5,10 +5,12 @@
 #ifndef ATOM_BROWSER_IMPORTER_EXTERNAL_PROCESS_IMPORTER_CLIENT_H_
 #define ATOM_BROWSER_IMPORTER_EXTERNAL_PROCESS_IMPORTER_CLIENT_H_
 
+#include <string>
 #include <vector>
 
 #include "chrome/browser/importer/external_process_importer_client.h"
 
+#include "base/memory/weak_ptr.h"
 #include "brave/common/importer/imported_cookie_entry.h"
 
 namespace atom {
@@ -26,25 +28,34 @@ class ExternalProcessImporterClient : public ::ExternalProcessImporterClient {
   // Called by the ExternalProcessImporterHost on import cancel.
   void Cancel();
 
+  // History and cookie groups are handed on as they arrive instead of being
+  // collected first. The utility process only sends more of them once the
+  // writer reports rows consumed.
+  void OnHistoryImportStart(uint32_t total_history_rows_count) override;
+  void OnHistoryImportGroup(
+      const std::vector<ImporterURLRow>& history_rows_group,
+      int visit_source) override;
   void OnCookiesImportStart(
       uint32_t total_cookies_count) override;
   void OnCookiesImportGroup(
       const std::vector<ImportedCookieEntry>&
           cookies_group) override;
+  void OnImportItemStats(importer::ImportItem item,
+                         uint32_t rows,
+                         int64_t elapsed_us) override;
 
  private:
   ~ExternalProcessImporterClient() override;
 
-  // Total number of cookies to import.
-  size_t total_cookies_count_;
+  void OnRowsConsumed(const std::string& item, size_t rows);
 
   scoped_refptr<InProcessImporterBridge> bridge_;
 
-  std::vector<ImportedCookieEntry> cookies_;
-
   // True if import process has been cancelled.
   bool cancelled_;
 
+  base::WeakPtrFactory<ExternalProcessImporterClient> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(ExternalProcessImporterClient);
 };
 
@@ -81,6 +81,18 @@ void InProcessImporterBridge::SetCookies(
   writer_->AddCookies(cookies);
 }
 
+void InProcessImporterBridge::SetItemStats(importer::ImportItem item,
+                                           size_t rows,
+                                           base::TimeDelta elapsed) {
+  writer_->AddItemStats(item, rows, elapsed);
+}
+
+void InProcessImporterBridge::SetRowsConsumedCallback(
+    const base::RepeatingCallback<void(const std::string&, size_t)>&
+        callback) {
+  writer_->SetRowsConsumedCallback(callback);
+}
+
 InProcessImporterBridge::~InProcessImporterBridge() {}
 
 }  // namespace atom
@@ -10,8 +10,10 @@
 
 #include "chrome/browser/importer/in_process_importer_bridge.h"
 
+#include "base/callback.h"
 #include "base/compiler_specific.h"
 #include "base/macros.h"
+#include "base/time/time.h"
 #include "build/build_config.h"
 
 struct ImportedCookieEntry;
@@ -37,6 +39,17 @@ class InProcessImporterBridge : public ::InProcessImporterBridge {
 
   virtual void SetCookies(const std::vector<ImportedCookieEntry>& cookies);
 
+  // Called with the rows |item| imported and how long that took.
+  virtual void SetItemStats(importer::ImportItem item,
+                            size_t rows,
+                            base::TimeDelta elapsed);
+
+  // Reports rows the writer is done with, see
+  // ProfileWriter::SetRowsConsumedCallback.
+  void SetRowsConsumedCallback(
+      const base::RepeatingCallback<void(const std::string&, size_t)>&
+          callback);
+
  private:
   ~InProcessImporterBridge() override;
 
@@ -4,6 +4,7 @@
 
 #include "atom/browser/importer/profile_writer.h"
 
+#include <algorithm>
 #include <memory>
 #include <set>
 #include <string>
@@ -49,9 +50,37 @@ void ShowImportLockDialog(gfx::NativeWindow parent,
 
 namespace atom {
 
+namespace {
+
+std::string ImportItemToString(importer::ImportItem item) {
+  switch (item) {
+    case importer::HISTORY:
+      return "history";
+    case importer::FAVORITES:
+      return "favorites";
+    case importer::COOKIES:
+      return "cookies";
+    case importer::PASSWORDS:
+      return "passwords";
+    case importer::SEARCH_ENGINES:
+      return "searchEngines";
+    case importer::HOME_PAGE:
+      return "homePage";
+    case importer::AUTOFILL_FORM_DATA:
+      return "autofillFormData";
+    default:
+      return "unknown";
+  }
+}
+
+}  // namespace
+
 ProfileWriter::ProfileWriter(Profile* profile) :
     ::ProfileWriter(profile),
-    importer_(nullptr) {}
+    importer_(nullptr),
+    chunk_size_(0),
+    max_pending_chunks_(0),
+    delivery_scheduled_(false) {}
 
 bool ProfileWriter::BookmarkModelIsLoaded() const {
   return true;
@@ -76,19 +105,23 @@ void ProfileWriter::AddIE7PasswordInfo(const IE7PasswordInfo& info) {
 
 void ProfileWriter::AddHistoryPage(const history::URLRows& page,
                                    history::VisitSource visit_source) {
-  if (importer_) {
-    base::ListValue history_list;
-    for (const history::URLRow& row : page) {
-      base::DictionaryValue* history = new base::DictionaryValue();
-      history->SetString("title", row.title());
-      history->SetString("url", row.url().possibly_invalid_spec());
-      history->SetInteger("visit_count", row.visit_count());
-      history->SetInteger("last_visit", row.last_visit().ToDoubleT());
-      history_list.Append(std::unique_ptr<base::DictionaryValue>(history));
-    }
-    importer_->Emit("add-history-page", history_list,
-                    (unsigned int) visit_source);
+  AddChunks(page, "history",
+            base::Bind(&ProfileWriter::EmitHistoryPage, this, visit_source));
+}
+
+void ProfileWriter::EmitHistoryPage(history::VisitSource visit_source,
+                                    const history::URLRows& page) {
+  base::ListValue history_list;
+  for (const history::URLRow& row : page) {
+    base::DictionaryValue* history = new base::DictionaryValue();
+    history->SetString("title", row.title());
+    history->SetString("url", row.url().possibly_invalid_spec());
+    history->SetInteger("visit_count", row.visit_count());
+    history->SetInteger("last_visit", row.last_visit().ToDoubleT());
+    history_list.Append(std::unique_ptr<base::DictionaryValue>(history));
   }
+  importer_->Emit("add-history-page", history_list,
+                  (unsigned int) visit_source);
 }
 
 void ProfileWriter::AddHomepage(const GURL& home_page) {
@@ -103,56 +136,72 @@ void ProfileWriter::AddBookmarks(
   if (bookmarks.empty())
     return;
 
-  if (importer_) {
-    base::ListValue imported_bookmarks;
-    for (const ImportedBookmarkEntry& bookmark : bookmarks) {
-      base::DictionaryValue* imported_bookmark = new base::DictionaryValue();
-      imported_bookmark->SetBoolean("in_toolbar", bookmark.in_toolbar);
-      imported_bookmark->SetBoolean("is_folder", bookmark.is_folder);
-      imported_bookmark->SetString("url", bookmark.url.possibly_invalid_spec());
-      imported_bookmark->SetString("title", bookmark.title);
-      imported_bookmark->SetInteger("creation_time",
-                                    bookmark.creation_time.ToDoubleT());
-      auto paths = std::make_unique<base::ListValue>();
-      for (const base::string16& path : bookmark.path) {
-        paths->AppendString(path);
-      }
-      imported_bookmark->Set("path", std::move(paths));
-      imported_bookmarks.Append(std::unique_ptr<base::DictionaryValue>(
-                                    imported_bookmark));
+  AddChunks(bookmarks, "bookmarks",
+            base::Bind(&ProfileWriter::EmitBookmarks, this,
+                       top_level_folder_name));
+}
+
+void ProfileWriter::EmitBookmarks(
+    const base::string16& top_level_folder_name,
+    const std::vector<ImportedBookmarkEntry>& bookmarks) {
+  base::ListValue imported_bookmarks;
+  for (const ImportedBookmarkEntry& bookmark : bookmarks) {
+    base::DictionaryValue* imported_bookmark = new base::DictionaryValue();
+    imported_bookmark->SetBoolean("in_toolbar", bookmark.in_toolbar);
+    imported_bookmark->SetBoolean("is_folder", bookmark.is_folder);
+    imported_bookmark->SetString("url", bookmark.url.possibly_invalid_spec());
+    imported_bookmark->SetString("title", bookmark.title);
+    imported_bookmark->SetInteger("creation_time",
+                                  bookmark.creation_time.ToDoubleT());
+    auto paths = std::make_unique<base::ListValue>();
+    for (const base::string16& path : bookmark.path) {
+      paths->AppendString(path);
     }
-    importer_->Emit("add-bookmarks", imported_bookmarks, top_level_folder_name);
+    imported_bookmark->Set("path", std::move(paths));
+    imported_bookmarks.Append(std::unique_ptr<base::DictionaryValue>(
+                                  imported_bookmark));
   }
+  importer_->Emit("add-bookmarks", imported_bookmarks, top_level_folder_name);
 }
 
 void ProfileWriter::AddFavicons(
     const favicon_base::FaviconUsageDataList& favicons) {
-  if (importer_) {
-    base::ListValue imported_favicons;
-    for (const favicon_base::FaviconUsageData& favicon : favicons) {
-      base::DictionaryValue* imported_favicon = new base::DictionaryValue();
-      imported_favicon->SetString("favicon_url",
-                                  favicon.favicon_url.possibly_invalid_spec());
+  AddChunks(favicons, "favicons",
+            base::Bind(&ProfileWriter::EmitFavicons, this));
+}
+
+void ProfileWriter::EmitFavicons(
+    const favicon_base::FaviconUsageDataList& favicons) {
+  base::ListValue imported_favicons;
+  for (const favicon_base::FaviconUsageData& favicon : favicons) {
+    base::DictionaryValue* imported_favicon = new base::DictionaryValue();
+    imported_favicon->SetString("favicon_url",
+                                favicon.favicon_url.possibly_invalid_spec());
+    if (chunk_size_) {
+      // Streaming consumers get the PNG itself, as a Buffer.
+      imported_favicon->Set("png_data", std::make_unique<base::Value>(
+          base::Value::BlobStorage(favicon.png_data.begin(),
+                                   favicon.png_data.end())));
+    } else {
       std::string data_url;
       data_url.insert(data_url.end(), favicon.png_data.begin(),
                       favicon.png_data.end());
       base::Base64Encode(data_url, &data_url);
       data_url.insert(0, "data:image/png;base64,");
       imported_favicon->SetString("png_data", data_url);
-      std::set<GURL>::iterator it;
-      auto urls = std::make_unique<base::ListValue>();
-      for (it = favicon.urls.begin(); it != favicon.urls.end(); ++it) {
-        urls->AppendString(it->possibly_invalid_spec());
-      }
-      imported_favicon->Set("urls", std::move(urls));
-      imported_favicons.Append(std::unique_ptr<base::DictionaryValue>(
-                                  imported_favicon));
     }
-    importer_->Emit("add-favicons", imported_favicons);
+    std::set<GURL>::iterator it;
+    auto urls = std::make_unique<base::ListValue>();
+    for (it = favicon.urls.begin(); it != favicon.urls.end(); ++it) {
+      urls->AppendString(it->possibly_invalid_spec());
+    }
+    imported_favicon->Set("urls", std::move(urls));
+    imported_favicons.Append(std::unique_ptr<base::DictionaryValue>(
+                                imported_favicon));
   }
+  importer_->Emit("add-favicons", imported_favicons);
 }
 
-
 void ProfileWriter::AddAutofillFormDataEntries(
     const std::vector<autofill::AutofillEntry>& autofill_entries) {
   if (importer_) {
@@ -172,36 +221,193 @@ void ProfileWriter::AddAutofillFormDataEntries(
 
 void ProfileWriter::AddCookies(
     const std::vector<ImportedCookieEntry>& cookies) {
-  if (importer_) {
-    base::ListValue imported_cookies;
-    for (const ImportedCookieEntry& cookie_entry : cookies) {
-      base::DictionaryValue* cookie = new base::DictionaryValue();
-      base::string16 url;
-      if (cookie_entry.secure) {
-        url.append(base::UTF8ToUTF16("https://"));
-        url.append(cookie_entry.host);
-      } else {
-        url.append(base::UTF8ToUTF16("http://"));
-        url.append(cookie_entry.host);
-      }
-      cookie->SetString("url", url);
-      cookie->SetString("domain", cookie_entry.domain);
-      cookie->SetString("name", cookie_entry.name);
-      cookie->SetString("value", cookie_entry.value);
-      cookie->SetString("path", cookie_entry.path);
-      cookie->SetInteger("expiry_date", cookie_entry.expiry_date.ToDoubleT());
-      cookie->SetBoolean("secure", cookie_entry.secure);
-      cookie->SetBoolean("httponly", cookie_entry.httponly);
-      imported_cookies.Append(std::unique_ptr<base::DictionaryValue>(cookie));
+  AddChunks(cookies, "cookies",
+            base::Bind(&ProfileWriter::EmitCookies, this));
+}
+
+void ProfileWriter::EmitCookies(
+    const std::vector<ImportedCookieEntry>& cookies) {
+  base::ListValue imported_cookies;
+  for (const ImportedCookieEntry& cookie_entry : cookies) {
+    base::DictionaryValue* cookie = new base::DictionaryValue();
+    base::string16 url;
+    if (cookie_entry.secure) {
+      url.append(base::UTF8ToUTF16("https://"));
+      url.append(cookie_entry.host);
+    } else {
+      url.append(base::UTF8ToUTF16("http://"));
+      url.append(cookie_entry.host);
     }
-    importer_->Emit("add-cookies", imported_cookies);
+    cookie->SetString("url", url);
+    cookie->SetString("domain", cookie_entry.domain);
+    cookie->SetString("name", cookie_entry.name);
+    cookie->SetString("value", cookie_entry.value);
+    cookie->SetString("path", cookie_entry.path);
+    cookie->SetInteger("expiry_date", cookie_entry.expiry_date.ToDoubleT());
+    cookie->SetBoolean("secure", cookie_entry.secure);
+    cookie->SetBoolean("httponly", cookie_entry.httponly);
+    imported_cookies.Append(std::unique_ptr<base::DictionaryValue>(cookie));
   }
+  importer_->Emit("add-cookies", imported_cookies);
+}
+
+void ProfileWriter::AddItemStats(importer::ImportItem item,
+                                 size_t rows,
+                                 base::TimeDelta elapsed) {
+  if (importer_) {
+    RunAfterPendingChunks(base::BindOnce(&ProfileWriter::EmitItemStats, this,
+                                         item, rows, elapsed));
+  }
+}
+
+void ProfileWriter::EmitItemStats(importer::ImportItem item,
+                                  size_t rows,
+                                  base::TimeDelta elapsed) {
+  base::DictionaryValue stats;
+  stats.SetString("item", ImportItemToString(item));
+  stats.SetInteger("rows", static_cast<int>(rows));
+  stats.SetDouble("elapsedMs", elapsed.InMillisecondsF());
+  double seconds = elapsed.InSecondsF();
+  stats.SetDouble("rowsPerSecond", seconds > 0 ? rows / seconds : 0);
+  importer_->Emit("import-item-stats", stats);
 }
 
 void ProfileWriter::Initialize(atom::api::Importer* importer) {
   importer_ = importer;
+  if (importer_)
+    return;
+
+  // Nobody is left to emit to, so let the importer move on.
+  base::circular_deque<QueuedChunk> dropped;
+  dropped.swap(queued_chunks_);
+  for (const QueuedChunk& chunk : dropped) {
+    if (!chunk.item.empty())
+      ReportRowsConsumed(chunk.item, chunk.rows);
+  }
+  ReleaseUnackedChunks();
 }
 
+void ProfileWriter::SetStreamingOptions(size_t chunk_size,
+                                        size_t max_pending_chunks) {
+  chunk_size_ = chunk_size;
+  max_pending_chunks_ = max_pending_chunks;
+  if (!max_pending_chunks_)
+    ReleaseUnackedChunks();
+  ScheduleDelivery();
+}
+
+void ProfileWriter::ChunkProcessed() {
+  if (!unacked_chunks_.empty()) {
+    std::pair<std::string, size_t> chunk = std::move(unacked_chunks_.front());
+    unacked_chunks_.pop_front();
+    ReportRowsConsumed(chunk.first, chunk.second);
+  }
+  ScheduleDelivery();
+}
+
+void ProfileWriter::SetRowsConsumedCallback(
+    const RowsConsumedCallback& callback) {
+  rows_consumed_callback_ = callback;
+}
+
+void ProfileWriter::ReportRowsConsumed(const std::string& item, size_t rows) {
+  if (!rows_consumed_callback_.is_null())
+    rows_consumed_callback_.Run(item, rows);
+}
+
+void ProfileWriter::ReleaseUnackedChunks() {
+  base::circular_deque<std::pair<std::string, size_t>> released;
+  released.swap(unacked_chunks_);
+  for (const auto& chunk : released)
+    ReportRowsConsumed(chunk.first, chunk.second);
+}
+
+void ProfileWriter::RunAfterPendingChunks(base::OnceClosure callback) {
+  if (queued_chunks_.empty()) {
+    std::move(callback).Run();
+    return;
+  }
+  QueuedChunk chunk;
+  chunk.emit = std::move(callback);
+  queued_chunks_.push_back(std::move(chunk));
+}
+
+template <typename Row>
+void ProfileWriter::AddChunks(
+    const std::vector<Row>& rows,
+    const std::string& item,
+    const base::Callback<void(const std::vector<Row>&)>& emit) {
+  if (!importer_) {
+    ReportRowsConsumed(item, rows.size());
+    return;
+  }
+
+  if (!chunk_size_) {
+    emit.Run(rows);
+    ReportRowsConsumed(item, rows.size());
+    return;
+  }
+
+  for (size_t begin = 0; begin < rows.size(); begin += chunk_size_) {
+    size_t end = std::min(rows.size(), begin + chunk_size_);
+    QueuedChunk chunk;
+    chunk.emit = base::BindOnce(
+        emit, std::vector<Row>(rows.begin() + begin, rows.begin() + end));
+    chunk.item = item;
+    chunk.rows = end - begin;
+    queued_chunks_.push_back(std::move(chunk));
+  }
+  ScheduleDelivery();
+}
+
+void ProfileWriter::ScheduleDelivery() {
+  if (delivery_scheduled_ || queued_chunks_.empty())
+    return;
+  delivery_scheduled_ = true;
+  content::BrowserThread::PostTask(
+      content::BrowserThread::UI, FROM_HERE,
+      base::Bind(&ProfileWriter::DeliverNextChunk, this));
+}
+
+void ProfileWriter::DeliverNextChunk() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  delivery_scheduled_ = false;
+  if (!importer_ || queued_chunks_.empty())
+    return;
+
+  bool is_chunk = !queued_chunks_.front().item.empty();
+  // Wait for ChunkProcessed() if JS is behind.
+  if (is_chunk && max_pending_chunks_ &&
+      unacked_chunks_.size() >= max_pending_chunks_)
+    return;
+  QueuedChunk chunk = std::move(queued_chunks_.front());
+  queued_chunks_.pop_front();
+
+  // Track the chunk first, JS may acknowledge it from within the event.
+  bool gated = is_chunk && max_pending_chunks_;
+  if (gated)
+    unacked_chunks_.emplace_back(chunk.item, chunk.rows);
+  std::move(chunk.emit).Run();
+  if (is_chunk && !gated)
+    ReportRowsConsumed(chunk.item, chunk.rows);
+  if (is_chunk && importer_) {
+    size_t delivered = delivered_rows_[chunk.item] += chunk.rows;
+    base::DictionaryValue progress;
+    progress.SetString("item", chunk.item);
+    progress.SetInteger("delivered", static_cast<int>(delivered));
+    progress.SetInteger("queuedChunks",
+                        static_cast<int>(queued_chunks_.size()));
+    importer_->Emit("import-progress", progress);
+  }
+  ScheduleDelivery();
+}
+
+ProfileWriter::QueuedChunk::QueuedChunk() : rows(0) {}
+
+ProfileWriter::QueuedChunk::QueuedChunk(QueuedChunk&& other) = default;
+
+ProfileWriter::QueuedChunk::~QueuedChunk() {}
+
 ProfileWriter::~ProfileWriter() {}
 
 }  // namespace atom
@@ -5,11 +5,18 @@
 #ifndef ATOM_BROWSER_IMPORTER_PROFILE_WRITER_H_
 #define ATOM_BROWSER_IMPORTER_PROFILE_WRITER_H_
 
+#include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "base/callback.h"
+#include "base/containers/circular_deque.h"
 #include "base/macros.h"
+#include "base/time/time.h"
 #include "build/build_config.h"
 #include "chrome/browser/importer/profile_writer.h"
+#include "chrome/common/importer/importer_data_types.h"
 
 struct ImportedCookieEntry;
 
@@ -21,6 +28,10 @@ class Importer;
 
 class ProfileWriter : public ::ProfileWriter {
  public:
+  // Called with the name and count of rows JS is done with.
+  using RowsConsumedCallback =
+      base::RepeatingCallback<void(const std::string& item, size_t rows)>;
+
   explicit ProfileWriter(Profile* profile);
 
   bool BookmarkModelIsLoaded() const override;
@@ -44,17 +55,82 @@ class ProfileWriter : public ::ProfileWriter {
   void AddAutofillFormDataEntries(
       const std::vector<autofill::AutofillEntry>& autofill_entries) override;
   virtual void AddCookies(const std::vector<ImportedCookieEntry>& cookies);
+  // Emits "import-item-stats" once the rows of |item| have been emitted.
+  void AddItemStats(importer::ImportItem item,
+                    size_t rows,
+                    base::TimeDelta elapsed);
+  // A null |importer| drops every chunk not emitted yet.
   void Initialize(atom::api::Importer* importer);
 
+  // With a |chunk_size|, imported history, bookmarks, favicons and cookies
+  // are emitted in chunks of at most that many rows, one UI task each, with
+  // an "import-progress" event after every chunk, and favicons carry their
+  // PNG as a Buffer. With |max_pending_chunks| too, delivery waits once that
+  // many chunks have not been acknowledged through ChunkProcessed(). A zero
+  // |chunk_size| emits everything at once, as data URLs for favicons.
+  void SetStreamingOptions(size_t chunk_size, size_t max_pending_chunks);
+  void ChunkProcessed();
+
+  // Rows are consumed once they are emitted, or, with |max_pending_chunks|,
+  // once their chunk has been acknowledged.
+  void SetRowsConsumedCallback(const RowsConsumedCallback& callback);
+
+  // Runs |callback| after everything added so far has been emitted.
+  void RunAfterPendingChunks(base::OnceClosure callback);
+
  protected:
   friend class base::RefCountedThreadSafe<ProfileWriter>;
 
   virtual ~ProfileWriter();
 
  private:
+  struct QueuedChunk {
+    QueuedChunk();
+    QueuedChunk(QueuedChunk&& other);
+    ~QueuedChunk();
+
+    base::OnceClosure emit;
+    // Empty for callbacks of RunAfterPendingChunks().
+    std::string item;
+    size_t rows;
+  };
+
+  // Queues |emit| for each chunk of |rows|, or runs it with all of them when
+  // not streaming.
+  template <typename Row>
+  void AddChunks(const std::vector<Row>& rows,
+                 const std::string& item,
+                 const base::Callback<void(const std::vector<Row>&)>& emit);
+
+  void EmitHistoryPage(history::VisitSource visit_source,
+                       const history::URLRows& page);
+  void EmitBookmarks(const base::string16& top_level_folder_name,
+                     const std::vector<ImportedBookmarkEntry>& bookmarks);
+  void EmitFavicons(const favicon_base::FaviconUsageDataList& favicons);
+  void EmitCookies(const std::vector<ImportedCookieEntry>& cookies);
+  void EmitItemStats(importer::ImportItem item,
+                     size_t rows,
+                     base::TimeDelta elapsed);
+
+  void ScheduleDelivery();
+  void DeliverNextChunk();
+  void ReportRowsConsumed(const std::string& item, size_t rows);
+  // Reports the rows of every chunk not acknowledged yet.
+  void ReleaseUnackedChunks();
+
   // Importer instance of Brave
   atom::api::Importer* importer_;
 
+  size_t chunk_size_;
+  size_t max_pending_chunks_;
+  base::circular_deque<QueuedChunk> queued_chunks_;
+  // Item name and row count of the chunks emitted but not acknowledged yet.
+  base::circular_deque<std::pair<std::string, size_t>> unacked_chunks_;
+  bool delivery_scheduled_;
+  // Rows delivered so far, by item name.
+  std::map<std::string, size_t> delivered_rows_;
+  RowsConsumedCallback rows_consumed_callback_;
+
   DISALLOW_COPY_AND_ASSIGN(ProfileWriter);
 };
 
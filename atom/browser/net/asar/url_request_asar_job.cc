@@ -4,6 +4,8 @@
 
 #include "atom/browser/net/asar/url_request_asar_job.h"
 
+#include <string.h>
+
 #include <string>
 #include <utility>
 #include <vector>
@@ -13,6 +15,7 @@
 #include "atom/common/atom_constants.h"
 #include "base/bind.h"
 #include "base/files/file_util.h"
+#include "base/files/memory_mapped_file.h"
 #include "base/strings/string_util.h"
 #include "base/synchronization/lock.h"
 #include "base/task_runner.h"
@@ -40,6 +43,7 @@ void Initialize(
     std::shared_ptr<Archive>& archive,  // NOLINT
     base::FilePath* file_path,
     Archive::FileInfo* file_info,
+    const base::MemoryMappedFile** archive_mapping,
     URLRequestAsarJob::JobType* type) {
   // Determine whether it is an asar file.
   base::FilePath asar_path, relative_path;
@@ -63,6 +67,9 @@ void Initialize(
   }
 
   *file_path = relative_path;
+  // Falls back to reading the file, which fails cleanly, when the archive
+  // was truncated since it was opened.
+  *archive_mapping = archive->GetMappedFileFor(*file_info);
   *type = URLRequestAsarJob::TYPE_ASAR;
 }
 
@@ -81,6 +88,7 @@ URLRequestAsarJob::URLRequestAsarJob(
     const scoped_refptr<base::TaskRunner> file_task_runner)
     : net::URLRequestJob(request, network_delegate),
       type_(TYPE_ERROR),
+      archive_mapping_(nullptr),
       remaining_bytes_(0),
       seek_offset_(0),
       range_parse_result_(net::OK),
@@ -103,13 +111,17 @@ void URLRequestAsarJob::Start() {
   file_task_runner_->PostTaskAndReply(
       FROM_HERE,
       base::Bind(&Initialize,
-          full_path_, std::ref(archive_), &file_path_, &file_info_, &type_),
+          full_path_, std::ref(archive_), &file_path_, &file_info_,
+          &archive_mapping_, &type_),
       base::Bind(&URLRequestAsarJob::DidInitialize,
           weak_ptr_factory_.GetWeakPtr()));
 }
 
 void URLRequestAsarJob::DidInitialize() {
-  if (type_ == TYPE_ASAR) {
+  if (type_ == TYPE_ASAR && archive_mapping_) {
+    // The archive is already mapped, nothing to open.
+    DidOpen(net::OK);
+  } else if (type_ == TYPE_ASAR) {
     InitializeAsarJob();
     int flags = base::File::FLAG_OPEN |
                 base::File::FLAG_READ |
@@ -151,6 +163,13 @@ int URLRequestAsarJob::ReadRawData(net::IOBuffer* dest, int dest_size) {
   if (!dest_size)
     return 0;
 
+  if (archive_mapping_) {
+    memcpy(dest->data(), archive_mapping_->data() + seek_offset_, dest_size);
+    seek_offset_ += dest_size;
+    remaining_bytes_ -= dest_size;
+    return dest_size;
+  }
+
   int rv = stream_->Read(dest,
                          dest_size,
                          base::Bind(&URLRequestAsarJob::DidRead,
@@ -308,7 +327,14 @@ void URLRequestAsarJob::DidOpen(int result) {
                      byte_range_.first_byte_position() + 1;
   seek_offset_ = byte_range_.first_byte_position() + read_offset;
 
-  if (remaining_bytes_ > 0 && seek_offset_ != 0) {
+  if (archive_mapping_) {
+    // Guard against a header pointing past the end of the archive.
+    if (seek_offset_ + remaining_bytes_ >
+        static_cast<int64_t>(archive_mapping_->length()))
+      DidSeek(-1);
+    else
+      DidSeek(seek_offset_);
+  } else if (remaining_bytes_ > 0 && seek_offset_ != 0) {
     int rv = stream_->Seek(seek_offset_,
                            base::Bind(&URLRequestAsarJob::DidSeek,
                                       weak_ptr_factory_.GetWeakPtr()));
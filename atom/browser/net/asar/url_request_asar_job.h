@@ -17,6 +17,7 @@
 #include "net/url_request/url_request_job.h"
 
 namespace base {
+class MemoryMappedFile;
 class TaskRunner;
 }
 
@@ -112,8 +113,13 @@ class URLRequestAsarJob : public net::URLRequestJob {
   std::unique_ptr<net::FileStream> stream_;
   FileMetaInfo meta_info_;
 
+  // When set, TYPE_ASAR reads are served straight from this mapping of the
+  // whole archive instead of |stream_|. Owned by |archive_|.
+  const base::MemoryMappedFile* archive_mapping_;
+
   net::HttpByteRange byte_range_;
   int64_t remaining_bytes_;
+  // Position in the file; advanced by reads when |archive_mapping_| is used.
   int64_t seek_offset_;
 
   net::Error range_parse_result_;
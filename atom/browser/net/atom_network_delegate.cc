@@ -6,11 +6,14 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "atom/browser/extensions/tab_helper.h"
+#include "atom/browser/extensions/tab_index.h"
 #include "atom/common/native_mate_converters/net_converter.h"
 #include "base/stl_util.h"
 #include "base/strings/string_util.h"
+#include "base/timer/timer.h"
 #include "chrome/browser/extensions/api/tabs/tabs_constants.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/render_frame_host.h"
@@ -50,6 +53,11 @@ const char* ResourceTypeToString(content::ResourceType type) {
 
 namespace {
 
+// Upper bound of batches posted to the UI thread but not yet delivered. Once
+// it is reached, batches keep filling up on the IO thread and events that
+// don't fit are dropped.
+const size_t kMaxBatchesInFlight = 4;
+
 struct ResponseHeadersContainer {
   scoped_refptr<net::HttpResponseHeaders>* headers;
   std::string status_line;
@@ -77,37 +85,74 @@ int GetTabId(int frame_tree_node_id,
   return extensions::TabHelper::IdForTab(web_contents);
 }
 
+// Fills in the tabId from the tab index on the IO thread. Frames the last
+// snapshot does not know yet are left to SetTabIdInUI.
+void SetTabIdInIO(WebRequestDetails* details,
+                  int frame_tree_node_id,
+                  int render_frame_id,
+                  int render_process_id) {
+  int32_t tab_id = extensions::TabIndex::GetInstance()->GetSnapshot()->GetTabId(
+      frame_tree_node_id, render_process_id, render_frame_id);
+  if (tab_id != -1)
+    details->fields.SetInteger(extensions::tabs_constants::kTabIdKey, tab_id);
+}
+
+void SetTabIdInUI(WebRequestDetails* details,
+                  int frame_tree_node_id,
+                  int render_frame_id,
+                  int render_process_id) {
+  if (details->fields.HasKey(extensions::tabs_constants::kTabIdKey))
+    return;
+  details->fields.SetInteger(extensions::tabs_constants::kTabIdKey,
+      GetTabId(frame_tree_node_id, render_frame_id, render_process_id));
+}
+
 void RunSimpleListener(const AtomNetworkDelegate::SimpleListener& listener,
-                       std::unique_ptr<base::DictionaryValue> details,
+                       std::unique_ptr<WebRequestDetails> details,
                        int frame_tree_node_id,
                        int render_frame_id,
                        int render_process_id) {
-  details->SetInteger(extensions::tabs_constants::kTabIdKey,
-      GetTabId(frame_tree_node_id, render_frame_id, render_process_id));
+  SetTabIdInUI(details.get(), frame_tree_node_id, render_frame_id,
+               render_process_id);
   return listener.Run(*(details.get()));
 }
 
+struct PendingSimpleEvent {
+  std::unique_ptr<WebRequestDetails> details;
+  int frame_tree_node_id;
+  int render_frame_id;
+  int render_process_id;
+};
+
+void RunSimpleBatchListener(
+    const AtomNetworkDelegate::SimpleBatchListener& listener,
+    std::unique_ptr<std::vector<PendingSimpleEvent>> events,
+    const base::Closure& delivered) {
+  WebRequestDetailsList details_list;
+  details_list.reserve(events->size());
+  for (auto& event : *events) {
+    SetTabIdInUI(event.details.get(), event.frame_tree_node_id,
+                 event.render_frame_id, event.render_process_id);
+    details_list.push_back(std::move(event.details));
+  }
+  listener.Run(details_list);
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE, delivered);
+}
+
 void RunResponseListener(
     const AtomNetworkDelegate::ResponseListener& listener,
-    std::unique_ptr<base::DictionaryValue> details,
+    std::unique_ptr<WebRequestDetails> details,
     int frame_tree_node_id, int render_frame_id, int render_process_id,
     const AtomNetworkDelegate::ResponseCallback& callback) {
-  details->SetInteger(extensions::tabs_constants::kTabIdKey,
-      GetTabId(frame_tree_node_id, render_frame_id, render_process_id));
+  SetTabIdInUI(details.get(), frame_tree_node_id, render_frame_id,
+               render_process_id);
   return listener.Run(*(details.get()), callback);
 }
 
 // Test whether the URL of |request| matches |patterns|.
 bool MatchesFilterCondition(net::URLRequest* request,
-                            const URLPatterns& patterns) {
-  if (patterns.empty())
-    return true;
-
-  for (const auto& pattern : patterns) {
-    if (pattern.MatchesURL(request->url()))
-      return true;
-  }
-  return false;
+                            const URLPatternMatcher& patterns) {
+  return patterns.MatchesURL(request->url());
 }
 
 void GetRenderFrameIdAndProcessId(net::URLRequest* request,
@@ -137,84 +182,66 @@ void GetFrameTreeNodeId(net::URLRequest* request, int* frame_tree_node_id) {
 }
 
 // Overloaded by multiple types to fill the |details| object.
-void ToDictionary(base::DictionaryValue* details, net::URLRequest* request) {
-  FillRequestDetails(details, request);
-  details->SetInteger("id", request->identifier());
-  details->SetDouble("timestamp", base::Time::Now().ToDoubleT() * 1000);
-  details->SetString("firstPartyUrl", request->site_for_cookies().spec());
+void ToDictionary(WebRequestDetails* details, net::URLRequest* request) {
+  base::DictionaryValue* fields = &details->fields;
+  FillRequestDetails(fields, request);
+  fields->SetInteger("id", request->identifier());
+  fields->SetDouble("timestamp", base::Time::Now().ToDoubleT() * 1000);
+  fields->SetString("firstPartyUrl", request->site_for_cookies().spec());
   auto info = content::ResourceRequestInfo::ForRequest(request);
-  details->SetString("resourceType",
-                     info ? ResourceTypeToString(info->GetResourceType())
-                          : "other");
+  fields->SetString("resourceType",
+                    info ? ResourceTypeToString(info->GetResourceType())
+                         : "other");
   net::IPEndPoint request_ip_endpoint;
   bool was_successful = request->GetRemoteEndpoint(&request_ip_endpoint);
   if (was_successful) {
-    details->SetString("ip", request_ip_endpoint.ToStringWithoutPort());
-    details->SetInteger("port", request_ip_endpoint.port());
+    fields->SetString("ip", request_ip_endpoint.ToStringWithoutPort());
+    fields->SetInteger("port", request_ip_endpoint.port());
   }
 }
 
-void ToDictionary(base::DictionaryValue* details,
+void ToDictionary(WebRequestDetails* details,
                   const net::HttpRequestHeaders& headers) {
-  std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
-  net::HttpRequestHeaders::Iterator it(headers);
-  while (it.GetNext())
-    dict->SetKey(it.name(), base::Value(it.value()));
-  details->Set("requestHeaders", std::move(dict));
+  details->SetRequestHeaders(headers);
 }
 
-void ToDictionary(base::DictionaryValue* details,
+void ToDictionary(WebRequestDetails* details,
                   const net::HttpResponseHeaders* headers) {
   if (!headers)
     return;
 
-  std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
-  size_t iter = 0;
-  std::string key;
-  std::string value;
-  while (headers->EnumerateHeaderLines(&iter, &key, &value)) {
-    if (dict->HasKey(key)) {
-      base::ListValue* values = nullptr;
-      if (dict->GetList(key, &values))
-        values->AppendString(value);
-    } else {
-      std::unique_ptr<base::ListValue> values(new base::ListValue);
-      values->AppendString(value);
-      dict->Set(key, std::move(values));
-    }
-  }
-  details->Set("responseHeaders", std::move(dict));
-  details->SetString("statusLine", headers->GetStatusLine());
-  details->SetInteger("statusCode", headers->response_code());
+  details->SetResponseHeaders(*headers);
+  details->fields.SetString("statusLine", headers->GetStatusLine());
+  details->fields.SetInteger("statusCode", headers->response_code());
 }
 
-void ToDictionary(base::DictionaryValue* details, const GURL& location) {
-  details->SetString("redirectURL", location.spec());
+void ToDictionary(WebRequestDetails* details, const GURL& location) {
+  details->fields.SetString("redirectURL", location.spec());
 }
 
-void ToDictionary(base::DictionaryValue* details,
+void ToDictionary(WebRequestDetails* details,
                   const net::HostPortPair& host_port) {
   if (host_port.host().empty())
-    details->SetString("ip", host_port.host());
+    details->fields.SetString("ip", host_port.host());
 }
 
-void ToDictionary(base::DictionaryValue* details, bool from_cache) {
-  details->SetBoolean("fromCache", from_cache);
+void ToDictionary(WebRequestDetails* details, bool from_cache) {
+  details->fields.SetBoolean("fromCache", from_cache);
 }
 
-void ToDictionary(base::DictionaryValue* details,
+void ToDictionary(WebRequestDetails* details,
                   const net::URLRequestStatus& status) {
-  details->SetString("error", net::ErrorToString(status.error()));
+  details->fields.SetString("error", net::ErrorToString(status.error()));
 }
 
 // Helper function to fill |details| with arbitrary |args|.
 template<typename Arg>
-void FillDetailsObject(base::DictionaryValue* details, Arg arg) {
+void FillDetailsObject(WebRequestDetails* details, Arg arg) {
   ToDictionary(details, arg);
 }
 
 template<typename Arg, typename... Args>
-void FillDetailsObject(base::DictionaryValue* details, Arg arg, Args... args) {
+void FillDetailsObject(WebRequestDetails* details, Arg arg, Args... args) {
   ToDictionary(details, arg);
   FillDetailsObject(details, args...);
 }
@@ -273,7 +300,15 @@ void ReadFromResponseObject(const base::DictionaryValue& response,
 
 }  // namespace
 
-AtomNetworkDelegate::AtomNetworkDelegate() : weak_factory_(this) {
+struct AtomNetworkDelegate::EventBatch {
+  std::vector<PendingSimpleEvent> events;
+  base::OneShotTimer timer;
+};
+
+AtomNetworkDelegate::AtomNetworkDelegate()
+    : batches_in_flight_(0),
+      batch_stats_(),
+      weak_factory_(this) {
 }
 
 AtomNetworkDelegate::~AtomNetworkDelegate() {
@@ -283,10 +318,29 @@ void AtomNetworkDelegate::SetSimpleListenerInIO(
     SimpleEvent type,
     const URLPatterns& patterns,
     const SimpleListener& callback) {
+  DiscardBatch(type);
   if (callback.is_null())
     simple_listeners_.erase(type);
   else
-    simple_listeners_[type] = { patterns, callback };
+    simple_listeners_[type] = { URLPatternMatcher(patterns), callback };
+}
+
+void AtomNetworkDelegate::SetSimpleBatchListenerInIO(
+    SimpleEvent type,
+    const URLPatterns& patterns,
+    const BatchOptions& options,
+    const SimpleBatchListener& callback) {
+  DiscardBatch(type);
+  if (callback.is_null()) {
+    simple_listeners_.erase(type);
+    return;
+  }
+
+  SimpleListenerInfo& info = simple_listeners_[type];
+  info.url_patterns = URLPatternMatcher(patterns);
+  info.listener.Reset();
+  info.batch_listener = callback;
+  info.batch_options = options;
 }
 
 void AtomNetworkDelegate::SetResponseListenerInIO(
@@ -296,7 +350,17 @@ void AtomNetworkDelegate::SetResponseListenerInIO(
   if (callback.is_null())
     response_listeners_.erase(type);
   else
-    response_listeners_[type] = { patterns, callback };
+    response_listeners_[type] = { URLPatternMatcher(patterns), callback };
+}
+
+void AtomNetworkDelegate::SetRulesInIO(
+    const std::vector<WebRequestRule>& rules) {
+  rules_.SetRules(rules);
+}
+
+AtomNetworkDelegate::BatchStats
+AtomNetworkDelegate::GetBatchStatsInIO() const {
+  return batch_stats_;
 }
 
 void AtomNetworkDelegate::SetDevToolsNetworkEmulationClientId(
@@ -309,6 +373,17 @@ int AtomNetworkDelegate::OnBeforeURLRequest(
     net::URLRequest* request,
     const net::CompletionCallback& callback,
     GURL* new_url) {
+  if (!rules_.empty()) {
+    switch (rules_.EvaluateRequest(request, new_url)) {
+      case WebRequestRules::kBlocked:
+        return net::ERR_BLOCKED_BY_CLIENT;
+      case WebRequestRules::kRedirected:
+        return net::OK;
+      case WebRequestRules::kNoMatch:
+        break;
+    }
+  }
+
   if (!base::ContainsKey(response_listeners_, kOnBeforeRequest))
     return brightray::NetworkDelegate::OnBeforeURLRequest(
         request, callback, new_url);
@@ -330,6 +405,7 @@ int AtomNetworkDelegate::OnBeforeStartTransaction(
     headers->SetHeader(network::ThrottlingNetworkTransaction::
                            kDevToolsEmulateNetworkConditionsClientId,
                        client_id);
+  rules_.ApplyHeaderRules(request, headers);
   if (!base::ContainsKey(response_listeners_, kOnBeforeSendHeaders))
     return brightray::NetworkDelegate::OnBeforeStartTransaction(
         request, callback, headers);
@@ -443,7 +519,7 @@ int AtomNetworkDelegate::HandleResponseEvent(
   if (!MatchesFilterCondition(request, info.url_patterns))
     return net::OK;
 
-  std::unique_ptr<base::DictionaryValue> details(new base::DictionaryValue);
+  std::unique_ptr<WebRequestDetails> details(new WebRequestDetails);
   FillDetailsObject(details.get(), request, args...);
 
   // The |request| could be destroyed before the |callback| is called.
@@ -455,6 +531,8 @@ int AtomNetworkDelegate::HandleResponseEvent(
   int render_frame_id = -1;
   int render_process_id = -1;
   GetRenderFrameIdAndProcessId(request, &render_frame_id, &render_process_id);
+  SetTabIdInIO(details.get(), frame_tree_node_id, render_frame_id,
+               render_process_id);
 
   ResponseCallback response =
       base::Bind(&AtomNetworkDelegate::OnListenerResultInUI<Out>,
@@ -474,7 +552,7 @@ void AtomNetworkDelegate::HandleSimpleEvent(
   if (!MatchesFilterCondition(request, info.url_patterns))
     return;
 
-  std::unique_ptr<base::DictionaryValue> details(new base::DictionaryValue);
+  std::unique_ptr<WebRequestDetails> details(new WebRequestDetails);
   FillDetailsObject(details.get(), request, args...);
 
   int frame_tree_node_id = -1;
@@ -483,6 +561,14 @@ void AtomNetworkDelegate::HandleSimpleEvent(
   int render_frame_id = -1;
   int render_process_id = -1;
   GetRenderFrameIdAndProcessId(request, &render_frame_id, &render_process_id);
+  SetTabIdInIO(details.get(), frame_tree_node_id, render_frame_id,
+               render_process_id);
+
+  if (!info.batch_listener.is_null()) {
+    AddToBatch(type, std::move(details), frame_tree_node_id, render_frame_id,
+               render_process_id);
+    return;
+  }
 
   BrowserThread::PostTask(
       BrowserThread::UI, FROM_HERE,
@@ -490,6 +576,88 @@ void AtomNetworkDelegate::HandleSimpleEvent(
           frame_tree_node_id, render_frame_id, render_process_id));
 }
 
+void AtomNetworkDelegate::AddToBatch(
+    SimpleEvent type,
+    std::unique_ptr<WebRequestDetails> details,
+    int frame_tree_node_id,
+    int render_frame_id,
+    int render_process_id) {
+  const BatchOptions& options = simple_listeners_[type].batch_options;
+  std::unique_ptr<EventBatch>& batch = batches_[type];
+  if (!batch)
+    batch.reset(new EventBatch);
+
+  // The batch could not be flushed because JS is still busy with earlier
+  // ones.
+  if (batch->events.size() >= options.max_size) {
+    ++batch_stats_.dropped;
+    return;
+  }
+
+  batch->events.push_back({ std::move(details), frame_tree_node_id,
+                            render_frame_id, render_process_id });
+  ++batch_stats_.batched;
+
+  if (batch->events.size() >= options.max_size) {
+    FlushBatch(type);
+  } else if (!batch->timer.IsRunning()) {
+    // The timer is owned by |this|.
+    batch->timer.Start(FROM_HERE, options.interval,
+                       base::Bind(&AtomNetworkDelegate::FlushBatch,
+                                  base::Unretained(this), type));
+  }
+}
+
+void AtomNetworkDelegate::FlushBatch(SimpleEvent type) {
+  auto it = batches_.find(type);
+  if (it == batches_.end() || it->second->events.empty())
+    return;
+  // Retried from OnBatchDeliveredInIO.
+  if (batches_in_flight_ >= kMaxBatchesInFlight)
+    return;
+
+  EventBatch* batch = it->second.get();
+  batch->timer.Stop();
+
+  std::unique_ptr<std::vector<PendingSimpleEvent>> events(
+      new std::vector<PendingSimpleEvent>);
+  events->swap(batch->events);
+  ++batches_in_flight_;
+
+  base::Closure delivered =
+      base::Bind(&AtomNetworkDelegate::OnBatchDeliveredInIO,
+                 weak_factory_.GetWeakPtr(), events->size());
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(RunSimpleBatchListener,
+                 simple_listeners_[type].batch_listener,
+                 base::Passed(&events), delivered));
+}
+
+void AtomNetworkDelegate::DiscardBatch(SimpleEvent type) {
+  auto it = batches_.find(type);
+  if (it == batches_.end())
+    return;
+  // The events were queued for a listener that is gone now.
+  batch_stats_.dropped += it->second->events.size();
+  batches_.erase(it);
+}
+
+void AtomNetworkDelegate::OnBatchDeliveredInIO(size_t count) {
+  --batches_in_flight_;
+  batch_stats_.delivered += count;
+
+  // Flush the batches that became due while the UI thread was behind.
+  for (const auto& it : batches_) {
+    const EventBatch& batch = *it.second;
+    if (!batch.events.empty() &&
+        (!batch.timer.IsRunning() ||
+         batch.events.size() >=
+             simple_listeners_[it.first].batch_options.max_size))
+      FlushBatch(it.first);
+  }
+}
+
 template<typename T>
 void AtomNetworkDelegate::OnListenerResultInIO(
     uint64_t id, T out, std::unique_ptr<base::DictionaryValue> response) {
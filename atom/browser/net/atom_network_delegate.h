@@ -9,10 +9,15 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
+#include "atom/browser/net/url_pattern_matcher.h"
+#include "atom/browser/net/web_request_details.h"
+#include "atom/browser/net/web_request_rules.h"
 #include "base/callback.h"
 #include "base/memory/weak_ptr.h"
 #include "base/synchronization/lock.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "brightray/browser/network_delegate.h"
 #include "content/public/browser/resource_request_info.h"
@@ -30,8 +35,10 @@ const char* ResourceTypeToString(content::ResourceType type);
 class AtomNetworkDelegate : public brightray::NetworkDelegate {
  public:
   using ResponseCallback = base::Callback<void(const base::DictionaryValue&)>;
-  using SimpleListener = base::Callback<void(const base::DictionaryValue&)>;
-  using ResponseListener = base::Callback<void(const base::DictionaryValue&,
+  using SimpleListener = base::Callback<void(const WebRequestDetails&)>;
+  using SimpleBatchListener =
+      base::Callback<void(const WebRequestDetailsList&)>;
+  using ResponseListener = base::Callback<void(const WebRequestDetails&,
                                                const ResponseCallback&)>;
 
   enum SimpleEvent {
@@ -48,13 +55,34 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
     kOnHeadersReceived,
   };
 
+  // How events of a batched simple listener are coalesced on the IO thread.
+  // A batch is delivered once it holds |max_size| events or |interval| after
+  // its first event, whichever comes first.
+  struct BatchOptions {
+    base::TimeDelta interval;
+    size_t max_size;
+  };
+
+  struct BatchStats {
+    // Events queued for batched delivery.
+    uint64_t batched;
+    // Events handed to JS.
+    uint64_t delivered;
+    // Events discarded because JS fell behind, or because their listener
+    // was replaced or removed before they were delivered.
+    uint64_t dropped;
+  };
+
   struct SimpleListenerInfo {
-    URLPatterns url_patterns;
+    URLPatternMatcher url_patterns;
     SimpleListener listener;
+    // Used instead of |listener| when the events are batched.
+    SimpleBatchListener batch_listener;
+    BatchOptions batch_options;
   };
 
   struct ResponseListenerInfo {
-    URLPatterns url_patterns;
+    URLPatternMatcher url_patterns;
     ResponseListener listener;
   };
 
@@ -64,9 +92,15 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
   void SetSimpleListenerInIO(SimpleEvent type,
                              const URLPatterns& patterns,
                              const SimpleListener& callback);
+  void SetSimpleBatchListenerInIO(SimpleEvent type,
+                                  const URLPatterns& patterns,
+                                  const BatchOptions& options,
+                                  const SimpleBatchListener& callback);
   void SetResponseListenerInIO(ResponseEvent type,
                                const URLPatterns& patterns,
                                const ResponseListener& callback);
+  void SetRulesInIO(const std::vector<WebRequestRule>& rules);
+  BatchStats GetBatchStatsInIO() const;
 
   void SetDevToolsNetworkEmulationClientId(const std::string& client_id);
 
@@ -95,6 +129,8 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
   void OnURLRequestDestroyed(net::URLRequest* request) override;
 
  private:
+  struct EventBatch;
+
   void OnErrorOccurred(net::URLRequest* request, bool started, int net_error);
 
   template<typename...Args>
@@ -108,6 +144,19 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
                           Out out,
                           Args... args);
 
+  // Queues |details| for the batched listener of |type|.
+  void AddToBatch(SimpleEvent type,
+                  std::unique_ptr<WebRequestDetails> details,
+                  int frame_tree_node_id,
+                  int render_frame_id,
+                  int render_process_id);
+  // Posts the pending events of |type| to the UI thread, unless too many
+  // batches are still waiting to be delivered.
+  void FlushBatch(SimpleEvent type);
+  // Throws away the pending events of |type|, counting them as dropped.
+  void DiscardBatch(SimpleEvent type);
+  void OnBatchDeliveredInIO(size_t count);
+
   // Deal with the results of Listener.
   template<typename T>
   void OnListenerResultInIO(
@@ -121,6 +170,13 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
   std::map<ResponseEvent, ResponseListenerInfo> response_listeners_;
   std::map<uint64_t, net::CompletionCallback> callbacks_;
 
+  std::map<SimpleEvent, std::unique_ptr<EventBatch>> batches_;
+  size_t batches_in_flight_;
+  BatchStats batch_stats_;
+
+  // Declarative rules, applied before any listener is consulted.
+  WebRequestRules rules_;
+
   base::Lock lock_;
 
   base::WeakPtrFactory<AtomNetworkDelegate> weak_factory_;
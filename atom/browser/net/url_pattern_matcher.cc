@@ -0,0 +1,101 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/url_pattern_matcher.h"
+
+#include "base/strings/string_util.h"
+#include "url/gurl.h"
+
+namespace atom {
+
+namespace {
+
+// Bucket keys and probed hosts go through the same normalization, so a
+// fully qualified "example.com." lands in the same bucket as "example.com".
+std::string NormalizeHost(const std::string& host) {
+  std::string normalized = base::ToLowerASCII(host);
+  if (base::EndsWith(normalized, ".", base::CompareCase::SENSITIVE))
+    normalized.pop_back();
+  return normalized;
+}
+
+}  // namespace
+
+URLPatternMatcher::URLPatternMatcher() : size_(0) {
+}
+
+URLPatternMatcher::URLPatternMatcher(const std::set<URLPattern>& patterns)
+    : size_(patterns.size()) {
+  for (const auto& pattern : patterns) {
+    const std::string& host = pattern.host();
+    // IP literals and the like are rare, leave them to the slow path rather
+    // than second-guessing URLPattern's host canonicalization.
+    std::string key = NormalizeHost(host);
+    if (pattern.match_all_urls() || key.empty() ||
+        key.find_first_of("[]:*") != std::string::npos) {
+      generic_.push_back(pattern);
+    } else if (pattern.match_subdomains()) {
+      subdomain_hosts_[key].push_back(pattern);
+    } else {
+      exact_hosts_[key].push_back(pattern);
+    }
+  }
+}
+
+URLPatternMatcher::URLPatternMatcher(const URLPatternMatcher& other) = default;
+
+URLPatternMatcher::~URLPatternMatcher() {
+}
+
+URLPatternMatcher& URLPatternMatcher::operator=(
+    const URLPatternMatcher& other) = default;
+
+// static
+bool URLPatternMatcher::MatchesAny(const PatternList& patterns,
+                                   const GURL& url) {
+  for (const auto& pattern : patterns) {
+    if (pattern.MatchesURL(url))
+      return true;
+  }
+  return false;
+}
+
+// static
+bool URLPatternMatcher::MatchesHost(const HostMap& hosts,
+                                    const std::string& host,
+                                    const GURL& url) {
+  auto it = hosts.find(host);
+  return it != hosts.end() && MatchesAny(it->second, url);
+}
+
+bool URLPatternMatcher::MatchesURL(const GURL& url) const {
+  if (is_empty())
+    return true;
+
+  if (MatchesAny(generic_, url))
+    return true;
+
+  std::string host = NormalizeHost(url.host());
+  if (host.empty())
+    return false;
+
+  if (MatchesHost(exact_hosts_, host, url))
+    return true;
+
+  if (subdomain_hosts_.empty())
+    return false;
+
+  // Try "a.b.c", then "b.c", then "c".
+  size_t pos = 0;
+  while (true) {
+    if (MatchesHost(subdomain_hosts_, host.substr(pos), url))
+      return true;
+    pos = host.find('.', pos);
+    if (pos == std::string::npos)
+      return false;
+    ++pos;
+  }
+}
+
+}  // namespace atom
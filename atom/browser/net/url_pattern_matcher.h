@@ -0,0 +1,64 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_URL_PATTERN_MATCHER_H_
+#define ATOM_BROWSER_NET_URL_PATTERN_MATCHER_H_
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "extensions/common/url_pattern.h"
+
+class GURL;
+
+namespace atom {
+
+// A set of URLPatterns compiled for fast matching.
+//
+// Patterns are bucketed by host: patterns for an exact host are found with a
+// single hash lookup, and "*.host" patterns are found by looking up each
+// dot-separated suffix of the URL's host. Only the patterns in the matching
+// buckets, plus those without a host, are tested with URLPattern::MatchesURL,
+// so matching cost does not grow with the number of patterns for unrelated
+// hosts.
+class URLPatternMatcher {
+ public:
+  URLPatternMatcher();
+  explicit URLPatternMatcher(const std::set<URLPattern>& patterns);
+  URLPatternMatcher(const URLPatternMatcher& other);
+  ~URLPatternMatcher();
+
+  URLPatternMatcher& operator=(const URLPatternMatcher& other);
+
+  // Whether |url| matches any of the patterns. An empty matcher matches
+  // everything.
+  bool MatchesURL(const GURL& url) const;
+
+  bool is_empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+ private:
+  using PatternList = std::vector<URLPattern>;
+  using HostMap = std::unordered_map<std::string, PatternList>;
+
+  static bool MatchesAny(const PatternList& patterns, const GURL& url);
+  static bool MatchesHost(const HostMap& hosts,
+                          const std::string& host,
+                          const GURL& url);
+
+  // Patterns for exactly one host.
+  HostMap exact_hosts_;
+  // "*.host" patterns, keyed by host.
+  HostMap subdomain_hosts_;
+  // Patterns that can not be keyed by host, e.g. <all_urls> or "*://*/*".
+  PatternList generic_;
+
+  size_t size_;
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_URL_PATTERN_MATCHER_H_
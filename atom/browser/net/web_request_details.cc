@@ -0,0 +1,133 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/web_request_details.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "atom/common/native_mate_converters/value_converter.h"
+#include "base/strings/string_split.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+
+namespace {
+
+v8::Local<v8::String> RawToV8(v8::Isolate* isolate, const std::string& raw) {
+  // Headers are bytes, not UTF-8, so keep them as one-byte strings.
+  return v8::String::NewFromOneByte(
+      isolate, reinterpret_cast<const uint8_t*>(raw.data()),
+      v8::NewStringType::kNormal, static_cast<int>(raw.size()))
+      .ToLocalChecked();
+}
+
+std::string RawFromV8(v8::Local<v8::Value> value) {
+  v8::Local<v8::String> string = value.As<v8::String>();
+  std::string raw(string->Length(), '\0');
+  if (!raw.empty())
+    string->WriteOneByte(reinterpret_cast<uint8_t*>(&raw[0]));
+  return raw;
+}
+
+void GetRequestHeaders(v8::Local<v8::Name> property,
+                       const v8::PropertyCallbackInfo<v8::Value>& info) {
+  std::vector<std::string> lines = base::SplitString(
+      RawFromV8(info.Data()), "\n", base::KEEP_WHITESPACE,
+      base::SPLIT_WANT_ALL);
+  base::DictionaryValue dict;
+  for (size_t i = 0; i + 1 < lines.size(); i += 2)
+    dict.SetKey(lines[i], base::Value(lines[i + 1]));
+  info.GetReturnValue().Set(mate::ConvertToV8(info.GetIsolate(), dict));
+}
+
+void GetResponseHeaders(v8::Local<v8::Name> property,
+                        const v8::PropertyCallbackInfo<v8::Value>& info) {
+  scoped_refptr<net::HttpResponseHeaders> headers(
+      new net::HttpResponseHeaders(RawFromV8(info.Data())));
+  base::DictionaryValue dict;
+  size_t iter = 0;
+  std::string key;
+  std::string value;
+  while (headers->EnumerateHeaderLines(&iter, &key, &value)) {
+    if (dict.HasKey(key)) {
+      base::ListValue* values = nullptr;
+      if (dict.GetList(key, &values))
+        values->AppendString(value);
+    } else {
+      std::unique_ptr<base::ListValue> values(new base::ListValue);
+      values->AppendString(value);
+      dict.Set(key, std::move(values));
+    }
+  }
+  info.GetReturnValue().Set(mate::ConvertToV8(info.GetIsolate(), dict));
+}
+
+}  // namespace
+
+namespace atom {
+
+WebRequestDetails::WebRequestDetails()
+    : has_request_headers(false), has_response_headers(false) {
+}
+
+WebRequestDetails::~WebRequestDetails() {
+}
+
+void WebRequestDetails::SetRequestHeaders(
+    const net::HttpRequestHeaders& headers) {
+  has_request_headers = true;
+  raw_request_headers.clear();
+  net::HttpRequestHeaders::Iterator it(headers);
+  while (it.GetNext()) {
+    raw_request_headers.append(it.name());
+    raw_request_headers.push_back('\n');
+    raw_request_headers.append(it.value());
+    raw_request_headers.push_back('\n');
+  }
+}
+
+void WebRequestDetails::SetResponseHeaders(
+    const net::HttpResponseHeaders& headers) {
+  has_response_headers = true;
+  raw_response_headers = headers.raw_headers();
+}
+
+}  // namespace atom
+
+namespace mate {
+
+// static
+v8::Local<v8::Value> Converter<atom::WebRequestDetails>::ToV8(
+    v8::Isolate* isolate, const atom::WebRequestDetails& val) {
+  v8::Local<v8::Object> details =
+      ConvertToV8(isolate, val.fields).As<v8::Object>();
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+  // Lazy data properties turn into plain data properties on first access, so
+  // listeners can still modify and return the headers object.
+  if (val.has_request_headers) {
+    details->SetLazyDataProperty(
+        context, StringToV8(isolate, "requestHeaders"), GetRequestHeaders,
+        RawToV8(isolate, val.raw_request_headers)).FromJust();
+  }
+  if (val.has_response_headers) {
+    details->SetLazyDataProperty(
+        context, StringToV8(isolate, "responseHeaders"), GetResponseHeaders,
+        RawToV8(isolate, val.raw_response_headers)).FromJust();
+  }
+  return details;
+}
+
+// static
+v8::Local<v8::Value> Converter<atom::WebRequestDetailsList>::ToV8(
+    v8::Isolate* isolate, const atom::WebRequestDetailsList& val) {
+  v8::Local<v8::Array> result = v8::Array::New(isolate, val.size());
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  for (size_t i = 0; i < val.size(); ++i)
+    result->Set(context, i, ConvertToV8(isolate, *val[i])).FromJust();
+  return result;
+}
+
+}  // namespace mate
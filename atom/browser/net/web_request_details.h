@@ -0,0 +1,71 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_WEB_REQUEST_DETAILS_H_
+#define ATOM_BROWSER_NET_WEB_REQUEST_DETAILS_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/values.h"
+#include "native_mate/converter.h"
+
+namespace net {
+class HttpRequestHeaders;
+class HttpResponseHeaders;
+}
+
+namespace atom {
+
+// The details object passed to webRequest listeners.
+//
+// Scalar fields are captured on the IO thread into |fields|. Request and
+// response headers are only snapshotted in their raw form; they are parsed
+// into objects on the UI thread the first time JS reads
+// |details.requestHeaders| or |details.responseHeaders|, so listeners that
+// never look at headers don't pay for them.
+struct WebRequestDetails {
+  WebRequestDetails();
+  ~WebRequestDetails();
+
+  void SetRequestHeaders(const net::HttpRequestHeaders& headers);
+  void SetResponseHeaders(const net::HttpResponseHeaders& headers);
+
+  base::DictionaryValue fields;
+
+  bool has_request_headers;
+  // "name\nvalue\n" pairs, header names and values can't contain '\n'.
+  std::string raw_request_headers;
+
+  bool has_response_headers;
+  // In the format of net::HttpResponseHeaders::raw_headers().
+  std::string raw_response_headers;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(WebRequestDetails);
+};
+
+using WebRequestDetailsList = std::vector<std::unique_ptr<WebRequestDetails>>;
+
+}  // namespace atom
+
+namespace mate {
+
+template<>
+struct Converter<atom::WebRequestDetails> {
+  static v8::Local<v8::Value> ToV8(v8::Isolate* isolate,
+                                   const atom::WebRequestDetails& val);
+};
+
+template<>
+struct Converter<atom::WebRequestDetailsList> {
+  static v8::Local<v8::Value> ToV8(v8::Isolate* isolate,
+                                   const atom::WebRequestDetailsList& val);
+};
+
+}  // namespace mate
+
+#endif  // ATOM_BROWSER_NET_WEB_REQUEST_DETAILS_H_
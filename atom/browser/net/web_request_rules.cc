@@ -0,0 +1,122 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/web_request_rules.h"
+
+#include "atom/browser/net/atom_network_delegate.h"
+#include "content/public/browser/resource_request_info.h"
+#include "net/http/http_request_headers.h"
+#include "net/url_request/url_request.h"
+#include "url/url_constants.h"
+
+namespace atom {
+
+namespace {
+
+// Returns the secure counterpart of |url|, or an empty GURL if it has none.
+GURL UpgradeScheme(const GURL& url) {
+  const char* scheme = nullptr;
+  if (url.SchemeIs(url::kHttpScheme))
+    scheme = url::kHttpsScheme;
+  else if (url.SchemeIs(url::kWsScheme))
+    scheme = url::kWssScheme;
+  else
+    return GURL();
+
+  GURL::Replacements replacements;
+  replacements.SetSchemeStr(scheme);
+  return url.ReplaceComponents(replacements);
+}
+
+}  // namespace
+
+WebRequestRule::WebRequestRule() : action(kBlock) {
+}
+
+WebRequestRule::WebRequestRule(const WebRequestRule& other) = default;
+
+WebRequestRule::~WebRequestRule() {
+}
+
+WebRequestRules::WebRequestRules() : has_header_rules_(false) {
+}
+
+WebRequestRules::~WebRequestRules() {
+}
+
+void WebRequestRules::SetRules(const std::vector<WebRequestRule>& rules) {
+  rules_ = rules;
+  has_header_rules_ = false;
+  for (const auto& rule : rules_) {
+    if (rule.action == WebRequestRule::kModifyHeaders)
+      has_header_rules_ = true;
+  }
+}
+
+// static
+bool WebRequestRules::Matches(const WebRequestRule& rule,
+                              net::URLRequest* request) {
+  if (!rule.url_patterns.MatchesURL(request->url()))
+    return false;
+
+  if (!rule.resource_types.empty()) {
+    auto info = content::ResourceRequestInfo::ForRequest(request);
+    const char* type =
+        info ? ResourceTypeToString(info->GetResourceType()) : "other";
+    if (!rule.resource_types.count(type))
+      return false;
+  }
+
+  return rule.first_party_patterns.MatchesURL(request->site_for_cookies());
+}
+
+WebRequestRules::Result WebRequestRules::EvaluateRequest(
+    net::URLRequest* request, GURL* new_url) const {
+  for (const auto& rule : rules_) {
+    if (rule.action == WebRequestRule::kModifyHeaders ||
+        !Matches(rule, request))
+      continue;
+
+    switch (rule.action) {
+      case WebRequestRule::kBlock:
+        return kBlocked;
+      case WebRequestRule::kRedirect:
+        // Don't loop on a rule that redirects to a URL it matches itself.
+        if (!rule.redirect_url.is_valid() ||
+            rule.redirect_url == request->url())
+          continue;
+        *new_url = rule.redirect_url;
+        return kRedirected;
+      case WebRequestRule::kUpgradeScheme: {
+        GURL upgraded = UpgradeScheme(request->url());
+        if (!upgraded.is_valid())
+          continue;
+        *new_url = upgraded;
+        return kRedirected;
+      }
+      case WebRequestRule::kModifyHeaders:
+        break;
+    }
+  }
+  return kNoMatch;
+}
+
+void WebRequestRules::ApplyHeaderRules(
+    net::URLRequest* request, net::HttpRequestHeaders* headers) const {
+  if (!has_header_rules_)
+    return;
+
+  for (const auto& rule : rules_) {
+    if (rule.action != WebRequestRule::kModifyHeaders ||
+        !Matches(rule, request))
+      continue;
+
+    for (const auto& name : rule.remove_request_headers)
+      headers->RemoveHeader(name);
+    for (const auto& header : rule.set_request_headers)
+      headers->SetHeader(header.first, header.second);
+  }
+}
+
+}  // namespace atom
@@ -0,0 +1,87 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_WEB_REQUEST_RULES_H_
+#define ATOM_BROWSER_NET_WEB_REQUEST_RULES_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "atom/browser/net/url_pattern_matcher.h"
+#include "base/macros.h"
+#include "url/gurl.h"
+
+namespace net {
+class HttpRequestHeaders;
+class URLRequest;
+}
+
+namespace atom {
+
+// A declarative webRequest rule, evaluated natively on the IO thread so
+// static block/redirect lists don't need a round trip to JS.
+struct WebRequestRule {
+  enum Action {
+    kBlock,
+    kRedirect,
+    kUpgradeScheme,
+    kModifyHeaders,
+  };
+
+  WebRequestRule();
+  WebRequestRule(const WebRequestRule& other);
+  ~WebRequestRule();
+
+  Action action;
+
+  // Conditions, an empty condition matches every request.
+  URLPatternMatcher url_patterns;
+  std::set<std::string> resource_types;
+  URLPatternMatcher first_party_patterns;
+
+  // For kRedirect.
+  GURL redirect_url;
+
+  // For kModifyHeaders.
+  std::map<std::string, std::string> set_request_headers;
+  std::vector<std::string> remove_request_headers;
+};
+
+// An ordered list of WebRequestRules.
+class WebRequestRules {
+ public:
+  enum Result {
+    kNoMatch,
+    kBlocked,
+    kRedirected,
+  };
+
+  WebRequestRules();
+  ~WebRequestRules();
+
+  void SetRules(const std::vector<WebRequestRule>& rules);
+  bool empty() const { return rules_.empty(); }
+
+  // Applies the first matching block, redirect or upgrade rule to |request|.
+  // |new_url| is set when the result is kRedirected.
+  Result EvaluateRequest(net::URLRequest* request, GURL* new_url) const;
+
+  // Applies every matching header rule to |headers|.
+  void ApplyHeaderRules(net::URLRequest* request,
+                        net::HttpRequestHeaders* headers) const;
+
+ private:
+  static bool Matches(const WebRequestRule& rule, net::URLRequest* request);
+
+  std::vector<WebRequestRule> rules_;
+  bool has_header_rules_;
+
+  DISALLOW_COPY_AND_ASSIGN(WebRequestRules);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_WEB_REQUEST_RULES_H_
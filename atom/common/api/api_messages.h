@@ -4,6 +4,10 @@
 
 // Multiply-included file, no traditional include guard.
 
+#include <stdint.h>
+
+#include <vector>
+
 #include "base/strings/string16.h"
 #include "base/memory/shared_memory.h"
 #include "base/values.h"
@@ -33,15 +37,91 @@ IPC_MESSAGE_ROUTED2(AtomViewMsg_Message,
                     base::string16 /* channel */,
                     base::ListValue /* arguments */)
 
+// Like AtomViewHostMsg_Message/AtomViewMsg_Message, with the arguments array
+// serialized by v8::ValueSerializer
+IPC_MESSAGE_ROUTED2(AtomViewHostMsg_Message_Cloned,
+                    base::string16 /* channel */,
+                    std::vector<uint8_t> /* serialized arguments */)
+
+IPC_MESSAGE_ROUTED2(AtomViewMsg_Message_Cloned,
+                    base::string16 /* channel */,
+                    std::vector<uint8_t> /* serialized arguments */)
+
 IPC_MESSAGE_ROUTED2(AtomViewMsg_Message_Shared,
                     base::string16 /* channel */,
                     base::SharedMemoryHandle /* arguments */)
 
+// Map the shared memory ring |ring id| written by the sender
+IPC_MESSAGE_ROUTED3(AtomViewHostMsg_SetupRing,
+                    int /* ring id */,
+                    base::SharedMemoryHandle /* ring memory */,
+                    uint32_t /* capacity */)
+
+// Map the shared memory ring |ring id| to write messages to the sender in
+IPC_MESSAGE_ROUTED3(AtomViewHostMsg_SetupBrowserRing,
+                    int /* ring id */,
+                    base::SharedMemoryHandle /* ring memory */,
+                    uint32_t /* capacity */)
+
+// The script context at the other end of ring |ring id| is gone
+IPC_MESSAGE_ROUTED1(AtomViewHostMsg_CloseRing,
+                    int /* ring id */)
+
+// A message written in place in a shared memory ring
+IPC_MESSAGE_ROUTED5(AtomViewHostMsg_Message_Ring,
+                    int /* ring id */,
+                    base::string16 /* channel */,
+                    uint64_t /* sequence */,
+                    uint64_t /* position */,
+                    uint32_t /* size */)
+
+IPC_MESSAGE_ROUTED5(AtomViewMsg_Message_Ring,
+                    int /* ring id */,
+                    base::string16 /* channel */,
+                    uint64_t /* sequence */,
+                    uint64_t /* position */,
+                    uint32_t /* size */)
+
+// Hand a message port to the frame
+IPC_MESSAGE_ROUTED1(AtomViewMsg_ConnectPort,
+                    int /* port id */)
+
+// A message for a port of the frame
+IPC_MESSAGE_ROUTED3(AtomViewMsg_PortMessage,
+                    int /* port id */,
+                    std::vector<uint8_t> /* serialized value */,
+                    std::vector<std::vector<uint8_t>> /* array buffers */)
+
+// The other end closed the channel of a port of the frame
+IPC_MESSAGE_ROUTED1(AtomViewMsg_PortClosed,
+                    int /* port id */)
+
+// A message posted on a port of the frame, sent to the other end
+IPC_MESSAGE_ROUTED3(AtomViewHostMsg_PortMessage,
+                    int /* port id */,
+                    std::vector<uint8_t> /* serialized value */,
+                    std::vector<std::vector<uint8_t>> /* array buffers */)
+
+// Close the channel of a port of the frame
+IPC_MESSAGE_ROUTED1(AtomViewHostMsg_ClosePort,
+                    int /* port id */)
+
 // Update renderer process preferences.
 IPC_MESSAGE_CONTROL1(AtomMsg_UpdatePreferences, base::ListValue)
 
-// Update renderer content settings
-IPC_MESSAGE_CONTROL1(AtomMsg_UpdateContentSettings, base::DictionaryValue)
+// Replace the renderer content settings
+IPC_MESSAGE_CONTROL2(AtomMsg_UpdateContentSettings,
+                     base::DictionaryValue /* content settings */,
+                     uint64_t /* version */)
+
+// Apply add/remove/replace rule operations to the renderer content settings
+IPC_MESSAGE_CONTROL3(AtomMsg_UpdateContentSettingsDelta,
+                     uint64_t /* base version */,
+                     uint64_t /* version */,
+                     base::ListValue /* operations */)
+
+// Ask for the full content settings, the renderer is out of sync
+IPC_MESSAGE_CONTROL0(AtomHostMsg_RequestContentSettings)
 
 // Update renderer content settings
 IPC_MESSAGE_CONTROL1(AtomMsg_UpdateWebKitPrefs, content::WebPreferences)
@@ -10,22 +10,30 @@
 #include "atom/common/api/atom_api_native_image.h"
 
 #include "atom/common/asar/asar_util.h"
+#include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gfx_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
-#include "base/base64.h"
+#include "atom/common/native_mate_converters/image_converter.h"
 #include "base/files/file_util.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/numerics/safe_math.h"
 #include "base/strings/pattern.h"
 #include "base/strings/string_util.h"
+#include "base/task_scheduler/post_task.h"
+#include "base/threading/thread_task_runner_handle.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
 #include "net/base/data_url.h"
+#include "skia/ext/image_operations.h"
+#include "third_party/modp_b64/modp_b64.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
 #include "ui/base/layout.h"
 #include "ui/gfx/codec/jpeg_codec.h"
 #include "ui/gfx/codec/png_codec.h"
 #include "ui/gfx/geometry/size.h"
 #include "ui/gfx/image/image_skia.h"
+#include "ui/gfx/image/image_skia_rep.h"
 #include "ui/gfx/image/image_util.h"
 
 #if defined(OS_WIN)
@@ -38,6 +46,32 @@
 
 #include "base/threading/thread_restrictions.h"
 
+namespace mate {
+
+// Hands encoded bytes to JS as a Buffer backed by them, without a copy. The
+// Buffer holds a reference until it is collected. JS can write to it, so the
+// bytes must not be shared with anything else.
+template<>
+struct Converter<scoped_refptr<base::RefCountedMemory>> {
+  static v8::Local<v8::Value> ToV8(
+      v8::Isolate* isolate,
+      const scoped_refptr<base::RefCountedMemory>& val) {
+    if (!val || !val->size())
+      return node::Buffer::New(isolate, 0).ToLocalChecked();
+    val->AddRef();
+    return node::Buffer::New(isolate, const_cast<char*>(val->front_as<char>()),
+                             val->size(), &Release, val.get())
+        .ToLocalChecked();
+  }
+
+ private:
+  static void Release(char* data, void* hint) {
+    static_cast<base::RefCountedMemory*>(hint)->Release();
+  }
+};
+
+}  // namespace mate
+
 namespace atom {
 
 namespace api {
@@ -78,7 +112,11 @@ float GetScaleFactorFromPath(const base::FilePath& path) {
   return 1.0f;
 }
 
-bool AddImageSkiaRep(gfx::ImageSkia* image,
+// Decoded representations, which unlike gfx::ImageSkia may be built on one
+// thread and used on another.
+using ImageSkiaReps = std::vector<gfx::ImageSkiaRep>;
+
+bool AddImageSkiaRep(ImageSkiaReps* reps,
                      const unsigned char* data,
                      size_t size,
                      double scale_factor) {
@@ -92,11 +130,11 @@ bool AddImageSkiaRep(gfx::ImageSkia* image,
   if (!decoded)
     return false;
 
-  image->AddRepresentation(gfx::ImageSkiaRep(*decoded, scale_factor));
+  reps->push_back(gfx::ImageSkiaRep(*decoded, scale_factor));
   return true;
 }
 
-bool AddImageSkiaRep(gfx::ImageSkia* image,
+bool AddImageSkiaRep(ImageSkiaReps* reps,
                      const base::FilePath& path,
                      double scale_factor) {
   std::string file_contents;
@@ -109,26 +147,33 @@ bool AddImageSkiaRep(gfx::ImageSkia* image,
   const unsigned char* data =
       reinterpret_cast<const unsigned char*>(file_contents.data());
   size_t size = file_contents.size();
-  return AddImageSkiaRep(image, data, size, scale_factor);
+  return AddImageSkiaRep(reps, data, size, scale_factor);
 }
 
-bool PopulateImageSkiaRepsFromPath(gfx::ImageSkia* image,
+bool PopulateImageSkiaRepsFromPath(ImageSkiaReps* reps,
                                    const base::FilePath& path) {
   bool succeed = false;
   std::string filename(path.BaseName().RemoveExtension().AsUTF8Unsafe());
   if (base::MatchPattern(filename, "*@*x"))
     // Don't search for other representations if the DPI has been specified.
-    return AddImageSkiaRep(image, path, GetScaleFactorFromPath(path));
+    return AddImageSkiaRep(reps, path, GetScaleFactorFromPath(path));
   else
-    succeed |= AddImageSkiaRep(image, path, 1.0f);
+    succeed |= AddImageSkiaRep(reps, path, 1.0f);
 
   for (const ScaleFactorPair& pair : kScaleFactorPairs)
-    succeed |= AddImageSkiaRep(image,
+    succeed |= AddImageSkiaRep(reps,
                                path.InsertBeforeExtensionASCII(pair.name),
                                pair.scale);
   return succeed;
 }
 
+gfx::Image ImageFromReps(const ImageSkiaReps& reps) {
+  gfx::ImageSkia image_skia;
+  for (const gfx::ImageSkiaRep& rep : reps)
+    image_skia.AddRepresentation(rep);
+  return gfx::Image(image_skia);
+}
+
 base::FilePath NormalizePath(const base::FilePath& path) {
   if (!path.ReferencesParent()) {
     return path;
@@ -180,9 +225,206 @@ bool ReadImageSkiaFromICO(gfx::ImageSkia* image, HICON icon) {
 }
 #endif
 
-void Noop(char*, void*) {
+void ReleasePixelRef(char* data, void* hint) {
+  static_cast<SkPixelRef*>(hint)->unref();
+}
+
+const char kPNGDataURLPrefix[] = "data:image/png;base64,";
+
+// Base64-encodes |png| straight into the data URL, which is sized once up
+// front.
+std::string PNGToDataURL(const scoped_refptr<base::RefCountedMemory>& png) {
+  std::string data_url(kPNGDataURLPrefix);
+  if (png && png->size()) {
+    size_t prefix_size = data_url.size();
+    data_url.resize(prefix_size + modp_b64_encode_len(png->size()));
+    size_t encoded_size = modp_b64_encode(
+        &data_url[prefix_size], png->front_as<char>(), png->size());
+    data_url.resize(prefix_size + encoded_size);
+  }
+  return data_url;
+}
+
+// Lets V8 use a data URL in place instead of copying it to its heap.
+class ExternalDataURL : public v8::String::ExternalOneByteStringResource {
+ public:
+  explicit ExternalDataURL(std::string data_url)
+      : data_url_(std::move(data_url)) {}
+
+  const char* data() const override { return data_url_.data(); }
+  size_t length() const override { return data_url_.size(); }
+
+ private:
+  const std::string data_url_;
+
+  DISALLOW_COPY_AND_ASSIGN(ExternalDataURL);
+};
+
+// Encoding, decoding and resizing run on the task scheduler. Only SkBitmaps
+// and ImageSkiaReps cross threads, the gfx::Image is built back on the thread
+// that asked for it.
+constexpr base::TaskTraits kImageTaskTraits = {
+    base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+    base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN};
+
+// Largest resize target, in pixels. Larger sizes are rejected before any
+// bitmap is allocated.
+constexpr int kMaxResizePixels = 16384 * 16384;
+
+ImageSkiaReps DecodeBuffer(const std::string& data, double scale_factor) {
+  ImageSkiaReps reps;
+  AddImageSkiaRep(&reps, reinterpret_cast<const unsigned char*>(data.data()),
+                  data.size(), scale_factor);
+  return reps;
+}
+
+ImageSkiaReps DecodePath(const base::FilePath& path) {
+  ImageSkiaReps reps;
+#if defined(OS_WIN)
+  // Only the largest icon is kept, there is no HICON to go back to later.
+  if (path.MatchesExtension(FILE_PATH_LITERAL(".ico"))) {
+    base::win::ScopedHICON icon = ReadICOFromPath(256, path);
+    std::unique_ptr<SkBitmap> bitmap(
+        IconUtil::CreateSkBitmapFromHICON(icon.get()));
+    if (bitmap)
+      reps.push_back(gfx::ImageSkiaRep(*bitmap, 1.0f));
+    return reps;
+  }
+#endif
+  PopulateImageSkiaRepsFromPath(&reps, path);
+  return reps;
+}
+
+// gfx::Image::AsBitmap() does not accept empty images.
+SkBitmap Get1xBitmap(const gfx::Image& image) {
+  return image.IsEmpty() ? SkBitmap() : image.AsBitmap();
+}
+
+scoped_refptr<base::RefCountedMemory> EncodePNG(const SkBitmap& bitmap) {
+  std::vector<unsigned char> output;
+  if (bitmap.drawsNothing() ||
+      !gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &output))
+    return nullptr;
+  return base::RefCountedBytes::TakeVector(&output);
+}
+
+scoped_refptr<base::RefCountedMemory> EncodeJPEG(const SkBitmap& bitmap,
+                                                 int quality) {
+  std::vector<unsigned char> output;
+  if (bitmap.drawsNothing() ||
+      !gfx::JPEGCodec::Encode(bitmap, quality, &output))
+    return nullptr;
+  return base::RefCountedBytes::TakeVector(&output);
+}
+
+std::string EncodeDataURL(const SkBitmap& bitmap) {
+  return PNGToDataURL(EncodePNG(bitmap));
+}
+
+SkBitmap ResizeBitmap(const SkBitmap& bitmap,
+                      skia::ImageOperations::ResizeMethod method,
+                      const gfx::Size& size) {
+  if (bitmap.drawsNothing() || size.IsEmpty())
+    return SkBitmap();
+  return skia::ImageOperations::Resize(bitmap, method, size.width(),
+                                       size.height());
+}
+
+// Reads {width, height, quality} for resizing an image of |original| size.
+// A missing width or height keeps the aspect ratio.
+bool GetResizeOptions(const mate::Dictionary& options,
+                      const gfx::Size& original,
+                      gfx::Size* size,
+                      skia::ImageOperations::ResizeMethod* method) {
+  int width = 0;
+  int height = 0;
+  bool has_width = options.Get("width", &width);
+  bool has_height = options.Get("height", &height);
+  if ((!has_width && !has_height) || width < 0 || height < 0)
+    return false;
+
+  if (!has_width && original.height() > 0) {
+    base::CheckedNumeric<int> scaled(original.width());
+    if (!(scaled * height / original.height()).AssignIfValid(&width))
+      return false;
+  }
+  if (!has_height && original.width() > 0) {
+    base::CheckedNumeric<int> scaled(original.height());
+    if (!(scaled * width / original.width()).AssignIfValid(&height))
+      return false;
+  }
+
+  int pixels = 0;
+  if (!base::CheckMul(width, height).AssignIfValid(&pixels) ||
+      pixels > kMaxResizePixels)
+    return false;
+  *size = gfx::Size(width, height);
+
+  std::string quality("best");
+  options.Get("quality", &quality);
+  if (quality == "good")
+    *method = skia::ImageOperations::RESIZE_GOOD;
+  else if (quality == "better")
+    *method = skia::ImageOperations::RESIZE_BETTER;
+  else if (quality == "best")
+    *method = skia::ImageOperations::RESIZE_BEST;
+  else
+    return false;
+  return true;
+}
+
+void OnBufferDecoded(const NativeImage::ImageCallback& callback,
+                     const ImageSkiaReps& reps) {
+  callback.Run(ImageFromReps(reps));
 }
 
+void OnPathDecoded(const base::FilePath& path,
+                   const NativeImage::ImageCallback& callback,
+                   const ImageSkiaReps& reps) {
+  gfx::Image image = ImageFromReps(reps);
+#if defined(OS_MACOSX)
+  if (!image.IsEmpty() && IsTemplateFilename(path))
+    NativeImage::MarkAsTemplateImage(image);
+#endif
+  callback.Run(image);
+}
+
+void OnResized(const NativeImage::ImageCallback& callback,
+               const SkBitmap& bitmap) {
+  callback.Run(gfx::Image::CreateFrom1xBitmap(bitmap));
+}
+
+// Collects the results of NativeImage::ResizeBatch, on the calling thread.
+class ResizeBatchJob : public base::RefCounted<ResizeBatchJob> {
+ public:
+  ResizeBatchJob(size_t image_count,
+                 size_t size_count,
+                 const NativeImage::ImageBatchCallback& callback)
+      : results_(image_count, std::vector<gfx::Image>(size_count)),
+        pending_(image_count * size_count),
+        callback_(callback) {}
+
+  void OnResized(size_t image_index,
+                 size_t size_index,
+                 const SkBitmap& bitmap) {
+    results_[image_index][size_index] =
+        gfx::Image::CreateFrom1xBitmap(bitmap);
+    if (--pending_ == 0)
+      callback_.Run(results_);
+  }
+
+ private:
+  friend class base::RefCounted<ResizeBatchJob>;
+
+  ~ResizeBatchJob() {}
+
+  std::vector<std::vector<gfx::Image>> results_;
+  size_t pending_;
+  NativeImage::ImageBatchCallback callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResizeBatchJob);
+};
+
 }  // namespace
 
 NativeImage::NativeImage(v8::Isolate* isolate, const gfx::Image& image)
@@ -224,10 +466,15 @@ HICON NativeImage::GetHICON(int size) {
 #endif
 
 v8::Local<v8::Value> NativeImage::ToPNG(v8::Isolate* isolate) {
-  scoped_refptr<base::RefCountedMemory> png = image_.As1xPNGBytes();
-  return node::Buffer::Copy(isolate,
-                            reinterpret_cast<const char*>(png->front()),
-                            static_cast<size_t>(png->size())).ToLocalChecked();
+  if (image_.HasRepresentation(gfx::Image::kImageRepPNG)) {
+    // The PNG is cached in the image, which must not see writes to the Buffer.
+    scoped_refptr<base::RefCountedMemory> png = image_.As1xPNGBytes();
+    return node::Buffer::Copy(isolate,
+                              reinterpret_cast<const char*>(png->front()),
+                              static_cast<size_t>(png->size()))
+        .ToLocalChecked();
+  }
+  return mate::ConvertToV8(isolate, EncodePNG(Get1xBitmap(image_)));
 }
 
 v8::Local<v8::Value> NativeImage::ToBitmap(v8::Isolate* isolate) {
@@ -240,30 +487,79 @@ v8::Local<v8::Value> NativeImage::ToBitmap(v8::Isolate* isolate) {
 
 v8::Local<v8::Value> NativeImage::ToJPEG(v8::Isolate* isolate, int quality) {
   std::vector<unsigned char> output;
-  gfx::JPEG1xEncodedDataFromImage(image_, quality, &output);
-  return node::Buffer::Copy(
-      isolate,
-      reinterpret_cast<const char*>(&output.front()),
-      static_cast<size_t>(output.size())).ToLocalChecked();
+  if (!image_.IsEmpty())
+    gfx::JPEG1xEncodedDataFromImage(image_, quality, &output);
+  return mate::ConvertToV8(isolate,
+                           base::RefCountedBytes::TakeVector(&output));
+}
+
+void NativeImage::ToPNGAsync(const BufferCallback& callback) {
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE, kImageTaskTraits,
+      base::BindOnce(&EncodePNG, Get1xBitmap(image_)),
+      base::BindOnce(callback));
+}
+
+void NativeImage::ToJPEGAsync(int quality, const BufferCallback& callback) {
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE, kImageTaskTraits,
+      base::BindOnce(&EncodeJPEG, Get1xBitmap(image_), quality),
+      base::BindOnce(callback));
+}
+
+void NativeImage::ToDataURLAsync(const DataURLCallback& callback) {
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE, kImageTaskTraits,
+      base::BindOnce(&EncodeDataURL, Get1xBitmap(image_)),
+      base::BindOnce(callback));
+}
+
+void NativeImage::ResizeAsync(mate::Arguments* args,
+                              const mate::Dictionary& options,
+                              const ImageCallback& callback) {
+  gfx::Size size;
+  skia::ImageOperations::ResizeMethod method;
+  if (!GetResizeOptions(options, image_.Size(), &size, &method)) {
+    args->ThrowError("Invalid resize options");
+    return;
+  }
+
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE, kImageTaskTraits,
+      base::BindOnce(&ResizeBitmap, Get1xBitmap(image_), method, size),
+      base::BindOnce(&OnResized, callback));
 }
 
-std::string NativeImage::ToDataURL() {
-  scoped_refptr<base::RefCountedMemory> png = image_.As1xPNGBytes();
+v8::Local<v8::Value> NativeImage::ToDataURL(v8::Isolate* isolate) {
   std::string data_url;
-  data_url.insert(data_url.end(), png->front(), png->front() + png->size());
-  base::Base64Encode(data_url, &data_url);
-  data_url.insert(0, "data:image/png;base64,");
-  return data_url;
+  if (image_.HasRepresentation(gfx::Image::kImageRepPNG))
+    data_url = PNGToDataURL(image_.As1xPNGBytes());
+  else
+    data_url = EncodeDataURL(Get1xBitmap(image_));
+
+  ExternalDataURL* resource = new ExternalDataURL(std::move(data_url));
+  v8::Local<v8::String> result;
+  if (!v8::String::NewExternalOneByte(isolate, resource).ToLocal(&result)) {
+    delete resource;
+    isolate->ThrowException(v8::Exception::RangeError(
+        mate::StringToV8(isolate, "Image is too large for a data URL")));
+    return v8::Undefined(isolate);
+  }
+  return result;
 }
 
 v8::Local<v8::Value> NativeImage::GetBitmap(v8::Isolate* isolate) {
   const SkBitmap* bitmap = image_.ToSkBitmap();
   SkPixelRef* ref = bitmap->pixelRef();
+  if (!ref)
+    return node::Buffer::New(isolate, 0).ToLocalChecked();
+  // The Buffer keeps the pixels alive after the image is gone.
+  ref->ref();
   return node::Buffer::New(isolate,
                            reinterpret_cast<char*>(ref->pixels()),
                            bitmap->computeByteSize(),
-                           &Noop,
-                           nullptr).ToLocalChecked();
+                           &ReleasePixelRef,
+                           ref).ToLocalChecked();
 }
 
 v8::Local<v8::Value> NativeImage::GetNativeHandle(v8::Isolate* isolate,
@@ -334,10 +630,9 @@ mate::Handle<NativeImage> NativeImage::CreateFromPath(
                               new NativeImage(isolate, image_path));
   }
 #endif
-  gfx::ImageSkia image_skia;
-  PopulateImageSkiaRepsFromPath(&image_skia, image_path);
-  gfx::Image image(image_skia);
-  mate::Handle<NativeImage> handle = Create(isolate, image);
+  ImageSkiaReps reps;
+  PopulateImageSkiaRepsFromPath(&reps, image_path);
+  mate::Handle<NativeImage> handle = Create(isolate, ImageFromReps(reps));
 #if defined(OS_MACOSX)
   if (IsTemplateFilename(image_path))
     handle->SetTemplateImage(true);
@@ -351,12 +646,12 @@ mate::Handle<NativeImage> NativeImage::CreateFromBuffer(
   double scale_factor = 1.;
   args->GetNext(&scale_factor);
 
-  gfx::ImageSkia image_skia;
-  AddImageSkiaRep(&image_skia,
+  ImageSkiaReps reps;
+  AddImageSkiaRep(&reps,
                   reinterpret_cast<unsigned char*>(node::Buffer::Data(buffer)),
                   node::Buffer::Length(buffer),
                   scale_factor);
-  return Create(args->isolate(), gfx::Image(image_skia));
+  return Create(args->isolate(), ImageFromReps(reps));
 }
 
 // static
@@ -373,6 +668,76 @@ mate::Handle<NativeImage> NativeImage::CreateFromDataURL(
   return CreateEmpty(isolate);
 }
 
+// static
+void NativeImage::CreateFromPathAsync(const base::FilePath& path,
+                                      const ImageCallback& callback) {
+  base::FilePath image_path = NormalizePath(path);
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE, kImageTaskTraits, base::BindOnce(&DecodePath, image_path),
+      base::BindOnce(&OnPathDecoded, image_path, callback));
+}
+
+// static
+void NativeImage::CreateFromBufferAsync(mate::Arguments* args,
+                                        v8::Local<v8::Value> buffer) {
+  double scale_factor = 1.;
+  args->GetNext(&scale_factor);
+  ImageCallback callback;
+  if (!node::Buffer::HasInstance(buffer) || !args->GetNext(&callback)) {
+    args->ThrowError();
+    return;
+  }
+
+  // Copied, the Buffer may be changed or collected while we decode.
+  std::string data(node::Buffer::Data(buffer), node::Buffer::Length(buffer));
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE, kImageTaskTraits,
+      base::BindOnce(&DecodeBuffer, std::move(data), scale_factor),
+      base::BindOnce(&OnBufferDecoded, callback));
+}
+
+// static
+void NativeImage::ResizeBatch(mate::Arguments* args,
+                              const std::vector<gfx::Image>& images,
+                              const std::vector<mate::Dictionary>& options,
+                              const ImageBatchCallback& callback) {
+  if (images.empty() || options.empty()) {
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::Bind(callback, std::vector<std::vector<gfx::Image>>(
+                                            images.size())));
+    return;
+  }
+
+  // Check everything before posting anything, so a bad size fails the whole
+  // batch instead of leaving it waiting.
+  std::vector<std::vector<gfx::Size>> sizes(images.size());
+  std::vector<skia::ImageOperations::ResizeMethod> methods(options.size());
+  for (size_t i = 0; i < images.size(); ++i) {
+    for (size_t j = 0; j < options.size(); ++j) {
+      gfx::Size size;
+      if (!GetResizeOptions(options[j], images[i].Size(), &size,
+                            &methods[j])) {
+        args->ThrowError("Invalid resize options");
+        return;
+      }
+      sizes[i].push_back(size);
+    }
+  }
+
+  // One task per image and size, so the scheduler can use every core.
+  scoped_refptr<ResizeBatchJob> job(
+      new ResizeBatchJob(images.size(), options.size(), callback));
+  for (size_t i = 0; i < images.size(); ++i) {
+    SkBitmap bitmap = Get1xBitmap(images[i]);
+    for (size_t j = 0; j < options.size(); ++j) {
+      base::PostTaskWithTraitsAndReplyWithResult(
+          FROM_HERE, kImageTaskTraits,
+          base::BindOnce(&ResizeBitmap, bitmap, methods[j], sizes[i][j]),
+          base::BindOnce(&ResizeBatchJob::OnResized, job, i, j));
+    }
+  }
+}
+
 // static
 void NativeImage::BuildPrototype(
     v8::Isolate* isolate, v8::Local<v8::FunctionTemplate> prototype) {
@@ -384,6 +749,10 @@ void NativeImage::BuildPrototype(
       .SetMethod("getBitmap", &NativeImage::GetBitmap)
       .SetMethod("getNativeHandle", &NativeImage::GetNativeHandle)
       .SetMethod("toDataURL", &NativeImage::ToDataURL)
+      .SetMethod("toPNGAsync", &NativeImage::ToPNGAsync)
+      .SetMethod("toJPEGAsync", &NativeImage::ToJPEGAsync)
+      .SetMethod("toDataURLAsync", &NativeImage::ToDataURLAsync)
+      .SetMethod("resizeAsync", &NativeImage::ResizeAsync)
       .SetMethod("isEmpty", &NativeImage::IsEmpty)
       .SetMethod("getSize", &NativeImage::GetSize)
       .SetMethod("setTemplateImage", &NativeImage::SetTemplateImage)
@@ -437,6 +806,11 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   dict.SetMethod("createFromBuffer", &atom::api::NativeImage::CreateFromBuffer);
   dict.SetMethod("createFromDataURL",
                  &atom::api::NativeImage::CreateFromDataURL);
+  dict.SetMethod("createFromPathAsync",
+                 &atom::api::NativeImage::CreateFromPathAsync);
+  dict.SetMethod("createFromBufferAsync",
+                 &atom::api::NativeImage::CreateFromBufferAsync);
+  dict.SetMethod("resizeBatch", &atom::api::NativeImage::ResizeBatch);
 }
 
 }  // namespace
@@ -7,7 +7,10 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
 #include "native_mate/handle.h"
 #include "native_mate/wrappable.h"
 #include "ui/gfx/image/image.h"
@@ -21,6 +24,7 @@ class GURL;
 
 namespace base {
 class FilePath;
+class RefCountedMemory;
 }
 
 namespace gfx {
@@ -29,6 +33,7 @@ class Size;
 
 namespace mate {
 class Arguments;
+class Dictionary;
 }
 
 namespace atom {
@@ -37,6 +42,15 @@ namespace api {
 
 class NativeImage : public mate::Wrappable<NativeImage> {
  public:
+  // Results of the *Async methods, which do their work on the task scheduler
+  // and run the callback back on the calling thread.
+  using BufferCallback =
+      base::Callback<void(scoped_refptr<base::RefCountedMemory>)>;
+  using DataURLCallback = base::Callback<void(const std::string&)>;
+  using ImageCallback = base::Callback<void(const gfx::Image&)>;
+  using ImageBatchCallback =
+      base::Callback<void(const std::vector<std::vector<gfx::Image>>&)>;
+
   static mate::Handle<NativeImage> CreateEmpty(v8::Isolate* isolate);
   static mate::Handle<NativeImage> Create(
       v8::Isolate* isolate, const gfx::Image& image);
@@ -50,6 +64,22 @@ class NativeImage : public mate::Wrappable<NativeImage> {
       mate::Arguments* args, v8::Local<v8::Value> buffer);
   static mate::Handle<NativeImage> CreateFromDataURL(
       v8::Isolate* isolate, const GURL& url);
+  static void CreateFromPathAsync(const base::FilePath& path,
+                                  const ImageCallback& callback);
+  static void CreateFromBufferAsync(mate::Arguments* args,
+                                    v8::Local<v8::Value> buffer);
+
+  // Resizes every image in |images| to every size in |options|, spreading
+  // the work over the task scheduler.
+  static void ResizeBatch(mate::Arguments* args,
+                          const std::vector<gfx::Image>& images,
+                          const std::vector<mate::Dictionary>& options,
+                          const ImageBatchCallback& callback);
+
+#if defined(OS_MACOSX)
+  // Marks |image| as a template image before it is wrapped.
+  static void MarkAsTemplateImage(const gfx::Image& image);
+#endif
 
   static void BuildPrototype(v8::Isolate* isolate,
                              v8::Local<v8::FunctionTemplate> prototype);
@@ -75,7 +105,13 @@ class NativeImage : public mate::Wrappable<NativeImage> {
   v8::Local<v8::Value> GetNativeHandle(
     v8::Isolate* isolate,
     mate::Arguments* args);
-  std::string ToDataURL();
+  v8::Local<v8::Value> ToDataURL(v8::Isolate* isolate);
+  void ToPNGAsync(const BufferCallback& callback);
+  void ToJPEGAsync(int quality, const BufferCallback& callback);
+  void ToDataURLAsync(const DataURLCallback& callback);
+  void ResizeAsync(mate::Arguments* args,
+                   const mate::Dictionary& options,
+                   const ImageCallback& callback);
   bool IsEmpty();
   gfx::Size GetSize();
 
@@ -18,6 +18,11 @@ bool NativeImage::IsTemplateImage() {
   return [image_.AsNSImage() isTemplate];
 }
 
+// static
+void NativeImage::MarkAsTemplateImage(const gfx::Image& image) {
+  [image.AsNSImage() setTemplate:YES];
+}
+
 }  // namespace api
 
 }  // namespace atom
@@ -12,10 +12,24 @@ if (!ipcRenderer) {
     return ipc.send('ipc-message', $Array.slice(args))
   }
 
+  // Like send, with the arguments structured-cloned instead of converted to
+  // JSON, so typed arrays, ArrayBuffers, Maps and Dates arrive as they are.
+  ipcRenderer.sendCloned = function () {
+    var args
+    args = 1 <= arguments.length ? $Array.slice(arguments, 0) : []
+    return ipc.sendCloned('ipc-message', args)
+  }
+
   ipcRenderer.sendShared = function (channel, shared) {
     return ipc.sendShared(channel, shared)
   }
 
+  // Returns false without sending anything when the browser has not caught
+  // up with the previous messages yet.
+  ipcRenderer.sendRing = function (channel, value) {
+    return ipc.sendRing(channel, value)
+  }
+
   ipcRenderer.sendSync = function () {
     var args
     args = 1 <= arguments.length ? $Array.slice(arguments, 0) : []
@@ -55,7 +69,9 @@ exports.$set('on', ipcRenderer.on.bind(ipcRenderer))
 exports.$set('once', ipcRenderer.once.bind(ipcRenderer))
 exports.$set('send', ipcRenderer.send.bind(ipcRenderer))
 exports.$set('sendSync', ipcRenderer.sendSync.bind(ipcRenderer))
+exports.$set('sendCloned', ipcRenderer.sendCloned.bind(ipcRenderer))
 exports.$set('sendShared', ipcRenderer.sendShared.bind(ipcRenderer))
+exports.$set('sendRing', ipcRenderer.sendRing.bind(ipcRenderer))
 exports.$set('sendToHost', ipcRenderer.sendToHost.bind(ipcRenderer))
 exports.$set('emit', ipcRenderer.emit.bind(ipcRenderer))
 
@@ -4,17 +4,25 @@
 
 #include "atom/common/asar/archive.h"
 
+#include <inttypes.h>
+
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "atom/common/asar/archive_index.h"
+#include "atom/common/asar/extraction_cache.h"
 #include "atom/common/asar/scoped_temporary_file.h"
 #include "base/files/file.h"
 #include "base/files/file_util.h"
+#include "base/files/memory_mapped_file.h"
 #include "base/json/json_reader.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/md5.h"
 #include "base/pickle.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
 #include "base/task_scheduler/post_task.h"
 #include "base/values.h"
 
@@ -28,98 +36,53 @@ namespace asar {
 
 namespace {
 
-#if defined(OS_WIN)
-const char kSeparators[] = "\\/";
-#else
-const char kSeparators[] = "/";
-#endif
-
-bool GetNodeFromPath(std::string path,
-                     const base::DictionaryValue* root,
-                     const base::DictionaryValue** out);
-
-// Gets the "files" from "dir".
-bool GetFilesNode(const base::DictionaryValue* root,
-                  const base::DictionaryValue* dir,
-                  const base::DictionaryValue** out) {
-  // Test for symbol linked directory.
-  std::string link;
-  if (dir->GetStringWithoutPathExpansion("link", &link)) {
-    const base::DictionaryValue* linked_node = nullptr;
-    if (!GetNodeFromPath(link, root, &linked_node))
-      return false;
-    dir = linked_node;
-  }
-
-  return dir->GetDictionaryWithoutPathExpansion("files", out);
-}
-
-// Gets sub-file "name" from "dir".
-bool GetChildNode(const base::DictionaryValue* root,
-                  const std::string& name,
-                  const base::DictionaryValue* dir,
-                  const base::DictionaryValue** out) {
-  if (name == "") {
-    *out = root;
-    return true;
-  }
-
-  const base::DictionaryValue* files = nullptr;
-  return GetFilesNode(root, dir, &files) &&
-         files->GetDictionaryWithoutPathExpansion(name, out);
-}
-
-// Gets the node of "path" from "root".
-bool GetNodeFromPath(std::string path,
-                     const base::DictionaryValue* root,
-                     const base::DictionaryValue** out) {
-  if (path == "") {
-    *out = root;
-    return true;
-  }
-
-  const base::DictionaryValue* dir = root;
-  for (size_t delimiter_position = path.find_first_of(kSeparators);
-       delimiter_position != std::string::npos;
-       delimiter_position = path.find_first_of(kSeparators)) {
-    const base::DictionaryValue* child = nullptr;
-    if (!GetChildNode(root, path.substr(0, delimiter_position), dir, &child))
-      return false;
+// Where pre-built indexes are persisted, empty when caching is disabled.
+base::LazyInstance<base::FilePath>::Leaky g_index_cache_dir =
+    LAZY_INSTANCE_INITIALIZER;
+
+// Gets the location of the cached index of |path| and the key it must match.
+bool GetIndexCacheInfo(const base::FilePath& path,
+                       base::File* file,
+                       base::FilePath* cache_path,
+                       ArchiveIndex::CacheKey* key) {
+  const base::FilePath& cache_dir = g_index_cache_dir.Get();
+  if (cache_dir.empty())
+    return false;
 
-    dir = child;
-    path.erase(0, delimiter_position + 1);
-  }
+  base::File::Info info;
+  if (!file->GetInfo(&info))
+    return false;
 
-  return GetChildNode(root, path, dir, out);
+  key->archive_size = static_cast<uint64_t>(info.size);
+  key->archive_mtime = info.last_modified.ToInternalValue();
+  *cache_path = cache_dir.AppendASCII(base::MD5String(path.AsUTF8Unsafe()));
+  return true;
 }
 
-bool FillFileInfoWithNode(Archive::FileInfo* info,
-                          uint32_t header_size,
-                          const base::DictionaryValue* node) {
-  int size;
-  if (!node->GetInteger("size", &size))
+bool FillFileInfoWithEntry(Archive::FileInfo* info,
+                           uint32_t header_size,
+                           const ArchiveIndex::Entry* entry) {
+  if (!entry->has_file_info())
     return false;
-  info->size = static_cast<uint32_t>(size);
+  info->size = entry->size;
 
-  if (node->GetBoolean("unpacked", &info->unpacked) && info->unpacked)
+  if (entry->unpacked()) {
+    info->unpacked = true;
     return true;
+  }
 
-  std::string offset;
-  if (!node->GetString("offset", &offset))
-    return false;
-  if (!base::StringToUint64(offset, &info->offset))
-    return false;
-  info->offset += header_size;
-
-  node->GetBoolean("executable", &info->executable);
-
+  info->offset = entry->offset + header_size;
+  info->executable = entry->executable();
   return true;
 }
 
 }  // namespace
 
 Archive::Archive(const base::FilePath& path)
-    : path_(path), file_(base::File::FILE_OK), header_size_(0) {
+    : path_(path),
+      file_(base::File::FILE_OK),
+      header_size_(0),
+      mapped_file_initialized_(false) {
   base::ThreadRestrictions::ScopedAllowIO allow_io;
   file_.Initialize(path_, base::File::FLAG_OPEN | base::File::FLAG_READ);
 #if defined(OS_WIN)
@@ -132,7 +95,9 @@ Archive::Archive(const base::FilePath& path)
 }
 
 Archive::~Archive() {
-  base::ThreadRestrictions::SetIOAllowed(true);  // TODO(bridiver) ugh electron
+  // Closing the file and deleting copied out files is IO. The previous state
+  // is restored since archives can be destroyed on any thread.
+  bool io_allowed = base::ThreadRestrictions::SetIOAllowed(true);
 #if defined(OS_WIN)
   if (fd_ != -1) {
     _close(fd_);
@@ -140,8 +105,15 @@ Archive::~Archive() {
     file_.TakePlatformFile();
   }
 #endif
-  base::ThreadRestrictions::ScopedAllowIO allow_io;
   file_.Close();
+  external_files_.clear();
+  mapped_file_.reset();
+  base::ThreadRestrictions::SetIOAllowed(io_allowed);
+}
+
+// static
+void Archive::SetIndexCacheDirectory(const base::FilePath& cache_dir) {
+  g_index_cache_dir.Get() = cache_dir;
 }
 
 bool Archive::Init() {
@@ -153,6 +125,26 @@ bool Archive::Init() {
     return false;
   }
 
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  base::FilePath cache_path;
+  ArchiveIndex::CacheKey cache_key;
+  bool use_cache = GetIndexCacheInfo(path_, &file_, &cache_path, &cache_key);
+  if (use_cache) {
+    index_ = ArchiveIndex::LoadFromCache(cache_path, cache_key, &header_size_);
+    if (index_)
+      return true;
+  }
+
+  if (!ReadHeader())
+    return false;
+
+  // Failing to persist the index only costs the next process a parse.
+  if (use_cache && base::CreateDirectory(cache_path.DirName()))
+    index_->SaveToCache(cache_path, cache_key, header_size_);
+  return true;
+}
+
+bool Archive::ReadHeader() {
   std::vector<char> buf;
   int len;
 
@@ -198,81 +190,86 @@ bool Archive::Init() {
     return false;
   }
 
+  // The DictionaryValue tree is only needed to build the index.
+  index_ = ArchiveIndex::Create(
+      *static_cast<base::DictionaryValue*>(value.get()));
+  if (!index_) {
+    LOG(ERROR) << "Failed to index header from " << path_.value();
+    return false;
+  }
+
   header_size_ = 8 + size;
-  header_.reset(static_cast<base::DictionaryValue*>(value.release()));
   return true;
 }
 
 bool Archive::GetFileInfo(const base::FilePath& path, FileInfo* info) {
-  if (!header_)
+  if (!index_)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  const ArchiveIndex::Entry* entry =
+      index_->ResolveLink(index_->Find(path.AsUTF8Unsafe()));
+  if (!entry)
     return false;
 
-  std::string link;
-  if (node->GetString("link", &link))
-    return GetFileInfo(base::FilePath::FromUTF8Unsafe(link), info);
-
-  return FillFileInfoWithNode(info, header_size_, node);
+  return FillFileInfoWithEntry(info, header_size_, entry);
 }
 
 bool Archive::Stat(const base::FilePath& path, Stats* stats) {
-  if (!header_)
+  if (!index_)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  const ArchiveIndex::Entry* entry = index_->Find(path.AsUTF8Unsafe());
+  if (!entry)
     return false;
 
-  if (node->HasKey("link")) {
+  if (entry->is_link()) {
     stats->is_file = false;
     stats->is_link = true;
     return true;
   }
 
-  if (node->HasKey("files")) {
+  if (entry->is_directory()) {
     stats->is_file = false;
     stats->is_directory = true;
     return true;
   }
 
-  return FillFileInfoWithNode(stats, header_size_, node);
+  return FillFileInfoWithEntry(stats, header_size_, entry);
 }
 
 bool Archive::Readdir(const base::FilePath& path,
                       std::vector<base::FilePath>* list) {
-  if (!header_)
+  if (!index_)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  const ArchiveIndex::Entry* entry = index_->Find(path.AsUTF8Unsafe());
+  if (!entry)
     return false;
 
-  const base::DictionaryValue* files;
-  if (!GetFilesNode(header_.get(), node, &files))
+  const ArchiveIndex::Entry* dir = index_->GetDirectory(entry);
+  if (!dir)
     return false;
 
-  base::DictionaryValue::Iterator iter(*files);
-  while (!iter.IsAtEnd()) {
-    list->push_back(base::FilePath::FromUTF8Unsafe(iter.key()));
-    iter.Advance();
+  list->reserve(list->size() + dir->child_count);
+  for (const ArchiveIndex::Entry* child = index_->children_begin(dir);
+       child != index_->children_end(dir); ++child) {
+    list->push_back(
+        base::FilePath::FromUTF8Unsafe(index_->GetName(child).as_string()));
   }
   return true;
 }
 
 bool Archive::Realpath(const base::FilePath& path, base::FilePath* realpath) {
-  if (!header_)
+  if (!index_)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  const ArchiveIndex::Entry* entry = index_->Find(path.AsUTF8Unsafe());
+  if (!entry)
     return false;
 
-  std::string link;
-  if (node->GetString("link", &link)) {
-    *realpath = base::FilePath::FromUTF8Unsafe(link);
+  if (entry->is_link()) {
+    *realpath =
+        base::FilePath::FromUTF8Unsafe(index_->GetLink(entry).as_string());
     return true;
   }
 
@@ -281,12 +278,24 @@ bool Archive::Realpath(const base::FilePath& path, base::FilePath* realpath) {
 }
 
 bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
+  // Held through the copy, so concurrent callers don't extract a file twice.
+  base::AutoLock auto_lock(extracted_files_lock_);
   auto it = external_files_.find(path.value());
   if (it != external_files_.end()) {
     *out = it->second->path();
     return true;
   }
 
+  auto cached = extracted_files_.find(path.value());
+  if (cached != extracted_files_.end()) {
+    // Another process may have collected the entry since.
+    if (TouchCachedFile(cached->second)) {
+      *out = cached->second;
+      return true;
+    }
+    extracted_files_.erase(cached);
+  }
+
   FileInfo info;
   if (!GetFileInfo(path, &info))
     return false;
@@ -296,6 +305,22 @@ bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
     return true;
   }
 
+  // Prefer the copy persisted by an earlier launch or another process.
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  base::File::Info archive_info;
+  if (file_.GetInfo(&archive_info)) {
+    std::string archive_id = base::StringPrintf(
+        "%s:%" PRId64 ":%" PRId64, path_.AsUTF8Unsafe().c_str(),
+        archive_info.size, archive_info.last_modified.ToInternalValue());
+    base::FilePath extracted_path;
+    if (ExtractToCache(&file_, archive_id, path.Extension(), info.offset,
+                       info.size, info.executable, &extracted_path)) {
+      *out = extracted_path;
+      extracted_files_[path.value()] = extracted_path;
+      return true;
+    }
+  }
+
   std::unique_ptr<ScopedTemporaryFile> temp_file(new ScopedTemporaryFile);
   base::FilePath::StringType ext = path.Extension();
   if (!temp_file->InitFromFile(&file_, ext, info.offset, info.size))
@@ -317,4 +342,51 @@ int Archive::GetFD() const {
   return fd_;
 }
 
+bool Archive::HasExternalResources() {
+  {
+    base::AutoLock auto_lock(extracted_files_lock_);
+    if (!external_files_.empty() || !extracted_files_.empty())
+      return true;
+  }
+  base::AutoLock auto_lock(mapped_file_lock_);
+  return mapped_file_ != nullptr;
+}
+
+const base::MemoryMappedFile* Archive::GetMappedFile() {
+  base::AutoLock auto_lock(mapped_file_lock_);
+  if (mapped_file_initialized_)
+    return mapped_file_.get();
+
+  mapped_file_initialized_ = true;
+  if (!file_.IsValid())
+    return nullptr;
+
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  std::unique_ptr<base::MemoryMappedFile> mapped_file(
+      new base::MemoryMappedFile);
+  if (!mapped_file->Initialize(file_.Duplicate())) {
+    LOG(WARNING) << "Failed to map " << path_.value();
+    return nullptr;
+  }
+
+  mapped_file_ = std::move(mapped_file);
+  return mapped_file_.get();
+}
+
+const base::MemoryMappedFile* Archive::GetMappedFileFor(const FileInfo& info) {
+  const base::MemoryMappedFile* mapped_file = GetMappedFile();
+  if (!mapped_file)
+    return nullptr;
+
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  base::File::Info archive_info;
+  uint64_t end = info.offset + info.size;
+  if (end > mapped_file->length() || !file_.GetInfo(&archive_info) ||
+      end > static_cast<uint64_t>(archive_info.size)) {
+    LOG(WARNING) << path_.value() << " is shorter than its header says";
+    return nullptr;
+  }
+  return mapped_file;
+}
+
 }  // namespace asar
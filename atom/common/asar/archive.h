@@ -11,13 +11,15 @@
 
 #include "base/files/file.h"
 #include "base/files/file_path.h"
+#include "base/synchronization/lock.h"
 
 namespace base {
-class DictionaryValue;
+class MemoryMappedFile;
 }
 
 namespace asar {
 
+class ArchiveIndex;
 class ScopedTemporaryFile;
 
 // This class represents an asar package, and provides methods to read
@@ -42,7 +44,11 @@ class Archive {
   explicit Archive(const base::FilePath& path);
   virtual ~Archive();
 
-  // Read and parse the header.
+  // Sets the directory where pre-built header indexes are persisted. Must be
+  // called before any archive is opened; caching is disabled by default.
+  static void SetIndexCacheDirectory(const base::FilePath& cache_dir);
+
+  // Read and parse the header, or map a cached index of it.
   bool Init();
 
   // Get the info of a file.
@@ -58,27 +64,57 @@ class Archive {
   bool Realpath(const base::FilePath& path, base::FilePath* realpath);
 
   // Copy the file into a temporary file, and return the new path.
-  // For unpacked file, this method will return its real path.
+  // For unpacked file, this method will return its real path. When an
+  // extraction cache is configured the copy is persisted and shared instead.
   bool CopyFileOut(const base::FilePath& path, base::FilePath* out);
 
   // Returns the file's fd.
   int GetFD() const;
 
+  // Whether files were copied out of the archive or it was mapped, which
+  // would have to be redone if the archive were reopened. Can be called from
+  // any thread.
+  bool HasExternalResources();
+
+  // Maps the whole archive into memory on first call and returns the mapping,
+  // or nullptr if it could not be mapped. The mapping is shared by all callers
+  // and lives as long as the archive. Can be called from any thread.
+  const base::MemoryMappedFile* GetMappedFile();
+
+  // Like GetMappedFile(), but returns nullptr unless both the mapping and the
+  // archive on disk still hold all of |info|. Reading past the end of a
+  // truncated archive through the mapping would fault instead of failing.
+  const base::MemoryMappedFile* GetMappedFileFor(const FileInfo& info);
+
   base::FilePath path() const { return path_; }
-  base::DictionaryValue* header() const { return header_.get(); }
+  const ArchiveIndex* index() const { return index_.get(); }
 
  private:
+  // Parses the JSON header from the archive into |index_|.
+  bool ReadHeader();
+
   base::FilePath path_;
   base::File file_;
   int fd_;
   uint32_t header_size_;
-  std::unique_ptr<base::DictionaryValue> header_;
+  std::unique_ptr<ArchiveIndex> index_;
+
+  base::Lock mapped_file_lock_;
+  bool mapped_file_initialized_;
+  std::unique_ptr<base::MemoryMappedFile> mapped_file_;
+
+  // Guards |external_files_| and |extracted_files_|.
+  base::Lock extracted_files_lock_;
 
   // Cached external temporary files.
   std::unordered_map
     <base::FilePath::StringType, std::unique_ptr<ScopedTemporaryFile>>
       external_files_;
 
+  // Files already found in the persistent extraction cache.
+  std::unordered_map<base::FilePath::StringType, base::FilePath>
+      extracted_files_;
+
   DISALLOW_COPY_AND_ASSIGN(Archive);
 };
 
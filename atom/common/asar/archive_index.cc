@@ -0,0 +1,396 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/common/asar/archive_index.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "base/files/file_path.h"
+#include "base/files/important_file_writer.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/values.h"
+
+namespace asar {
+
+namespace {
+
+const uint32_t kIndexMagic = 0x58444941;  // "AIDX"
+const uint32_t kIndexVersion = 1;
+
+const uint32_t kCacheMagic = 0x48434941;  // "AICH"
+const uint32_t kCacheVersion = 1;
+
+// Prefix of a persisted index, followed by the index buffer itself.
+struct CacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t header_size;
+  uint32_t padding;
+  uint64_t archive_size;
+  int64_t archive_mtime;
+};
+
+// Same limit as SYMLOOP_MAX on most platforms.
+const int kMaxLinkDepth = 40;
+
+#if defined(OS_WIN)
+const char kSeparators[] = "\\/";
+#else
+const char kSeparators[] = "/";
+#endif
+
+// Flattens a DictionaryValue tree into entries in breadth-first order, so
+// the children of each directory end up contiguous.
+class IndexBuilder {
+ public:
+  IndexBuilder() {}
+
+  bool Build(const base::DictionaryValue& root);
+  std::vector<uint8_t> Finish() const;
+
+ private:
+  uint32_t Intern(const std::string& str);
+  bool FillEntry(const base::DictionaryValue& node, uint32_t index);
+
+  std::vector<ArchiveIndex::Entry> entries_;
+  std::string strings_;
+  std::unordered_map<std::string, uint32_t> interned_;
+
+  DISALLOW_COPY_AND_ASSIGN(IndexBuilder);
+};
+
+uint32_t IndexBuilder::Intern(const std::string& str) {
+  auto it = interned_.find(str);
+  if (it != interned_.end())
+    return it->second;
+
+  uint32_t offset = static_cast<uint32_t>(strings_.size());
+  strings_.append(str);
+  interned_[str] = offset;
+  return offset;
+}
+
+bool IndexBuilder::FillEntry(const base::DictionaryValue& node,
+                             uint32_t index) {
+  std::string link;
+  if (node.GetStringWithoutPathExpansion("link", &link)) {
+    uint32_t link_offset = Intern(link);
+    entries_[index].link_offset = link_offset;
+    entries_[index].link_length = static_cast<uint32_t>(link.size());
+    entries_[index].flags |= ArchiveIndex::kLink;
+  }
+
+  int size;
+  if (!node.GetIntegerWithoutPathExpansion("size", &size))
+    return true;
+
+  bool unpacked = false;
+  if (node.GetBooleanWithoutPathExpansion("unpacked", &unpacked) &&
+      unpacked) {
+    entries_[index].size = static_cast<uint32_t>(size);
+    entries_[index].flags |= ArchiveIndex::kUnpacked |
+                             ArchiveIndex::kHasFileInfo;
+    return true;
+  }
+
+  std::string offset_string;
+  uint64_t offset;
+  if (!node.GetStringWithoutPathExpansion("offset", &offset_string) ||
+      !base::StringToUint64(offset_string, &offset))
+    return true;
+
+  entries_[index].size = static_cast<uint32_t>(size);
+  entries_[index].offset = offset;
+  entries_[index].flags |= ArchiveIndex::kHasFileInfo;
+
+  bool executable = false;
+  if (node.GetBooleanWithoutPathExpansion("executable", &executable) &&
+      executable)
+    entries_[index].flags |= ArchiveIndex::kExecutable;
+
+  return true;
+}
+
+bool IndexBuilder::Build(const base::DictionaryValue& root) {
+  ArchiveIndex::Entry empty;
+  memset(&empty, 0, sizeof(empty));
+
+  entries_.push_back(empty);
+  std::queue<std::pair<const base::DictionaryValue*, uint32_t>> pending;
+  pending.push(std::make_pair(&root, 0u));
+
+  while (!pending.empty()) {
+    const base::DictionaryValue* node = pending.front().first;
+    uint32_t index = pending.front().second;
+    pending.pop();
+
+    if (!FillEntry(*node, index))
+      return false;
+
+    const base::DictionaryValue* files = nullptr;
+    if (!node->GetDictionaryWithoutPathExpansion("files", &files))
+      continue;
+
+    entries_[index].flags |= ArchiveIndex::kDirectory;
+    entries_[index].first_child = static_cast<uint32_t>(entries_.size());
+
+    // DictionaryValue iterates in key order, so children come out sorted.
+    uint32_t child_count = 0;
+    for (base::DictionaryValue::Iterator it(*files); !it.IsAtEnd();
+         it.Advance()) {
+      const base::DictionaryValue* child = nullptr;
+      if (!it.value().GetAsDictionary(&child))
+        continue;
+
+      if (entries_.size() >= std::numeric_limits<uint32_t>::max())
+        return false;
+
+      ArchiveIndex::Entry entry = empty;
+      entry.name_offset = Intern(it.key());
+      entry.name_length = static_cast<uint32_t>(it.key().size());
+      entries_.push_back(entry);
+      pending.push(std::make_pair(
+          child, static_cast<uint32_t>(entries_.size() - 1)));
+      ++child_count;
+    }
+    entries_[index].child_count = child_count;
+  }
+
+  return strings_.size() < std::numeric_limits<uint32_t>::max();
+}
+
+std::vector<uint8_t> IndexBuilder::Finish() const {
+  ArchiveIndex::Header header;
+  header.magic = kIndexMagic;
+  header.version = kIndexVersion;
+  header.entry_count = static_cast<uint32_t>(entries_.size());
+  header.strings_size = static_cast<uint32_t>(strings_.size());
+
+  size_t entries_size = entries_.size() * sizeof(ArchiveIndex::Entry);
+  std::vector<uint8_t> storage(sizeof(header) + entries_size + strings_.size());
+  uint8_t* out = storage.data();
+  memcpy(out, &header, sizeof(header));
+  out += sizeof(header);
+  memcpy(out, entries_.data(), entries_size);
+  out += entries_size;
+  memcpy(out, strings_.data(), strings_.size());
+  return storage;
+}
+
+}  // namespace
+
+ArchiveIndex::ArchiveIndex(std::vector<uint8_t> storage)
+    : storage_(std::move(storage)),
+      data_(storage_.data()),
+      size_(storage_.size()),
+      entries_(nullptr),
+      entry_count_(0),
+      strings_(nullptr),
+      strings_size_(0) {
+}
+
+ArchiveIndex::ArchiveIndex(std::unique_ptr<base::MemoryMappedFile> mapped_file,
+                           size_t offset)
+    : mapped_file_(std::move(mapped_file)),
+      data_(mapped_file_->data() + offset),
+      size_(mapped_file_->length() - offset),
+      entries_(nullptr),
+      entry_count_(0),
+      strings_(nullptr),
+      strings_size_(0) {
+}
+
+ArchiveIndex::~ArchiveIndex() {
+}
+
+// static
+std::unique_ptr<ArchiveIndex> ArchiveIndex::Create(
+    const base::DictionaryValue& header) {
+  IndexBuilder builder;
+  if (!builder.Build(header)) {
+    LOG(ERROR) << "Failed to build asar index";
+    return nullptr;
+  }
+
+  std::unique_ptr<ArchiveIndex> index(new ArchiveIndex(builder.Finish()));
+  if (!index->Validate())
+    return nullptr;
+  return index;
+}
+
+// static
+std::unique_ptr<ArchiveIndex> ArchiveIndex::LoadFromCache(
+    const base::FilePath& cache_path,
+    const CacheKey& key,
+    uint32_t* header_size) {
+  std::unique_ptr<base::MemoryMappedFile> mapped_file(
+      new base::MemoryMappedFile);
+  if (!mapped_file->Initialize(cache_path) ||
+      mapped_file->length() < sizeof(CacheHeader))
+    return nullptr;
+
+  CacheHeader cache_header;
+  memcpy(&cache_header, mapped_file->data(), sizeof(cache_header));
+  if (cache_header.magic != kCacheMagic ||
+      cache_header.version != kCacheVersion ||
+      cache_header.archive_size != key.archive_size ||
+      cache_header.archive_mtime != key.archive_mtime)
+    return nullptr;
+
+  std::unique_ptr<ArchiveIndex> index(
+      new ArchiveIndex(std::move(mapped_file), sizeof(CacheHeader)));
+  if (!index->Validate()) {
+    LOG(WARNING) << "Ignoring corrupted asar index " << cache_path.value();
+    return nullptr;
+  }
+
+  *header_size = cache_header.header_size;
+  return index;
+}
+
+bool ArchiveIndex::SaveToCache(const base::FilePath& cache_path,
+                               const CacheKey& key,
+                               uint32_t header_size) const {
+  CacheHeader cache_header;
+  memset(&cache_header, 0, sizeof(cache_header));
+  cache_header.magic = kCacheMagic;
+  cache_header.version = kCacheVersion;
+  cache_header.header_size = header_size;
+  cache_header.archive_size = key.archive_size;
+  cache_header.archive_mtime = key.archive_mtime;
+
+  std::string data(reinterpret_cast<const char*>(&cache_header),
+                   sizeof(cache_header));
+  data.append(reinterpret_cast<const char*>(data_), size_);
+  return base::ImportantFileWriter::WriteFileAtomically(cache_path, data);
+}
+
+bool ArchiveIndex::Validate() {
+  static_assert(sizeof(CacheHeader) % 8 == 0, "entries must stay aligned");
+  static_assert(sizeof(Header) % 8 == 0, "entries must stay aligned");
+  static_assert(sizeof(Entry) % 8 == 0, "entries must stay aligned");
+
+  const uint8_t* data = data_;
+  size_t size = size_;
+  if (size < sizeof(Header))
+    return false;
+
+  Header header;
+  memcpy(&header, data, sizeof(header));
+  if (header.magic != kIndexMagic || header.version != kIndexVersion ||
+      header.entry_count == 0)
+    return false;
+
+  uint64_t entries_size =
+      static_cast<uint64_t>(header.entry_count) * sizeof(Entry);
+  if (sizeof(Header) + entries_size + header.strings_size != size)
+    return false;
+
+  entries_ = reinterpret_cast<const Entry*>(data + sizeof(Header));
+  entry_count_ = header.entry_count;
+  strings_ = reinterpret_cast<const char*>(data + sizeof(Header) +
+                                           entries_size);
+  strings_size_ = header.strings_size;
+
+  for (size_t i = 0; i < entry_count_; ++i) {
+    const Entry& entry = entries_[i];
+    if (static_cast<uint64_t>(entry.name_offset) + entry.name_length >
+            strings_size_ ||
+        static_cast<uint64_t>(entry.link_offset) + entry.link_length >
+            strings_size_ ||
+        static_cast<uint64_t>(entry.first_child) + entry.child_count >
+            entry_count_)
+      return false;
+  }
+  return true;
+}
+
+base::StringPiece ArchiveIndex::GetName(const Entry* entry) const {
+  return base::StringPiece(strings_ + entry->name_offset, entry->name_length);
+}
+
+base::StringPiece ArchiveIndex::GetLink(const Entry* entry) const {
+  return base::StringPiece(strings_ + entry->link_offset, entry->link_length);
+}
+
+const ArchiveIndex::Entry* ArchiveIndex::FindChild(
+    const Entry* dir, base::StringPiece name) const {
+  const Entry* begin = children_begin(dir);
+  const Entry* end = children_end(dir);
+  const Entry* it = std::lower_bound(
+      begin, end, name, [this](const Entry& entry, base::StringPiece key) {
+        return GetName(&entry) < key;
+      });
+  if (it == end || GetName(it) != name)
+    return nullptr;
+  return it;
+}
+
+const ArchiveIndex::Entry* ArchiveIndex::FindWithDepth(base::StringPiece path,
+                                                       int depth) const {
+  if (depth > kMaxLinkDepth)
+    return nullptr;
+
+  const Entry* dir = root();
+  size_t start = 0;
+  while (true) {
+    size_t pos = path.find_first_of(kSeparators, start);
+    base::StringPiece name = path.substr(
+        start, pos == base::StringPiece::npos ? pos : pos - start);
+
+    const Entry* node = root();
+    if (!name.empty()) {
+      // Test for symbol linked directory.
+      if (dir->is_link()) {
+        dir = FindWithDepth(GetLink(dir), depth + 1);
+        if (!dir)
+          return nullptr;
+      }
+      if (!dir->is_directory())
+        return nullptr;
+      node = FindChild(dir, name);
+      if (!node)
+        return nullptr;
+    }
+
+    if (pos == base::StringPiece::npos)
+      return node;
+    dir = node;
+    start = pos + 1;
+  }
+}
+
+const ArchiveIndex::Entry* ArchiveIndex::Find(base::StringPiece path) const {
+  return FindWithDepth(path, 0);
+}
+
+const ArchiveIndex::Entry* ArchiveIndex::ResolveLink(
+    const Entry* entry) const {
+  for (int depth = 0; entry && depth <= kMaxLinkDepth; ++depth) {
+    if (!entry->is_link())
+      return entry;
+    entry = Find(GetLink(entry));
+  }
+  return nullptr;
+}
+
+const ArchiveIndex::Entry* ArchiveIndex::GetDirectory(
+    const Entry* entry) const {
+  if (entry->is_link())
+    entry = Find(GetLink(entry));
+  if (!entry || !entry->is_directory())
+    return nullptr;
+  return entry;
+}
+
+}  // namespace asar
@@ -0,0 +1,157 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_ASAR_ARCHIVE_INDEX_H_
+#define ATOM_COMMON_ASAR_ARCHIVE_INDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+
+namespace base {
+class DictionaryValue;
+class FilePath;
+class MemoryMappedFile;
+}
+
+namespace asar {
+
+// A flat, read-only index of an asar header.
+//
+// The JSON header is converted once into a single contiguous buffer laid out
+// as:
+//
+//   Header | Entry[entry_count] | char strings[strings_size]
+//
+// Entry 0 is the root directory. The children of a directory are stored
+// contiguously and sorted by name, so resolving a path costs one binary
+// search per path component and never allocates. Path components and link
+// targets are interned in the string table.
+//
+// Because the buffer has no pointers in it, it can be persisted as is and
+// later memory-mapped, which lets processes skip reading and parsing the JSON
+// header entirely.
+class ArchiveIndex {
+ public:
+  enum EntryFlags : uint32_t {
+    kDirectory = 1 << 0,
+    kLink = 1 << 1,
+    kUnpacked = 1 << 2,
+    kExecutable = 1 << 3,
+    // Set when the node carries a valid size/offset pair.
+    kHasFileInfo = 1 << 4,
+  };
+
+  struct Entry {
+    uint32_t name_offset;
+    uint32_t name_length;
+    uint32_t first_child;
+    uint32_t child_count;
+    uint32_t link_offset;
+    uint32_t link_length;
+    uint32_t size;
+    uint32_t flags;
+    // Relative to the end of the header, like in the JSON.
+    uint64_t offset;
+
+    bool is_directory() const { return (flags & kDirectory) != 0; }
+    bool is_link() const { return (flags & kLink) != 0; }
+    bool unpacked() const { return (flags & kUnpacked) != 0; }
+    bool executable() const { return (flags & kExecutable) != 0; }
+    bool has_file_info() const { return (flags & kHasFileInfo) != 0; }
+  };
+
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t strings_size;
+  };
+
+  // Identifies the archive file a persisted index was built from.
+  struct CacheKey {
+    uint64_t archive_size;
+    int64_t archive_mtime;
+  };
+
+  ~ArchiveIndex();
+
+  // Builds the index from a parsed asar header. Returns nullptr when the
+  // header is malformed.
+  static std::unique_ptr<ArchiveIndex> Create(
+      const base::DictionaryValue& header);
+
+  // Maps a persisted index from |cache_path|. Returns nullptr if the file
+  // does not exist, is corrupted or was written for a different |key|. On
+  // success |header_size| is set to the size of the archive header.
+  static std::unique_ptr<ArchiveIndex> LoadFromCache(
+      const base::FilePath& cache_path,
+      const CacheKey& key,
+      uint32_t* header_size);
+
+  // Atomically writes the index to |cache_path|.
+  bool SaveToCache(const base::FilePath& cache_path,
+                   const CacheKey& key,
+                   uint32_t header_size) const;
+
+  // Finds the entry for |path|, following links of intermediate directories.
+  // The final entry is returned as is, even if it is a link.
+  const Entry* Find(base::StringPiece path) const;
+
+  // Follows |entry| while it is a link. Returns nullptr for dangling or
+  // cyclic links.
+  const Entry* ResolveLink(const Entry* entry) const;
+
+  // Returns the directory whose children should be listed for |entry|,
+  // following a link if needed, or nullptr if it is not a directory.
+  const Entry* GetDirectory(const Entry* entry) const;
+
+  base::StringPiece GetName(const Entry* entry) const;
+  base::StringPiece GetLink(const Entry* entry) const;
+
+  const Entry* children_begin(const Entry* dir) const {
+    return entries_ + dir->first_child;
+  }
+  const Entry* children_end(const Entry* dir) const {
+    return entries_ + dir->first_child + dir->child_count;
+  }
+
+  const Entry* root() const { return entries_; }
+  size_t entry_count() const { return entry_count_; }
+
+ private:
+  explicit ArchiveIndex(std::vector<uint8_t> storage);
+  ArchiveIndex(std::unique_ptr<base::MemoryMappedFile> mapped_file,
+               size_t offset);
+
+  // Sets up the views into the index buffer and checks every entry is in
+  // bounds.
+  bool Validate();
+
+  const Entry* FindChild(const Entry* dir, base::StringPiece name) const;
+  const Entry* FindWithDepth(base::StringPiece path, int depth) const;
+
+  // Exactly one of these owns the index buffer.
+  std::vector<uint8_t> storage_;
+  std::unique_ptr<base::MemoryMappedFile> mapped_file_;
+
+  const uint8_t* data_;
+  size_t size_;
+
+  const Entry* entries_;
+  size_t entry_count_;
+  const char* strings_;
+  size_t strings_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(ArchiveIndex);
+};
+
+}  // namespace asar
+
+#endif  // ATOM_COMMON_ASAR_ARCHIVE_INDEX_H_
@@ -4,50 +4,275 @@
 
 #include "atom/common/asar/asar_util.h"
 
+#include <algorithm>
+#include <functional>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "atom/common/asar/archive.h"
+#include "base/containers/mru_cache.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/bind.h"
 #include "base/lazy_instance.h"
-#include "base/stl_util.h"
+#include "base/synchronization/lock.h"
+#include "base/task_scheduler/post_task.h"
+#include "base/task_scheduler/task_scheduler.h"
+#include "base/time/time.h"
 
 namespace asar {
 
 namespace {
 
-// The global instance of ArchiveMap, will be destroyed on exit.
-typedef std::map<base::FilePath, std::shared_ptr<Archive>> ArchiveMap;
-static base::LazyInstance<ArchiveMap>::DestructorAtExit g_archive_map =
+// Archives are spread over independently locked shards so lookups of
+// different archives from different threads don't contend.
+const size_t kShardCount = 16;
+
+// Archives nobody but the registry references are kept around for reuse, but
+// only this many per shard; the least recently used ones are dropped first.
+// Archives with copied out files or a mapping are never dropped, redoing
+// those costs more than keeping them.
+const size_t kMaxIdleArchivesPerShard = 4;
+
+void DestroyArchives(std::vector<std::shared_ptr<Archive>> archives) {
+  // |archives| go away with the task.
+}
+
+// Closing an archive is IO, which the thread that evicted it may not allow.
+// Without a task scheduler they are closed right away.
+void DestroyArchivesOnBlockingThread(
+    std::vector<std::shared_ptr<Archive>> archives) {
+  if (archives.empty() || !base::TaskScheduler::GetInstance())
+    return;
+  base::PostTaskWithTraits(
+      FROM_HERE,
+      {base::MayBlock(), base::TaskPriority::BACKGROUND,
+       base::TaskShutdownBehavior::CONTINUE_ON_SHUTDOWN},
+      base::BindOnce(&DestroyArchives, std::move(archives)));
+}
+
+// Holds one archive. Its lock is held while the archive is initialized, so
+// concurrent lookups of the same path wait for a single Init() instead of
+// parsing the header again.
+struct ArchiveSlot {
+  ArchiveSlot() : initialized(false) {}
+
+  base::Lock lock;
+  bool initialized;
+  std::shared_ptr<Archive> archive;
+  base::TimeTicks last_used;
+};
+
+struct ArchiveShard {
+  base::Lock lock;
+  std::map<base::FilePath, std::shared_ptr<ArchiveSlot>> slots;
+};
+
+class ArchiveRegistry {
+ public:
+  ArchiveRegistry() {}
+
+  std::shared_ptr<Archive> GetOrCreate(const base::FilePath& path);
+
+ private:
+  ArchiveShard* GetShard(const base::FilePath& path);
+
+  // Drops idle archives beyond kMaxIdleArchivesPerShard and moves them to
+  // |evicted|. |shard->lock| must be held.
+  void PruneIdleArchives(ArchiveShard* shard,
+                         std::vector<std::shared_ptr<Archive>>* evicted);
+
+  ArchiveShard shards_[kShardCount];
+
+  DISALLOW_COPY_AND_ASSIGN(ArchiveRegistry);
+};
+
+ArchiveShard* ArchiveRegistry::GetShard(const base::FilePath& path) {
+  size_t hash = std::hash<base::FilePath::StringType>()(path.value());
+  return &shards_[hash % kShardCount];
+}
+
+void ArchiveRegistry::PruneIdleArchives(
+    ArchiveShard* shard,
+    std::vector<std::shared_ptr<Archive>>* evicted) {
+  std::vector<std::pair<base::TimeTicks, base::FilePath>> idle;
+  for (const auto& it : shard->slots) {
+    // A slot held outside the map is about to be used.
+    if (it.second.use_count() != 1)
+      continue;
+    ArchiveSlot* slot = it.second.get();
+    // Slots being initialized are not idle.
+    if (!slot->lock.Try())
+      continue;
+    if (slot->initialized && slot->archive.use_count() == 1 &&
+        !slot->archive->HasExternalResources())
+      idle.push_back(std::make_pair(slot->last_used, it.first));
+    slot->lock.Release();
+  }
+
+  if (idle.size() <= kMaxIdleArchivesPerShard)
+    return;
+
+  std::sort(idle.begin(), idle.end());
+  for (size_t i = 0; i < idle.size() - kMaxIdleArchivesPerShard; ++i) {
+    auto it = shard->slots.find(idle[i].second);
+    evicted->push_back(std::move(it->second->archive));
+    shard->slots.erase(it);
+  }
+}
+
+std::shared_ptr<Archive> ArchiveRegistry::GetOrCreate(
+    const base::FilePath& path) {
+  ArchiveShard* shard = GetShard(path);
+  std::shared_ptr<ArchiveSlot> slot;
+  std::vector<std::shared_ptr<Archive>> evicted;
+  {
+    base::AutoLock auto_lock(shard->lock);
+    std::shared_ptr<ArchiveSlot>& existing = shard->slots[path];
+    if (!existing) {
+      existing = std::make_shared<ArchiveSlot>();
+      slot = existing;
+      PruneIdleArchives(shard, &evicted);
+    } else {
+      slot = existing;
+    }
+  }
+  DestroyArchivesOnBlockingThread(std::move(evicted));
+
+  std::shared_ptr<Archive> archive;
+  {
+    base::AutoLock auto_lock(slot->lock);
+    if (!slot->initialized) {
+      std::shared_ptr<Archive> created(new Archive(path));
+      if (created->Init())
+        slot->archive = created;
+      slot->initialized = true;
+    }
+    slot->last_used = base::TimeTicks::Now();
+    archive = slot->archive;
+  }
+
+  if (!archive) {
+    // Don't remember failures, the archive may show up later. The slot lock
+    // is released first to keep the shard -> slot lock order.
+    base::AutoLock auto_lock(shard->lock);
+    auto it = shard->slots.find(path);
+    if (it != shard->slots.end() && it->second == slot)
+      shard->slots.erase(it);
+  }
+  return archive;
+}
+
+// The global instance of ArchiveRegistry, will be destroyed on exit.
+base::LazyInstance<ArchiveRegistry>::DestructorAtExit g_archive_registry =
     LAZY_INSTANCE_INITIALIZER;
 
 const base::FilePath::CharType kAsarExtension[] = FILE_PATH_LITERAL(".asar");
 
+// Number of directories remembered by ArchivePathCache.
+const size_t kArchivePathCacheSize = 1024;
+
+// Remembers which archive, if any, each recently seen directory is in. The
+// lookup is purely lexical, so entries never go stale.
+class ArchivePathCache {
+ public:
+  ArchivePathCache() : cache_(kArchivePathCacheSize), hits_(0), misses_(0) {}
+
+  // Gets the archive containing |dir|. Returns false if |dir| is not inside
+  // an archive.
+  bool GetArchivePath(const base::FilePath& dir, base::FilePath* asar_path);
+
+  ArchivePathCacheStats GetStats();
+
+ private:
+  // Maps a directory to its archive, or to an empty path when it is not in
+  // one.
+  typedef base::HashingMRUCache<base::FilePath::StringType, base::FilePath>
+      Cache;
+
+  base::Lock lock_;
+  Cache cache_;
+  uint64_t hits_;
+  uint64_t misses_;
+
+  DISALLOW_COPY_AND_ASSIGN(ArchivePathCache);
+};
+
+bool ArchivePathCache::GetArchivePath(const base::FilePath& dir,
+                                      base::FilePath* asar_path) {
+  base::AutoLock auto_lock(lock_);
+  auto cached = cache_.Get(dir.value());
+  if (cached != cache_.end()) {
+    ++hits_;
+    *asar_path = cached->second;
+    return !asar_path->empty();
+  }
+  ++misses_;
+
+  // Walk up until an archive or a known ancestor is found, then remember the
+  // answer for every directory on the way.
+  std::vector<base::FilePath::StringType> visited;
+  base::FilePath iter = dir;
+  base::FilePath archive;
+  while (true) {
+    if (iter.MatchesExtension(kAsarExtension)) {
+      archive = iter;
+      break;
+    }
+    visited.push_back(iter.value());
+
+    base::FilePath dirname = iter.DirName();
+    if (iter == dirname)
+      break;
+    cached = cache_.Peek(dirname.value());
+    if (cached != cache_.end()) {
+      archive = cached->second;
+      break;
+    }
+    iter = dirname;
+  }
+
+  for (const auto& path : visited)
+    cache_.Put(path, archive);
+  // Keep |dir| itself the most recently used entry.
+  cache_.Put(dir.value(), archive);
+
+  *asar_path = archive;
+  return !archive.empty();
+}
+
+ArchivePathCacheStats ArchivePathCache::GetStats() {
+  base::AutoLock auto_lock(lock_);
+  ArchivePathCacheStats stats;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  return stats;
+}
+
+base::LazyInstance<ArchivePathCache>::Leaky g_archive_path_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
 }  // namespace
 
 std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path) {
-  ArchiveMap& archive_map = *g_archive_map.Pointer();
-  if (!ContainsKey(archive_map, path)) {
-    std::shared_ptr<Archive> archive(new Archive(path));
-    if (!archive->Init())
-      return nullptr;
-    archive_map[path] = archive;
-  }
-  return archive_map[path];
+  return g_archive_registry.Get().GetOrCreate(path);
+}
+
+ArchivePathCacheStats GetAsarArchivePathCacheStats() {
+  return g_archive_path_cache.Get().GetStats();
 }
 
 bool GetAsarArchivePath(const base::FilePath& full_path,
                         base::FilePath* asar_path,
                         base::FilePath* relative_path) {
-  base::FilePath iter = full_path;
-  while (true) {
-    base::FilePath dirname = iter.DirName();
-    if (iter.MatchesExtension(kAsarExtension))
-      break;
-    else if (iter == dirname)
-      return false;
-    iter = dirname;
+  base::FilePath iter;
+  if (full_path.MatchesExtension(kAsarExtension)) {
+    iter = full_path;
+  } else if (!g_archive_path_cache.Get().GetArchivePath(full_path.DirName(),
+                                                        &iter)) {
+    return false;
   }
 
   base::FilePath tail;
@@ -5,6 +5,8 @@
 #ifndef ATOM_COMMON_ASAR_ASAR_UTIL_H_
 #define ATOM_COMMON_ASAR_ASAR_UTIL_H_
 
+#include <stdint.h>
+
 #include <memory>
 #include <string>
 
@@ -16,14 +18,24 @@ namespace asar {
 
 class Archive;
 
-// Gets or creates a new Archive from the path.
+struct ArchivePathCacheStats {
+  uint64_t hits;
+  uint64_t misses;
+};
+
+// Gets or creates a new Archive from the path. Safe to call from any thread;
+// concurrent calls for the same path share a single Archive::Init().
 std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path);
 
-// Separates the path to Archive out.
+// Separates the path to Archive out. Results are cached per directory, so
+// repeated lookups under the same directory cost a single hash probe.
 bool GetAsarArchivePath(const base::FilePath& full_path,
                         base::FilePath* asar_path,
                         base::FilePath* relative_path);
 
+// Returns the hit/miss counters of the GetAsarArchivePath() cache.
+ArchivePathCacheStats GetAsarArchivePathCacheStats();
+
 // Same with base::ReadFileToString but supports asar Archive.
 bool ReadFileToString(const base::FilePath& path, std::string* contents);
 
@@ -0,0 +1,297 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/common/asar/extraction_cache.h"
+
+#include <inttypes.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/files/file.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/md5.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_split.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/time/time.h"
+
+namespace asar {
+
+namespace {
+
+// Entries not used for this long are removed.
+const int kMaxUnusedDays = 30;
+
+const size_t kCopyBufferSize = 64 * 1024;
+
+// Next to each entry, a record of the MD5, size and modification time of its
+// contents as written when it was published. The record is touched instead
+// of the entry, so the entry keeps the modification time it was published
+// with.
+const base::FilePath::CharType kDigestExtension[] = FILE_PATH_LITERAL(".md5");
+
+// What the record of an entry says about it.
+struct EntryRecord {
+  EntryRecord() : size(0) {}
+
+  std::string digest;
+  uint64_t size;
+  base::Time last_modified;
+};
+
+struct ExtractionCacheState {
+  ExtractionCacheState() : collected_garbage(false) {}
+
+  base::Lock lock;
+  base::FilePath dir;
+  bool collected_garbage;
+};
+
+base::LazyInstance<ExtractionCacheState>::Leaky g_extraction_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+base::FilePath DigestPath(const base::FilePath& path) {
+  return base::FilePath(path.value() + kDigestExtension);
+}
+
+// Removes entries, and temporary files left by crashed writers, that have not
+// been touched for kMaxUnusedDays. The records of entries are touched
+// whenever they are handed out, also by archives that already extracted
+// them, so entries in use are not collected.
+void CollectGarbage(const base::FilePath& cache_dir) {
+  base::Time cutoff =
+      base::Time::Now() - base::TimeDelta::FromDays(kMaxUnusedDays);
+  base::FileEnumerator enumerator(cache_dir, false,
+                                  base::FileEnumerator::FILES);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    base::Time last_used = enumerator.GetInfo().GetLastModifiedTime();
+    base::File::Info record_info;
+    if (!path.MatchesExtension(kDigestExtension) &&
+        base::GetFileInfo(DigestPath(path), &record_info))
+      last_used = record_info.last_modified;
+    if (last_used < cutoff)
+      base::DeleteFile(path, false);
+  }
+}
+
+// Copies the range to |dest_path| and flushes it to disk, so a published
+// entry is never seen with only part of its contents. Sets |digest| to the
+// MD5 of what was written.
+bool CopyRange(base::File* src,
+               uint64_t offset,
+               uint64_t size,
+               const base::FilePath& dest_path,
+               std::string* digest) {
+  base::File dest(dest_path, base::File::FLAG_OPEN | base::File::FLAG_WRITE);
+  if (!dest.IsValid())
+    return false;
+
+  base::MD5Context context;
+  base::MD5Init(&context);
+  std::vector<char> buf(
+      static_cast<size_t>(std::min<uint64_t>(size, kCopyBufferSize)));
+  while (size > 0) {
+    int chunk = static_cast<int>(std::min<uint64_t>(size, buf.size()));
+    if (src->Read(offset, buf.data(), chunk) != chunk ||
+        dest.WriteAtCurrentPos(buf.data(), chunk) != chunk)
+      return false;
+    base::MD5Update(&context, base::StringPiece(buf.data(), chunk));
+    offset += chunk;
+    size -= chunk;
+  }
+  if (!dest.Flush())
+    return false;
+
+  base::MD5Digest md5;
+  base::MD5Final(&md5, &context);
+  *digest = base::MD5DigestToBase16(md5);
+  return true;
+}
+
+bool HashFile(const base::FilePath& path, std::string* digest) {
+  base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (!file.IsValid())
+    return false;
+
+  base::MD5Context context;
+  base::MD5Init(&context);
+  std::vector<char> buf(kCopyBufferSize);
+  int read;
+  while ((read = file.ReadAtCurrentPos(buf.data(), buf.size())) > 0)
+    base::MD5Update(&context, base::StringPiece(buf.data(), read));
+  if (read < 0)
+    return false;
+
+  base::MD5Digest md5;
+  base::MD5Final(&md5, &context);
+  *digest = base::MD5DigestToBase16(md5);
+  return true;
+}
+
+bool ReadRecord(const base::FilePath& path, EntryRecord* record) {
+  std::string contents;
+  int64_t last_modified;
+  if (!base::ReadFileToString(DigestPath(path), &contents))
+    return false;
+  std::vector<std::string> fields = base::SplitString(
+      contents, " ", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  if (fields.size() != 3 || !base::StringToUint64(fields[1], &record->size) ||
+      !base::StringToInt64(fields[2], &last_modified))
+    return false;
+  record->digest = fields[0];
+  record->last_modified = base::Time::FromDeltaSinceWindowsEpoch(
+      base::TimeDelta::FromMicroseconds(last_modified));
+  return true;
+}
+
+// Writes |record| for the entry at |path|, before the entry is published.
+bool WriteRecord(const base::FilePath& path, const EntryRecord& record) {
+  std::string contents = base::StringPrintf(
+      "%s %" PRIu64 " %" PRId64, record.digest.c_str(), record.size,
+      record.last_modified.ToDeltaSinceWindowsEpoch().InMicroseconds());
+  base::FilePath temp_path;
+  if (!base::CreateTemporaryFileInDir(path.DirName(), &temp_path))
+    return false;
+  base::File file(temp_path, base::File::FLAG_OPEN | base::File::FLAG_WRITE);
+  bool written = file.IsValid() &&
+                 file.WriteAtCurrentPos(contents.data(), contents.size()) ==
+                     static_cast<int>(contents.size()) &&
+                 file.Flush();
+  file.Close();
+  if (!written || !base::ReplaceFile(temp_path, DigestPath(path), nullptr)) {
+    base::DeleteFile(temp_path, false);
+    return false;
+  }
+  return true;
+}
+
+// The digest is checked once, when the entry is published. Later an entry
+// whose size and modification time still match its record is taken as is;
+// anything else was changed since, and is hashed again. An entry that still
+// matches its digest gets a new record, so the next check is cheap again.
+bool IsPublished(const base::FilePath& path, uint64_t size) {
+  EntryRecord record;
+  base::File::Info info;
+  if (!ReadRecord(path, &record) || record.size != size ||
+      !base::GetFileInfo(path, &info) || info.is_directory ||
+      static_cast<uint64_t>(info.size) != size)
+    return false;
+  if (info.last_modified == record.last_modified)
+    return true;
+
+  std::string digest;
+  if (!HashFile(path, &digest) || digest != record.digest)
+    return false;
+  record.last_modified = info.last_modified;
+  WriteRecord(path, record);
+  return true;
+}
+
+}  // namespace
+
+void SetExtractionCacheDirectory(const base::FilePath& cache_dir) {
+  ExtractionCacheState& state = g_extraction_cache.Get();
+  base::AutoLock auto_lock(state.lock);
+  state.dir = cache_dir;
+}
+
+bool ExtractToCache(base::File* src,
+                    const std::string& archive_id,
+                    const base::FilePath::StringType& ext,
+                    uint64_t offset,
+                    uint64_t size,
+                    bool executable,
+                    base::FilePath* out) {
+  if (!src->IsValid())
+    return false;
+
+  base::FilePath cache_dir;
+  bool collect_garbage = false;
+  {
+    ExtractionCacheState& state = g_extraction_cache.Get();
+    base::AutoLock auto_lock(state.lock);
+    if (state.dir.empty())
+      return false;
+    cache_dir = state.dir;
+    collect_garbage = !state.collected_garbage;
+    state.collected_garbage = true;
+  }
+
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  if (collect_garbage)
+    CollectGarbage(cache_dir);
+
+  std::string name = base::MD5String(base::StringPrintf(
+      "%s:%" PRIu64 ":%" PRIu64, archive_id.c_str(), offset, size));
+  base::FilePath path = cache_dir.AppendASCII(name).AddExtension(ext);
+
+  if (IsPublished(path, size)) {
+    TouchCachedFile(path);
+    *out = path;
+    return true;
+  }
+
+  base::FilePath temp_path;
+  if (!base::CreateDirectory(cache_dir) ||
+      !base::CreateTemporaryFileInDir(cache_dir, &temp_path))
+    return false;
+
+  std::string digest;
+  if (!CopyRange(src, offset, size, temp_path, &digest)) {
+    base::DeleteFile(temp_path, false);
+    return false;
+  }
+
+#if defined(OS_POSIX)
+  if (executable) {
+    // chmod a+x temp_path;
+    base::SetPosixFilePermissions(temp_path, 0755);
+  }
+#endif
+
+  // The rename keeps the modification time, so the record can carry it as
+  // the file system stored it.
+  EntryRecord record;
+  base::File::Info info;
+  record.digest = digest;
+  record.size = size;
+  if (!base::GetFileInfo(temp_path, &info)) {
+    base::DeleteFile(temp_path, false);
+    return false;
+  }
+  record.last_modified = info.last_modified;
+
+  if (!WriteRecord(path, record) ||
+      !base::ReplaceFile(temp_path, path, nullptr)) {
+    base::DeleteFile(temp_path, false);
+    // Another process may have published the same entry meanwhile, and on
+    // Windows it can not be replaced while that process has it loaded.
+    if (!IsPublished(path, size)) {
+      LOG(WARNING) << "Failed to publish " << path.value();
+      return false;
+    }
+  }
+
+  *out = path;
+  return true;
+}
+
+bool TouchCachedFile(const base::FilePath& path) {
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  // Touching the entry itself would make the next check hash it again.
+  base::Time now = base::Time::Now();
+  return base::PathExists(path) &&
+         base::TouchFile(DigestPath(path), now, now);
+}
+
+}  // namespace asar
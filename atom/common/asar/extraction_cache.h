@@ -0,0 +1,46 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_ASAR_EXTRACTION_CACHE_H_
+#define ATOM_COMMON_ASAR_EXTRACTION_CACHE_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "base/files/file_path.h"
+
+namespace base {
+class File;
+}
+
+namespace asar {
+
+// Sets the directory where files copied out of archives are persisted, so
+// they are extracted once and then shared by all processes and launches.
+// Must be called before any archive is opened; disabled by default.
+void SetExtractionCacheDirectory(const base::FilePath& cache_dir);
+
+// Gets the persisted copy of the |size| bytes at |offset| of |src|,
+// extracting it first if needed. |archive_id| must change whenever the
+// archive does. Entries are flushed and published with an atomic rename,
+// together with a digest of their contents. An entry is reused as is while
+// its size and modification time match what was published, and hashed again
+// otherwise. Entries unused for a month are removed. Returns false if the
+// cache is disabled or the file could not be extracted.
+bool ExtractToCache(base::File* src,
+                    const std::string& archive_id,
+                    const base::FilePath::StringType& ext,
+                    uint64_t offset,
+                    uint64_t size,
+                    bool executable,
+                    base::FilePath* out);
+
+// Marks the entry at |path|, handed out by ExtractToCache() earlier, as still
+// in use so it is not collected. Returns false if it is gone.
+bool TouchCachedFile(const base::FilePath& path);
+
+}  // namespace asar
+
+#endif  // ATOM_COMMON_ASAR_EXTRACTION_CACHE_H_
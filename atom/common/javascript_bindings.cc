@@ -4,6 +4,8 @@
 
 #include "atom/common/javascript_bindings.h"
 
+#include <tuple>
+#include <utility>
 #include <vector>
 #include "atom/common/api/api_messages.h"
 #include "atom/common/api/atom_api_key_weak_map.h"
@@ -14,6 +16,9 @@
 #include "base/memory/shared_memory.h"
 #include "base/memory/shared_memory_handle.h"
 #include "brave/common/extensions/shared_memory_bindings.h"
+#include "brave/common/extensions/shared_memory_ring.h"
+#include "brave/common/extensions/structured_clone.h"
+#include "brave/common/workers/worker_message.h"
 #include "content/public/renderer/render_frame.h"
 #include "extensions/renderer/console.h"
 #include "native_mate/dictionary.h"
@@ -26,6 +31,9 @@ namespace atom {
 
 namespace {
 
+// Rings of different script contexts of a frame are told apart by id.
+int g_next_ring_id = 0;
+
 std::vector<v8::Local<v8::Value>> ListValueToVector(v8::Isolate* isolate,
                                                 const base::ListValue& list) {
   v8::Local<v8::Value> array = mate::ConvertToV8(isolate, list);
@@ -39,9 +47,20 @@ std::vector<v8::Local<v8::Value>> ListValueToVector(v8::Isolate* isolate,
 JavascriptBindings::JavascriptBindings(content::RenderFrame* render_frame,
                                        extensions::ScriptContext* context)
     : content::RenderFrameObserver(render_frame),
-      extensions::ObjectBackedNativeHandler(context) {}
+      extensions::ObjectBackedNativeHandler(context),
+      send_ring_id_(++g_next_ring_id),
+      receive_ring_id_(++g_next_ring_id) {}
 
-JavascriptBindings::~JavascriptBindings() {}
+JavascriptBindings::~JavascriptBindings() {
+  CloseRings();
+  ClosePorts();
+}
+
+void JavascriptBindings::Invalidate() {
+  CloseRings();
+  ClosePorts();
+  extensions::ObjectBackedNativeHandler::Invalidate();
+}
 
 void JavascriptBindings::AddRoutes() {
   RouteHandlerFunction(
@@ -141,6 +160,24 @@ void JavascriptBindings::IPCSend(mate::Arguments* args,
     args->ThrowError("Unable to send AtomViewHostMsg_Message");
 }
 
+void JavascriptBindings::IPCSendCloned(mate::Arguments* args,
+          const base::string16& channel,
+          v8::Local<v8::Value> arguments) {
+  if (!is_valid() || !render_frame())
+    return;
+
+  // Throws on failure.
+  std::vector<uint8_t> data;
+  if (!brave::SerializeValue(args->isolate(), arguments, &data))
+    return;
+
+  bool success = Send(new AtomViewHostMsg_Message_Cloned(
+      routing_id(), channel, data));
+
+  if (!success)
+    args->ThrowError("Unable to send AtomViewHostMsg_Message_Cloned");
+}
+
 void JavascriptBindings::IPCSendShared(mate::Arguments* args,
             const base::string16& channel,
             base::SharedMemory* shared_memory) {
@@ -162,6 +199,90 @@ void JavascriptBindings::IPCSendShared(mate::Arguments* args,
     args->ThrowError("Unable to send AtomViewHostMsg_Message_Shared");
 }
 
+bool JavascriptBindings::IPCSendRing(mate::Arguments* args,
+            const base::string16& channel,
+            v8::Local<v8::Value> value) {
+  if (!is_valid() || !render_frame())
+    return false;
+
+  if (!send_ring_) {
+    std::unique_ptr<brave::SharedMemoryRing> ring =
+        brave::SharedMemoryRing::Create(
+            brave::SharedMemoryRing::kDefaultCapacity);
+    base::SharedMemoryHandle handle;
+    if (ring)
+      handle = ring->ShareHandle();
+    if (!handle.IsValid()) {
+      args->ThrowError("Could not create shared memory ring");
+      return false;
+    }
+    Send(new AtomViewHostMsg_SetupRing(
+        routing_id(), send_ring_id_, handle, ring->capacity()));
+    send_ring_ = std::move(ring);
+  }
+
+  uint64_t sequence;
+  uint64_t position;
+  uint32_t size;
+  v8::TryCatch try_catch(args->isolate());
+  if (!send_ring_->Write(args->isolate(), value, &sequence, &position,
+                         &size)) {
+    // Either the value can't be serialized, or the browser has not caught up
+    // yet and the caller should back off.
+    if (try_catch.HasCaught())
+      try_catch.ReThrow();
+    return false;
+  }
+
+  bool success = Send(new AtomViewHostMsg_Message_Ring(
+      routing_id(), send_ring_id_, channel, sequence, position, size));
+  if (!success)
+    args->ThrowError("Unable to send AtomViewHostMsg_Message_Ring");
+  return success;
+}
+
+void JavascriptBindings::OpenReceiveRing() {
+  if (receive_ring_ || !render_frame())
+    return;
+
+  // Like shared memory messages, messages from the browser's ring go to a
+  // single context of the frame.
+  auto context_type = context()->effective_context_type();
+  if (context_type != Feature::WEBUI_CONTEXT &&
+      context_type != Feature::BLESSED_EXTENSION_CONTEXT)
+    return;
+
+  std::unique_ptr<brave::SharedMemoryRing> ring =
+      brave::SharedMemoryRing::Create(
+          brave::SharedMemoryRing::kDefaultCapacity);
+  if (!ring)
+    return;
+  base::SharedMemoryHandle handle = ring->ShareHandle();
+  if (!handle.IsValid())
+    return;
+  if (Send(new AtomViewHostMsg_SetupBrowserRing(
+          routing_id(), receive_ring_id_, handle, ring->capacity())))
+    receive_ring_ = std::move(ring);
+}
+
+void JavascriptBindings::CloseRings() {
+  // The browser drops anything still in flight along with the rings.
+  if (send_ring_)
+    Send(new AtomViewHostMsg_CloseRing(routing_id(), send_ring_id_));
+  if (receive_ring_)
+    Send(new AtomViewHostMsg_CloseRing(routing_id(), receive_ring_id_));
+  send_ring_.reset();
+  receive_ring_.reset();
+}
+
+void JavascriptBindings::ClosePorts() {
+  // Otherwise the browser keeps the channels until the process goes away,
+  // and the other ends never learn that this context is gone.
+  for (const auto& it : ports_)
+    Send(new AtomViewHostMsg_ClosePort(routing_id(), it.first));
+  ports_.clear();
+}
+
 base::string16 JavascriptBindings::IPCSendSync(mate::Arguments* args,
                         const base::string16& channel,
                         const base::ListValue& arguments) {
@@ -189,13 +310,19 @@ void JavascriptBindings::GetBinding(
   v8::Isolate* isolate = args.GetIsolate();
   mate::Dictionary binding(isolate, v8::Object::New(isolate));
 
+  OpenReceiveRing();
+
   mate::Dictionary ipc(isolate, v8::Object::New(isolate));
   ipc.SetMethod("send", base::Bind(&JavascriptBindings::IPCSend,
       base::Unretained(this)));
   ipc.SetMethod("sendSync", base::Bind(&JavascriptBindings::IPCSendSync,
       base::Unretained(this)));
+  ipc.SetMethod("sendCloned", base::Bind(&JavascriptBindings::IPCSendCloned,
+      base::Unretained(this)));
   ipc.SetMethod("sendShared", base::Bind(&JavascriptBindings::IPCSendShared,
       base::Unretained(this)));
+  ipc.SetMethod("sendRing", base::Bind(&JavascriptBindings::IPCSendRing,
+      base::Unretained(this)));
   binding.Set("ipc", ipc.GetHandle());
 
   mate::Dictionary v8(isolate, v8::Object::New(isolate));
@@ -224,6 +351,17 @@ bool JavascriptBindings::OnMessageReceived(const IPC::Message& message) {
   if (!is_valid())
     return false;
 
+  // Only the context that owns the ring can read the message.
+  if (message.type() == AtomViewMsg_Message_Ring::ID) {
+    AtomViewMsg_Message_Ring::Param params;
+    if (!receive_ring_ || !AtomViewMsg_Message_Ring::Read(&message, &params) ||
+        std::get<0>(params) != receive_ring_id_)
+      return false;
+    OnRingBrowserMessage(std::get<1>(params), std::get<2>(params),
+                         std::get<3>(params), std::get<4>(params));
+    return true;
+  }
+
   auto context_type = context()->effective_context_type();
 
   // never handle ipc messages in a web page context
@@ -239,6 +377,9 @@ bool JavascriptBindings::OnMessageReceived(const IPC::Message& message) {
       context_type == Feature::BLESSED_EXTENSION_CONTEXT) {
     IPC_BEGIN_MESSAGE_MAP(JavascriptBindings, message)
       IPC_MESSAGE_HANDLER(AtomViewMsg_Message_Shared, OnSharedBrowserMessage)
+      IPC_MESSAGE_HANDLER(AtomViewMsg_ConnectPort, OnConnectPort)
+      IPC_MESSAGE_HANDLER(AtomViewMsg_PortMessage, OnPortMessage)
+      IPC_MESSAGE_HANDLER(AtomViewMsg_PortClosed, OnPortClosed)
       IPC_MESSAGE_UNHANDLED(handled = false)
     IPC_END_MESSAGE_MAP()
   }
@@ -246,6 +387,7 @@ bool JavascriptBindings::OnMessageReceived(const IPC::Message& message) {
 
   IPC_BEGIN_MESSAGE_MAP(JavascriptBindings, message)
     IPC_MESSAGE_HANDLER(AtomViewMsg_Message, OnBrowserMessage)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_Message_Cloned, OnClonedBrowserMessage)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
 
@@ -286,6 +428,149 @@ void JavascriptBindings::OnSharedBrowserMessage(const base::string16& channel,
                                   &concatenated_args.front());
 }
 
+void JavascriptBindings::OnRingBrowserMessage(const base::string16& channel,
+                                              uint64_t sequence,
+                                              uint64_t position,
+                                              uint32_t size) {
+  v8::Isolate* isolate = context()->isolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(context()->v8_context());
+
+  // Read() frees the space of the record even if it can't be deserialized.
+  v8::Local<v8::Value> value;
+  if (!receive_ring_->Read(isolate, sequence, position, size).ToLocal(&value))
+    return;
+
+  // Insert the Event object, event.sender is ipc
+  mate::Dictionary event = mate::Dictionary::CreateEmpty(isolate);
+  std::vector<v8::Local<v8::Value>> args = {
+      mate::StringToV8(isolate, channel), event.GetHandle(), value };
+  context()->module_system()->CallModuleMethodSafe("ipc_utils",
+                                  "emit",
+                                  args.size(),
+                                  &args.front());
+}
+
+void JavascriptBindings::OnConnectPort(int port_id) {
+  if (!is_valid())
+    return;
+
+  v8::Isolate* isolate = context()->isolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(context()->v8_context());
+
+  mate::Dictionary port = mate::Dictionary::CreateEmpty(isolate);
+  port.SetMethod("postMessage", base::Bind(&JavascriptBindings::PortPostMessage,
+      base::Unretained(this), port_id));
+  port.SetMethod("close", base::Bind(&JavascriptBindings::PortClose,
+      base::Unretained(this), port_id));
+  port.Set("onmessage", v8::Local<v8::Value>(v8::Null(isolate)));
+  port.Set("onclose", v8::Local<v8::Value>(v8::Null(isolate)));
+  ports_[port_id].Reset(isolate, port.GetHandle());
+
+  // Insert the Event object, event.ports has the new port
+  mate::Dictionary event = mate::Dictionary::CreateEmpty(isolate);
+  std::vector<v8::Local<v8::Object>> ports = { port.GetHandle() };
+  event.Set("ports", ports);
+
+  std::vector<v8::Local<v8::Value>> args = {
+      mate::StringToV8(isolate, "ipc-message-port"), event.GetHandle() };
+  context()->module_system()->CallModuleMethodSafe("ipc_utils",
+                                  "emit",
+                                  args.size(),
+                                  &args.front());
+}
+
+void JavascriptBindings::OnPortMessage(
+    int port_id,
+    const std::vector<uint8_t>& data,
+    const std::vector<std::vector<uint8_t>>& array_buffers) {
+  auto it = ports_.find(port_id);
+  if (!is_valid() || it == ports_.end())
+    return;
+
+  v8::Isolate* isolate = context()->isolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Context> v8_context = context()->v8_context();
+  v8::Context::Scope context_scope(v8_context);
+
+  v8::Local<v8::Value> value;
+  if (!brave::WorkerMessage::FromWire(data, array_buffers)->
+          Deserialize(isolate).ToLocal(&value))
+    return;
+
+  v8::Local<v8::Object> port = it->second.Get(isolate);
+  v8::Local<v8::Value> onmessage;
+  if (!port->Get(v8_context, mate::StringToV8(isolate, "onmessage"))
+           .ToLocal(&onmessage) ||
+      !onmessage->IsFunction())
+    return;
+
+  mate::Dictionary event = mate::Dictionary::CreateEmpty(isolate);
+  event.Set("data", value);
+  v8::Local<v8::Value> argv[] = { event.GetHandle() };
+  context()->SafeCallFunction(onmessage.As<v8::Function>(), 1, argv);
+}
+
+void JavascriptBindings::OnPortClosed(int port_id) {
+  auto it = ports_.find(port_id);
+  if (!is_valid() || it == ports_.end())
+    return;
+
+  v8::Isolate* isolate = context()->isolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Context> v8_context = context()->v8_context();
+  v8::Context::Scope context_scope(v8_context);
+
+  // The browser already forgot the channel, so there is nothing to close.
+  v8::Local<v8::Object> port = it->second.Get(isolate);
+  ports_.erase(it);
+
+  v8::Local<v8::Value> onclose;
+  if (!port->Get(v8_context, mate::StringToV8(isolate, "onclose"))
+           .ToLocal(&onclose) ||
+      !onclose->IsFunction())
+    return;
+
+  mate::Dictionary event = mate::Dictionary::CreateEmpty(isolate);
+  v8::Local<v8::Value> argv[] = { event.GetHandle() };
+  context()->SafeCallFunction(onclose.As<v8::Function>(), 1, argv);
+}
+
+void JavascriptBindings::PortPostMessage(int port_id, mate::Arguments* args) {
+  if (!is_valid() || !render_frame() || !ports_.count(port_id))
+    return;
+
+  v8::Local<v8::Value> message;
+  if (!args->GetNext(&message)) {
+    args->ThrowError("`message` is a required field");
+    return;
+  }
+
+  // The message is copied to the browser process anyway, so ArrayBuffers are
+  // never transferred out of the renderer and any transfer list is ignored.
+  // Throws on failure.
+  brave::WorkerMessage worker_message;
+  if (!worker_message.Serialize(args->isolate(), message,
+                                v8::Undefined(args->isolate())))
+    return;
+
+  std::vector<uint8_t> data;
+  std::vector<std::vector<uint8_t>> array_buffers;
+  if (!worker_message.ToWire(&data, &array_buffers)) {
+    args->ThrowError("SharedArrayBuffers can not be sent from a renderer");
+    return;
+  }
+  Send(new AtomViewHostMsg_PortMessage(
+      routing_id(), port_id, data, array_buffers));
+}
+
+void JavascriptBindings::PortClose(int port_id) {
+  if (!ports_.erase(port_id) || !render_frame())
+    return;
+  Send(new AtomViewHostMsg_ClosePort(routing_id(), port_id));
+}
+
 void JavascriptBindings::OnBrowserMessage(const base::string16& channel,
                                           const base::ListValue& args) {
   if (!context()->is_valid())
@@ -299,7 +584,36 @@ void JavascriptBindings::OnBrowserMessage(const base::string16& channel,
   v8::HandleScope handle_scope(isolate);
   v8::Context::Scope context_scope(context()->v8_context());
 
-  auto args_vector = ListValueToVector(isolate, args);
+  EmitBrowserMessage(channel, ListValueToVector(isolate, args));
+}
+
+void JavascriptBindings::OnClonedBrowserMessage(
+    const base::string16& channel,
+    const std::vector<uint8_t>& data) {
+  if (!context()->is_valid())
+    return;
+
+  auto context_type = context()->effective_context_type();
+  if (context_type == Feature::WEB_PAGE_CONTEXT)
+    return;
+
+  v8::Isolate* isolate = context()->isolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(context()->v8_context());
+
+  v8::Local<v8::Value> args;
+  std::vector<v8::Local<v8::Value>> args_vector;
+  if (!brave::DeserializeValue(isolate, data).ToLocal(&args) ||
+      !mate::ConvertFromV8(isolate, args, &args_vector))
+    return;
+
+  EmitBrowserMessage(channel, std::move(args_vector));
+}
+
+void JavascriptBindings::EmitBrowserMessage(
+    const base::string16& channel,
+    std::vector<v8::Local<v8::Value>> args_vector) {
+  v8::Isolate* isolate = context()->isolate();
 
   // Insert the Event object, event.sender is ipc
   mate::Dictionary event = mate::Dictionary::CreateEmpty(isolate);
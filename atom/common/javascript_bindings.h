@@ -5,6 +5,12 @@
 #ifndef ATOM_COMMON_JAVASCRIPT_BINDINGS_H_
 #define ATOM_COMMON_JAVASCRIPT_BINDINGS_H_
 
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
 #include "content/public/renderer/render_frame_observer.h"
 #include "extensions/renderer/object_backed_native_handler.h"
 #include "extensions/renderer/script_context.h"
@@ -15,6 +21,10 @@ class SharedMemory;
 class SharedMemoryHandle;
 }
 
+namespace brave {
+class SharedMemoryRing;
+}
+
 namespace mate {
 class Arguments;
 }
@@ -31,17 +41,30 @@ class JavascriptBindings : public content::RenderFrameObserver,
   void GetBinding(const v8::FunctionCallbackInfo<v8::Value>& args);
 
   void AddRoutes() override;
+  void Invalidate() override;
 
  private:
   void IPCSendShared(mate::Arguments* args,
             const base::string16& channel,
             base::SharedMemory* shared_memory);
+  bool IPCSendRing(mate::Arguments* args,
+            const base::string16& channel,
+            v8::Local<v8::Value> value);
+  // Hands the browser a ring to send messages to this context in.
+  void OpenReceiveRing();
+  // Tells the browser that the rings of this context are gone.
+  void CloseRings();
+  // Closes the channels of the ports of this context.
+  void ClosePorts();
   base::string16 IPCSendSync(mate::Arguments* args,
                         const base::string16& channel,
                         const base::ListValue& arguments);
   void IPCSend(mate::Arguments* args,
                         const base::string16& channel,
                         const base::ListValue& arguments);
+  void IPCSendCloned(mate::Arguments* args,
+                     const base::string16& channel,
+                     v8::Local<v8::Value> arguments);
   v8::Local<v8::Value> GetHiddenValue(v8::Isolate* isolate,
                                     v8::Local<v8::String> key);
   void SetHiddenValue(v8::Isolate* isolate,
@@ -66,8 +89,34 @@ class JavascriptBindings : public content::RenderFrameObserver,
   bool OnMessageReceived(const IPC::Message& message) override;
   void OnBrowserMessage(const base::string16& channel,
                         const base::ListValue& args);
+  void OnClonedBrowserMessage(const base::string16& channel,
+                              const std::vector<uint8_t>& data);
+  void EmitBrowserMessage(const base::string16& channel,
+                          std::vector<v8::Local<v8::Value>> args_vector);
   void OnSharedBrowserMessage(const base::string16& channel,
                               const base::SharedMemoryHandle& handle);
+  void OnRingBrowserMessage(const base::string16& channel,
+                            uint64_t sequence,
+                            uint64_t position,
+                            uint32_t size);
+  void OnConnectPort(int port_id);
+  void OnPortMessage(int port_id,
+                     const std::vector<uint8_t>& data,
+                     const std::vector<std::vector<uint8_t>>& array_buffers);
+  void OnPortClosed(int port_id);
+  void PortPostMessage(int port_id, mate::Arguments* args);
+  void PortClose(int port_id);
+
+  // The shared memory rings to and from the browser. They live as long as
+  // the script context; the one to the browser is created on first use, the
+  // one from the browser along with the ipc binding.
+  int send_ring_id_;
+  std::unique_ptr<brave::SharedMemoryRing> send_ring_;
+  int receive_ring_id_;
+  std::unique_ptr<brave::SharedMemoryRing> receive_ring_;
+
+  // The message ports handed to the frame, by id.
+  std::map<int, v8::Global<v8::Object>> ports_;
 
   DISALLOW_COPY_AND_ASSIGN(JavascriptBindings);
 };
@@ -0,0 +1,174 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/renderer/content_setting_rule_index.h"
+
+#include <algorithm>
+
+#include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
+#include "base/values.h"
+#include "url/gurl.h"
+#include "url/url_constants.h"
+
+namespace atom {
+
+namespace {
+
+const char kDomainWildcard[] = "[*.]";
+const char kFirstPartyPattern[] = "[firstParty]";
+
+// Extracts the host of |pattern| from its canonical string form. Returns
+// false for patterns that can't be keyed by host, e.g. "*", file:// patterns
+// or IP literals, which are left to the slow path.
+bool GetPatternHost(const ContentSettingsPattern& pattern,
+                    std::string* host,
+                    bool* domain_wildcard) {
+  std::string str = pattern.ToString();
+  base::StringPiece rest(str);
+
+  size_t scheme_end = rest.find(url::kStandardSchemeSeparator);
+  if (scheme_end != base::StringPiece::npos) {
+    if (rest.substr(0, scheme_end) == url::kFileScheme)
+      return false;
+    rest.remove_prefix(scheme_end + strlen(url::kStandardSchemeSeparator));
+  }
+
+  *domain_wildcard = rest.starts_with(kDomainWildcard);
+  if (*domain_wildcard)
+    rest.remove_prefix(strlen(kDomainWildcard));
+
+  rest = rest.substr(0, rest.find_first_of(":/"));
+  if (rest.empty() || rest.ends_with(".") ||
+      rest.find_first_of("[]*") != base::StringPiece::npos)
+    return false;
+
+  *host = base::ToLowerASCII(rest);
+  return true;
+}
+
+}  // namespace
+
+ContentSettingRuleIndex::ContentSettingRuleIndex(const base::ListValue& rules)
+    : size_(0) {
+  size_t order = 0;
+  for (const auto& value : rules.GetList()) {
+    const base::DictionaryValue* dict;
+    std::string primary_string;
+    std::string setting_string;
+    if (!value.GetAsDictionary(&dict) ||
+        !dict->GetString("primaryPattern", &primary_string) ||
+        !dict->GetString("setting", &setting_string)) {
+      // skip invalid entries
+      // TODO(bridiver) should also send an ipc error message
+      continue;
+    }
+
+    Rule rule;
+    rule.order = order++;
+    rule.primary_pattern = ContentSettingsPattern::FromString(primary_string);
+    // An invalid pattern never matches anything.
+    if (!rule.primary_pattern.IsValid())
+      continue;
+
+    std::string secondary_string;
+    dict->GetString("secondaryPattern", &secondary_string);
+    rule.has_secondary_pattern = !secondary_string.empty();
+    rule.first_party = secondary_string == kFirstPartyPattern;
+    if (rule.has_secondary_pattern && !rule.first_party) {
+      rule.secondary_pattern =
+          ContentSettingsPattern::FromString(secondary_string);
+    }
+
+    if (setting_string != "block" && setting_string != "deny")
+      rule.setting = CONTENT_SETTING_ALLOW;
+    else
+      rule.setting = CONTENT_SETTING_BLOCK;
+
+    std::string host;
+    bool domain_wildcard = false;
+    if (!GetPatternHost(rule.primary_pattern, &host, &domain_wildcard))
+      generic_.push_back(rule);
+    else if (domain_wildcard)
+      domain_hosts_[host].push_back(rule);
+    else
+      exact_hosts_[host].push_back(rule);
+    ++size_;
+  }
+
+  // Rules were appended in list order, so reversing each bucket puts the
+  // winning candidates first.
+  std::reverse(generic_.begin(), generic_.end());
+  for (auto& it : exact_hosts_)
+    std::reverse(it.second.begin(), it.second.end());
+  for (auto& it : domain_hosts_)
+    std::reverse(it.second.begin(), it.second.end());
+}
+
+ContentSettingRuleIndex::~ContentSettingRuleIndex() {
+}
+
+// static
+const ContentSettingRuleIndex::Rule* ContentSettingRuleIndex::FindInList(
+    const RuleList& rules,
+    const GURL& primary_url,
+    const GURL& secondary_url) {
+  for (const auto& rule : rules) {
+    if (!rule.primary_pattern.Matches(primary_url))
+      continue;
+    if (rule.first_party) {
+      // Same as matching "[*.]" + the primary host.
+      const std::string primary_host = primary_url.HostNoBrackets();
+      if (primary_host.empty() || !secondary_url.DomainIs(primary_host))
+        continue;
+    } else if (rule.has_secondary_pattern &&
+               !rule.secondary_pattern.Matches(secondary_url)) {
+      continue;
+    }
+    return &rule;
+  }
+  return nullptr;
+}
+
+// static
+void ContentSettingRuleIndex::Pick(const Rule* candidate, const Rule** best) {
+  if (candidate && (!*best || candidate->order > (*best)->order))
+    *best = candidate;
+}
+
+bool ContentSettingRuleIndex::GetSetting(const GURL& primary_url,
+                                         const GURL& secondary_url,
+                                         ContentSetting* setting) const {
+  const Rule* best = nullptr;
+  Pick(FindInList(generic_, primary_url, secondary_url), &best);
+
+  std::string host = primary_url.host();
+  if (base::EndsWith(host, ".", base::CompareCase::SENSITIVE))
+    host.pop_back();
+
+  if (!host.empty()) {
+    auto it = exact_hosts_.find(host);
+    if (it != exact_hosts_.end())
+      Pick(FindInList(it->second, primary_url, secondary_url), &best);
+
+    // Try "a.b.c", then "b.c", then "c".
+    size_t pos = 0;
+    while (!domain_hosts_.empty()) {
+      it = domain_hosts_.find(host.substr(pos));
+      if (it != domain_hosts_.end())
+        Pick(FindInList(it->second, primary_url, secondary_url), &best);
+      pos = host.find('.', pos);
+      if (pos == std::string::npos)
+        break;
+      ++pos;
+    }
+  }
+
+  if (!best)
+    return false;
+  *setting = best->setting;
+  return true;
+}
+
+}  // namespace atom
@@ -0,0 +1,82 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_RENDERER_CONTENT_SETTING_RULE_INDEX_H_
+#define ATOM_RENDERER_CONTENT_SETTING_RULE_INDEX_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/macros.h"
+#include "components/content_settings/core/common/content_settings.h"
+#include "components/content_settings/core/common/content_settings_pattern.h"
+
+class GURL;
+
+namespace base {
+class ListValue;
+}
+
+namespace atom {
+
+// The content setting rules of one content type, compiled for lookup.
+//
+// The browser sends rules as a list of dictionaries in which the last
+// matching rule wins. Their patterns are parsed once here, and rules whose
+// primary pattern names a host are bucketed by that host. A lookup then only
+// tests the rules for the primary URL's host and its parent domains, plus the
+// rules that can not be keyed by host, e.g. "*".
+class ContentSettingRuleIndex {
+ public:
+  explicit ContentSettingRuleIndex(const base::ListValue& rules);
+  ~ContentSettingRuleIndex();
+
+  // Sets |setting| from the last rule matching the URLs. Returns false if no
+  // rule matches.
+  bool GetSetting(const GURL& primary_url,
+                  const GURL& secondary_url,
+                  ContentSetting* setting) const;
+
+  size_t size() const { return size_; }
+
+ private:
+  struct Rule {
+    // Position in the list sent by the browser, later rules win.
+    size_t order;
+    ContentSettingsPattern primary_pattern;
+    // Only tested when |has_secondary_pattern| is set.
+    ContentSettingsPattern secondary_pattern;
+    bool has_secondary_pattern;
+    // The secondary pattern is "[firstParty]", i.e. the secondary URL must be
+    // on the primary URL's domain.
+    bool first_party;
+    ContentSetting setting;
+  };
+
+  // Sorted by descending |order|.
+  using RuleList = std::vector<Rule>;
+  using HostMap = std::unordered_map<std::string, RuleList>;
+
+  // Returns the first rule of |rules| matching the URLs.
+  static const Rule* FindInList(const RuleList& rules,
+                                const GURL& primary_url,
+                                const GURL& secondary_url);
+  static void Pick(const Rule* candidate, const Rule** best);
+
+  // Rules whose primary pattern matches exactly one host.
+  HostMap exact_hosts_;
+  // "[*.]host" rules, keyed by host.
+  HostMap domain_hosts_;
+  // Rules that can not be keyed by host.
+  RuleList generic_;
+
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(ContentSettingRuleIndex);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_RENDERER_CONTENT_SETTING_RULE_INDEX_H_
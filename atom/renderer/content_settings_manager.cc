@@ -4,11 +4,12 @@
 
 #include "atom/renderer/content_settings_manager.h"
 
+#include <set>
 #include <string>
 #include <vector>
 #include "atom/common/api/api_messages.h"
+#include "atom/renderer/content_setting_rule_index.h"
 #include "base/values.h"
-#include "components/content_settings/core/common/content_settings_pattern.h"
 #include "content/public/common/url_constants.h"
 #include "content/public/renderer/render_thread.h"
 #include "third_party/blink/public/web/web_document.h"
@@ -18,7 +19,9 @@
 
 namespace atom {
 
-ContentSettingsManager::ContentSettingsManager() {
+ContentSettingsManager::ContentSettingsManager()
+    : version_(0),
+      generation_(0) {
   content::RenderThread::Get()->AddObserver(this);
 }
 
@@ -52,6 +55,8 @@ bool ContentSettingsManager::OnControlMessageReceived(
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(ContentSettingsManager, message)
     IPC_MESSAGE_HANDLER(AtomMsg_UpdateContentSettings, OnUpdateContentSettings)
+    IPC_MESSAGE_HANDLER(AtomMsg_UpdateContentSettingsDelta,
+                        OnUpdateContentSettingsDelta)
     IPC_MESSAGE_HANDLER(AtomMsg_UpdateWebKitPrefs, OnUpdateWebKitPrefs)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
@@ -61,11 +66,107 @@ bool ContentSettingsManager::OnControlMessageReceived(
 void ContentSettingsManager::OnUpdateWebKitPrefs(
     const content::WebPreferences& web_preferences) {
   web_preferences_ = content::WebPreferences(web_preferences);
+  ++generation_;
 }
 
 void ContentSettingsManager::OnUpdateContentSettings(
-    const base::DictionaryValue& content_settings) {
+    const base::DictionaryValue& content_settings,
+    uint64_t version) {
   content_settings_ = content_settings.CreateDeepCopy();
+  version_ = version;
+
+  // Compile the rules once here rather than parsing patterns on every lookup.
+  rules_.clear();
+  for (base::DictionaryValue::Iterator it(*content_settings_);
+       !it.IsAtEnd();
+       it.Advance()) {
+    RebuildRules(it.key());
+  }
+  ++generation_;
+}
+
+void ContentSettingsManager::OnUpdateContentSettingsDelta(
+    uint64_t base_version,
+    uint64_t version,
+    const base::ListValue& operations) {
+  bool applied = content_settings_ && base_version == version_;
+  std::set<std::string> changed_types;
+  if (applied) {
+    for (const auto& operation : operations.GetList()) {
+      if (!ApplyOperation(operation, &changed_types)) {
+        applied = false;
+        break;
+      }
+    }
+  }
+
+  for (const auto& content_type : changed_types)
+    RebuildRules(content_type);
+  ++generation_;
+
+  if (applied) {
+    version_ = version;
+  } else {
+    // Out of sync, possibly with some operations applied. Keep going with
+    // these rules until the browser sends the full settings.
+    version_ = 0;
+    content::RenderThread::Get()->Send(
+        new AtomHostMsg_RequestContentSettings());
+  }
+}
+
+bool ContentSettingsManager::ApplyOperation(
+    const base::Value& operation,
+    std::set<std::string>* changed_types) {
+  const base::Value* op_value =
+      operation.FindKeyOfType("op", base::Value::Type::STRING);
+  const base::Value* type_value =
+      operation.FindKeyOfType("contentType", base::Value::Type::STRING);
+  const base::Value* index_value =
+      operation.FindKeyOfType("index", base::Value::Type::INTEGER);
+  if (!op_value || !type_value || !index_value || index_value->GetInt() < 0)
+    return false;
+  const std::string& op = op_value->GetString();
+  const std::string& content_type = type_value->GetString();
+  size_t index = index_value->GetInt();
+
+  base::Value* rules = content_settings_->FindKey(content_type);
+  if (!rules) {
+    rules = content_settings_->SetKey(content_type,
+                                      base::Value(base::Value::Type::LIST));
+  }
+  if (!rules->is_list())
+    return false;
+  base::Value::ListStorage& list = rules->GetList();
+  changed_types->insert(content_type);
+
+  if (op == "remove") {
+    if (index >= list.size())
+      return false;
+    list.erase(list.begin() + index);
+    return true;
+  }
+
+  const base::Value* rule = operation.FindKey("rule");
+  if (!rule)
+    return false;
+  if (op == "add" && index <= list.size()) {
+    list.insert(list.begin() + index, rule->Clone());
+    return true;
+  }
+  if (op == "replace" && index < list.size()) {
+    list[index] = rule->Clone();
+    return true;
+  }
+  return false;
+}
+
+void ContentSettingsManager::RebuildRules(const std::string& content_type) {
+  const base::ListValue* rules = nullptr;
+  if (content_settings_->GetListWithoutPathExpansion(content_type, &rules))
+    rules_[content_type].reset(new ContentSettingRuleIndex(*rules));
+  else
+    rules_.erase(content_type);
 }
 
 ContentSetting ContentSettingsManager::GetSetting(
@@ -110,47 +211,9 @@ ContentSetting ContentSettingsManager::GetContentSettingFromRules(
     ? ContentSetting::CONTENT_SETTING_ALLOW
     : ContentSetting::CONTENT_SETTING_BLOCK;
 
-  base::ListValue* rules = nullptr;
-  if (!content_settings_->GetList(content_type, &rules))
-    return result;
-
-  // all rules are evaluated in order and the
-  // most specific matching rule will apply
-  for (base::ListValue::iterator it = rules->begin();
-       it != rules->end(); ++it) {
-    base::DictionaryValue* rule;
-    std::string pattern_string;
-    std::string setting_string;
-    if (!it->GetAsDictionary(&rule) ||
-        !rule->GetString("primaryPattern", &pattern_string) ||
-        !rule->GetString("setting", &setting_string)) {
-      // skip invalid entries
-      // TODO(bridiver) should also send an ipc error message
-      ++it;
-    } else {
-      std::string secondary_pattern_string;
-      rule->GetString("secondaryPattern", &secondary_pattern_string);
-
-      ContentSetting setting = result;
-      if (setting_string != "block" && setting_string != "deny") {
-        setting = ContentSetting::CONTENT_SETTING_ALLOW;
-      } else {
-        setting = ContentSetting::CONTENT_SETTING_BLOCK;
-      }
-
-      if (secondary_pattern_string == "[firstParty]") {
-        secondary_pattern_string = "[*.]" + primary_url.HostNoBrackets();
-      }
-
-      if (ContentSettingsPattern::FromString(
-            pattern_string).Matches(primary_url) &&
-          // if there is a secondary resource pattern it has to match as well
-          (secondary_pattern_string.empty() ||
-            ContentSettingsPattern::FromString(
-              secondary_pattern_string).Matches(secondary_url)))
-        result = setting;
-    }
-  }
+  auto it = rules_.find(content_type);
+  if (it != rules_.end())
+    it->second->GetSetting(primary_url, secondary_url, &result);
   return result;
 }
 }  // namespace atom
@@ -5,7 +5,9 @@
 #ifndef ATOM_RENDERER_CONTENT_SETTINGS_MANAGER_H_
 #define ATOM_RENDERER_CONTENT_SETTINGS_MANAGER_H_
 
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 #include "base/lazy_instance.h"
@@ -19,6 +21,8 @@ class GURL;
 
 namespace base {
 class DictionaryValue;
+class ListValue;
+class Value;
 }
 
 namespace blink {
@@ -27,6 +31,8 @@ class WebFrame;
 
 namespace atom {
 
+class ContentSettingRuleIndex;
+
 class ContentSettingsManager : public content::RenderThreadObserver {
  public:
   ContentSettingsManager();
@@ -46,6 +52,10 @@ class ContentSettingsManager : public content::RenderThreadObserver {
 
   std::vector<std::string> GetContentTypes();
 
+  // Changes whenever the result of GetSetting may have changed, so callers
+  // can cache decisions.
+  uint64_t generation() const { return generation_; }
+
  private:
   ContentSetting GetContentSettingFromRules(
     const GURL& primary_url,
@@ -59,11 +69,25 @@ class ContentSettingsManager : public content::RenderThreadObserver {
   void OnUpdateWebKitPrefs(
       const content::WebPreferences& web_preferences);
   void OnUpdateContentSettings(
-      const base::DictionaryValue& content_settings);
+      const base::DictionaryValue& content_settings,
+      uint64_t version);
+  void OnUpdateContentSettingsDelta(uint64_t base_version,
+                                    uint64_t version,
+                                    const base::ListValue& operations);
+  // Applies one operation of a delta update, returns false if it doesn't
+  // apply to |content_settings_|.
+  bool ApplyOperation(const base::Value& operation,
+                      std::set<std::string>* changed_types);
+  void RebuildRules(const std::string& content_type);
 
 
   content::WebPreferences web_preferences_;
   std::unique_ptr<base::DictionaryValue> content_settings_;
+  // The rules of |content_settings_|, by content type.
+  std::map<std::string, std::unique_ptr<ContentSettingRuleIndex>> rules_;
+  // The browser-side version of |content_settings_|.
+  uint64_t version_;
+  uint64_t generation_;
 
   DISALLOW_COPY_AND_ASSIGN(ContentSettingsManager);
 };
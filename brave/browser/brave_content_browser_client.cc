@@ -20,6 +20,7 @@
 #include "brave/browser/notifications/platform_notification_service_impl.h"
 #include "brave/browser/password_manager/brave_password_manager_client.h"
 #include "brave/browser/renderer_host/brave_render_message_filter.h"
+#include "brave/browser/renderer_host/message_port_message_filter.h"
 #include "brave/grit/brave_resources.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/cache_stats_recorder.h"
@@ -453,6 +454,7 @@ void BraveContentBrowserClient::RenderProcessWillLaunch(
   host->AddFilter(new BraveRenderMessageFilter(id, profile));
   host->AddFilter(new printing::PrintingMessageFilter(id, profile));
   host->AddFilter(new TtsMessageFilter(host->GetBrowserContext()));
+  host->AddFilter(new brave::MessagePortMessageFilter(id));
 
 #if BUILDFLAG(ENABLE_EXTENSIONS)
   extensions_part_->RenderProcessWillLaunch(host);
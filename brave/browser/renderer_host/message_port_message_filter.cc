@@ -0,0 +1,114 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/renderer_host/message_port_message_filter.h"
+
+#include <map>
+#include <utility>
+
+#include "atom/common/api/api_messages.h"
+#include "base/bind.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "brave/common/workers/message_port_registry.h"
+#include "brave/common/workers/worker_message.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
+
+namespace brave {
+
+namespace {
+
+// The filters of live renderer processes, by process id. IO thread only.
+base::LazyInstance<std::map<int, MessagePortMessageFilter*>>::Leaky
+    g_filters = LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+MessagePortMessageFilter::MessagePortMessageFilter(int render_process_id)
+    : BrowserMessageFilter(ShellMsgStart),
+      render_process_id_(render_process_id) {
+}
+
+MessagePortMessageFilter::~MessagePortMessageFilter() {
+}
+
+// static
+void MessagePortMessageFilter::ConnectPort(int render_process_id,
+                                           int routing_id,
+                                           int port_id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  auto it = g_filters.Get().find(render_process_id);
+  if (it == g_filters.Get().end()) {
+    MessagePortRegistry::GetInstance()->Close(
+        port_id, MessagePortRegistry::kBrowserProcessId);
+    return;
+  }
+
+  scoped_refptr<MessagePortMessageFilter> filter(it->second);
+  if (!MessagePortRegistry::GetInstance()->Bind(
+          port_id, render_process_id,
+          BrowserThread::GetTaskRunnerForThread(BrowserThread::IO),
+          base::Bind(&MessagePortMessageFilter::DeliverPortMessage, filter,
+                     routing_id, port_id),
+          base::Bind(&MessagePortMessageFilter::DeliverPortClosed, filter,
+                     routing_id, port_id)))
+    return;
+  // Messages are delivered by tasks on this thread, so the frame still
+  // learns about the port before its first message.
+  filter->Send(new AtomViewMsg_ConnectPort(routing_id, port_id));
+}
+
+void MessagePortMessageFilter::OnFilterAdded(IPC::Channel* channel) {
+  g_filters.Get()[render_process_id_] = this;
+}
+
+void MessagePortMessageFilter::OnChannelClosing() {
+  g_filters.Get().erase(render_process_id_);
+  MessagePortRegistry::GetInstance()->CloseAllOwnedBy(render_process_id_);
+}
+
+bool MessagePortMessageFilter::OnMessageReceived(const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(MessagePortMessageFilter, message)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_PortMessage, OnPortMessage)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_ClosePort, OnClosePort)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  return handled;
+}
+
+void MessagePortMessageFilter::OnPortMessage(
+    int port_id,
+    const std::vector<uint8_t>& data,
+    const std::vector<std::vector<uint8_t>>& array_buffers) {
+  MessagePortRegistry::GetInstance()->PostMessage(
+      port_id, render_process_id_,
+      WorkerMessage::FromWire(data, array_buffers));
+}
+
+void MessagePortMessageFilter::OnClosePort(int port_id) {
+  MessagePortRegistry::GetInstance()->Close(port_id, render_process_id_);
+}
+
+void MessagePortMessageFilter::DeliverPortMessage(
+    int routing_id,
+    int port_id,
+    std::unique_ptr<WorkerMessage> message) {
+  std::vector<uint8_t> data;
+  std::vector<std::vector<uint8_t>> array_buffers;
+  if (!message->ToWire(&data, &array_buffers)) {
+    LOG(WARNING) << "SharedArrayBuffers can not be sent to a renderer";
+    return;
+  }
+  Send(new AtomViewMsg_PortMessage(routing_id, port_id, data, array_buffers));
+}
+
+void MessagePortMessageFilter::DeliverPortClosed(int routing_id,
+                                                 int port_id) {
+  Send(new AtomViewMsg_PortClosed(routing_id, port_id));
+}
+
+}  // namespace brave
@@ -0,0 +1,56 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_RENDERER_HOST_MESSAGE_PORT_MESSAGE_FILTER_H_
+#define BRAVE_BROWSER_RENDERER_HOST_MESSAGE_PORT_MESSAGE_FILTER_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/macros.h"
+#include "content/public/browser/browser_message_filter.h"
+
+namespace brave {
+
+class WorkerMessage;
+
+// Carries the messages of the ports connected to the frames of a renderer
+// process. Everything happens on the IO thread, so port traffic between a
+// frame and a worker never goes through the UI thread.
+class MessagePortMessageFilter : public content::BrowserMessageFilter {
+ public:
+  explicit MessagePortMessageFilter(int render_process_id);
+
+  // Hands |port_id| to the frame |routing_id| of |render_process_id|. Must be
+  // called on the IO thread.
+  static void ConnectPort(int render_process_id, int routing_id, int port_id);
+
+  // content::BrowserMessageFilter:
+  void OnFilterAdded(IPC::Channel* channel) override;
+  void OnChannelClosing() override;
+  bool OnMessageReceived(const IPC::Message& message) override;
+
+ private:
+  ~MessagePortMessageFilter() override;
+
+  void OnPortMessage(int port_id,
+                     const std::vector<uint8_t>& data,
+                     const std::vector<std::vector<uint8_t>>& array_buffers);
+  void OnClosePort(int port_id);
+
+  void DeliverPortMessage(int routing_id,
+                          int port_id,
+                          std::unique_ptr<WorkerMessage> message);
+  void DeliverPortClosed(int routing_id, int port_id);
+
+  const int render_process_id_;
+
+  DISALLOW_COPY_AND_ASSIGN(MessagePortMessageFilter);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_RENDERER_HOST_MESSAGE_PORT_MESSAGE_FILTER_H_
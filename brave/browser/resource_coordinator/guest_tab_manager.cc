@@ -4,16 +4,32 @@
 
 #include "brave/browser/resource_coordinator/guest_tab_manager.h"
 
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "atom/browser/api/atom_api_web_contents.h"
+#include "atom/browser/atom_browser_main_parts.h"
 #include "atom/browser/extensions/tab_helper.h"
+#include "atom/browser/javascript_environment.h"
+#include "base/bind.h"
 #include "brave/browser/guest_view/tab_view/tab_view_guest.h"
 #include "chrome/browser/profiles/profile.h"
+#include "chrome/browser/ui/browser.h"
+#include "chrome/browser/ui/browser_list.h"
 #include "chrome/browser/ui/tabs/tab_strip_model.h"
 #include "content/browser/frame_host/navigation_controller_impl.h"
 #include "content/browser/web_contents/web_contents_impl.h"
 #include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/render_process_host.h"
+#include "services/resource_coordinator/public/cpp/memory_instrumentation/memory_instrumentation.h"
 
 using content::BrowserThread;
 using content::WebContents;
+using memory_instrumentation::GlobalMemoryDump;
+using memory_instrumentation::MemoryInstrumentation;
 
 namespace content {
 
@@ -35,7 +51,224 @@ DEFINE_WEB_CONTENTS_USER_DATA_KEY(content::RestoreHelper);
 
 namespace resource_coordinator {
 
-GuestTabManager::GuestTabManager() : TabManager() {}
+namespace {
+
+// Tabs left within the same bucket count as equally idle, so memory use
+// decides between them.
+const int kInactivityBucketMinutes = 30;
+
+struct DiscardCandidate {
+  int tab_id;
+  base::TimeTicks last_active;
+  // Whole buckets of kInactivityBucketMinutes since the tab was last active.
+  int64_t inactive_buckets;
+  // The tab's share of its renderer's private memory.
+  uint64_t bytes;
+};
+
+// Longest idle first by bucket, then the heaviest, then least recently active.
+bool DiscardsBefore(const DiscardCandidate& a, const DiscardCandidate& b) {
+  if (a.inactive_buckets != b.inactive_buckets)
+    return a.inactive_buckets > b.inactive_buckets;
+  if (a.bytes != b.bytes)
+    return a.bytes > b.bytes;
+  return a.last_active < b.last_active;
+}
+
+base::ProcessId GetRendererPid(WebContents* contents) {
+  content::RenderFrameHost* frame = contents->GetMainFrame();
+  if (!frame || !frame->GetProcess()->GetProcess().IsValid())
+    return base::kNullProcessId;
+  return frame->GetProcess()->GetProcess().Pid();
+}
+
+}  // namespace
+
+GuestTabManager::DiscardPolicy::DiscardPolicy()
+    : enabled(true),
+      discard_on_moderate_pressure(true),
+      memory_budget(0),
+      check_interval(base::TimeDelta::FromMinutes(1)),
+      min_inactive_time(base::TimeDelta::FromMinutes(10)) {}
+
+GuestTabManager::DiscardStats::DiscardStats()
+    : runs(0), tabs_discarded(0), tabs_vetoed(0), bytes_reclaimed(0) {}
+
+GuestTabManager::GuestTabManager()
+    : TabManager(),
+      memory_pressure_listener_(new base::MemoryPressureListener(
+          base::Bind(&GuestTabManager::OnMemoryPressure,
+                     base::Unretained(this)))),
+      measuring_(false),
+      weak_factory_(this) {}
+
+GuestTabManager::~GuestTabManager() {}
+
+void GuestTabManager::SetDiscardPolicy(const DiscardPolicy& policy) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+  discard_policy_ = policy;
+  budget_timer_.Stop();
+  if (discard_policy_.enabled && discard_policy_.memory_budget &&
+      discard_policy_.check_interval > base::TimeDelta()) {
+    budget_timer_.Start(FROM_HERE, discard_policy_.check_interval,
+                        base::Bind(&GuestTabManager::CheckMemoryBudget,
+                                   base::Unretained(this)));
+  }
+}
+
+void GuestTabManager::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  if (!discard_policy_.enabled)
+    return;
+
+  switch (level) {
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE:
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+      if (discard_policy_.discard_on_moderate_pressure)
+        RunDiscardPolicy(DiscardTrigger::MODERATE_PRESSURE);
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+      RunDiscardPolicy(DiscardTrigger::CRITICAL_PRESSURE);
+      break;
+  }
+}
+
+void GuestTabManager::CheckMemoryBudget() {
+  RunDiscardPolicy(DiscardTrigger::MEMORY_BUDGET);
+}
+
+void GuestTabManager::RunDiscardPolicy(DiscardTrigger trigger) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+  // Pressure signals repeat while the measurement runs.
+  if (measuring_)
+    return;
+
+  ++discard_stats_.runs;
+  MemoryInstrumentation* instrumentation = MemoryInstrumentation::GetInstance();
+  if (!instrumentation) {
+    OnMemoryMeasured(trigger, false, nullptr);
+    return;
+  }
+  measuring_ = true;
+  instrumentation->RequestGlobalDump(
+      std::vector<std::string>(),
+      base::BindOnce(&GuestTabManager::OnMemoryMeasured,
+                     weak_factory_.GetWeakPtr(), trigger));
+}
+
+void GuestTabManager::OnMemoryMeasured(
+    DiscardTrigger trigger,
+    bool success,
+    std::unique_ptr<GlobalMemoryDump> dump) {
+  measuring_ = false;
+
+  std::map<base::ProcessId, uint64_t> footprints;
+  if (success && dump) {
+    for (const GlobalMemoryDump::ProcessDump& process : dump->process_dumps()) {
+      footprints[process.pid()] =
+          static_cast<uint64_t>(process.os_dump().private_footprint_kb) * 1024;
+    }
+  }
+  // Without a measurement the budget can't be checked, but pressure still
+  // discards by last active time.
+  if (footprints.empty() && trigger == DiscardTrigger::MEMORY_BUDGET)
+    return;
+
+  DiscardTabs(trigger, footprints);
+}
+
+void GuestTabManager::DiscardTabs(
+    DiscardTrigger trigger,
+    const std::map<base::ProcessId, uint64_t>& footprints) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+  std::vector<WebContents*> tabs;
+  for (Browser* browser : *BrowserList::GetInstance()) {
+    TabStripModel* tab_strip = browser->tab_strip_model();
+    for (int i = 0; i < tab_strip->count(); ++i)
+      tabs.push_back(tab_strip->GetWebContentsAt(i));
+  }
+
+  std::map<base::ProcessId, int> tabs_per_process;
+  for (WebContents* contents : tabs)
+    ++tabs_per_process[GetRendererPid(contents)];
+
+  uint64_t total_bytes = 0;
+  for (const auto& process : tabs_per_process) {
+    auto footprint = footprints.find(process.first);
+    if (footprint != footprints.end())
+      total_bytes += footprint->second;
+  }
+
+  const base::TimeTicks now = base::TimeTicks::Now();
+  std::vector<DiscardCandidate> candidates;
+  for (WebContents* contents : tabs) {
+    auto tab_helper = extensions::TabHelper::FromWebContents(contents);
+    if (!tab_helper || tab_helper->IsDiscarded() || tab_helper->is_active() ||
+        tab_helper->is_pinned() || tab_helper->is_placeholder() ||
+        !tab_helper->auto_discardable() || contents->IsCurrentlyAudible() ||
+        contents->GetVisibility() == content::Visibility::VISIBLE ||
+        now - contents->GetLastActiveTime() <
+            discard_policy_.min_inactive_time)
+      continue;
+
+    DiscardCandidate candidate;
+    candidate.tab_id = extensions::TabHelper::IdForTab(contents);
+    candidate.last_active = contents->GetLastActiveTime();
+    candidate.inactive_buckets =
+        (now - candidate.last_active).IntDiv(
+            base::TimeDelta::FromMinutes(kInactivityBucketMinutes));
+    base::ProcessId pid = GetRendererPid(contents);
+    auto footprint = footprints.find(pid);
+    candidate.bytes = footprint == footprints.end()
+                          ? 0
+                          : footprint->second / tabs_per_process[pid];
+    candidates.push_back(candidate);
+  }
+  std::sort(candidates.begin(), candidates.end(), &DiscardsBefore);
+
+  // Timers and memory pressure don't run with an isolate entered.
+  atom::JavascriptEnvironment* js_env =
+      atom::AtomBrowserMainParts::Get()->js_env();
+  if (!js_env)
+    return;
+  v8::Isolate* isolate = js_env->isolate();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+
+  for (const DiscardCandidate& candidate : candidates) {
+    // Pressure discards one tab per signal, like TabManager does, the budget
+    // as many as it takes.
+    if (trigger == DiscardTrigger::MEMORY_BUDGET &&
+        total_bytes <= discard_policy_.memory_budget)
+      break;
+
+    // A "will-discard" listener may have closed tabs, look the tab up again.
+    WebContents* contents = extensions::TabHelper::GetTabById(candidate.tab_id);
+    auto tab_helper =
+        contents ? extensions::TabHelper::FromWebContents(contents) : nullptr;
+    if (!tab_helper || tab_helper->IsDiscarded())
+      continue;
+
+    auto api_web_contents = atom::api::WebContents::GetFrom(isolate, contents);
+    bool discarded = api_web_contents.IsEmpty()
+                         ? tab_helper->Discard()
+                         : api_web_contents->Discard();
+    if (!discarded) {
+      ++discard_stats_.tabs_vetoed;
+      continue;
+    }
+
+    ++discard_stats_.tabs_discarded;
+    discard_stats_.bytes_reclaimed += candidate.bytes;
+    total_bytes -= std::min(total_bytes, candidate.bytes);
+    if (trigger != DiscardTrigger::MEMORY_BUDGET)
+      break;
+  }
+}
 
 WebContents* GuestTabManager::CreateNullContents(
     const content::WebContents::CreateParams& params,
@@ -7,9 +7,24 @@
 
 #include "chrome/browser/resource_coordinator/tab_manager.h"
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/weak_ptr.h"
+#include "base/process/process_handle.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "content/public/browser/web_contents_user_data.h"
 
+namespace memory_instrumentation {
+class GlobalMemoryDump;
+}
+
 namespace content {
 class WebContents;
 }
@@ -30,9 +45,62 @@ namespace resource_coordinator {
 
 class GuestTabManager : public TabManager {
  public:
+  // When background tabs are discarded without JS asking for it.
+  struct DiscardPolicy {
+    DiscardPolicy();
+
+    bool enabled;
+    // Discard on moderate memory pressure, not only on critical pressure.
+    bool discard_on_moderate_pressure;
+    // Discard until the renderers of all tabs use less private memory than
+    // this, checked every |check_interval|. Zero for no budget.
+    uint64_t memory_budget;
+    base::TimeDelta check_interval;
+    // Tabs active more recently than this are left alone.
+    base::TimeDelta min_inactive_time;
+  };
+
+  struct DiscardStats {
+    DiscardStats();
+
+    // Times the policy looked for tabs to discard.
+    size_t runs;
+    size_t tabs_discarded;
+    // Discards prevented from JS through "will-discard", or that failed.
+    size_t tabs_vetoed;
+    // Private memory of the discarded tabs' renderers, split evenly between
+    // the tabs sharing a renderer.
+    uint64_t bytes_reclaimed;
+  };
+
   GuestTabManager();
+  ~GuestTabManager() override;
+
+  void SetDiscardPolicy(const DiscardPolicy& policy);
+  const DiscardPolicy& discard_policy() const { return discard_policy_; }
+  const DiscardStats& discard_stats() const { return discard_stats_; }
 
  private:
+  // Why the policy runs, which decides how much it discards.
+  enum class DiscardTrigger {
+    MODERATE_PRESSURE,
+    CRITICAL_PRESSURE,
+    MEMORY_BUDGET,
+  };
+
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+  void CheckMemoryBudget();
+
+  // Measures the renderers, then discards the best candidates.
+  void RunDiscardPolicy(DiscardTrigger trigger);
+  void OnMemoryMeasured(
+      DiscardTrigger trigger,
+      bool success,
+      std::unique_ptr<memory_instrumentation::GlobalMemoryDump> dump);
+  void DiscardTabs(DiscardTrigger trigger,
+                   const std::map<base::ProcessId, uint64_t>& footprints);
+
   void ActiveTabChanged(content::WebContents* old_contents,
                         content::WebContents* new_contents,
                         int index,
@@ -47,6 +115,15 @@ class GuestTabManager : public TabManager {
       content::WebContents* old_contents) override;
   void DestroyOldContents(content::WebContents* old_contents) override;
 
+  DiscardPolicy discard_policy_;
+  DiscardStats discard_stats_;
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+  base::RepeatingTimer budget_timer_;
+  // A measurement is in flight.
+  bool measuring_;
+
+  base::WeakPtrFactory<GuestTabManager> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(GuestTabManager);
 };
 
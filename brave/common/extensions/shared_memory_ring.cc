@@ -0,0 +1,249 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/extensions/shared_memory_ring.h"
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "base/memory/ptr_util.h"
+#include "base/memory/shared_memory.h"
+#include "content/public/child/child_thread.h"
+#include "content/public/renderer/render_thread.h"
+
+using content::ChildThread;
+
+namespace brave {
+
+namespace {
+
+// Large enough for anything sensible, small enough to map in every frame.
+const size_t kMaxCapacity = 64 * 1024 * 1024;
+
+}  // namespace
+
+// Lives at the start of the segment, followed by the ring itself.
+struct SharedMemoryRing::Header {
+  // Everything before this position has been read, written by the reader.
+  std::atomic<uint64_t> read_position;
+  char padding[56];
+};
+
+// Hands the serializer the whole free space at once, so the value is written
+// in place and asking for more means it does not fit.
+class SharedMemoryRing::WriteDelegate : public v8::ValueSerializer::Delegate {
+ public:
+  WriteDelegate(v8::Isolate* isolate, uint8_t* space, size_t space_size)
+      : isolate_(isolate),
+        space_(space),
+        space_size_(space_size),
+        out_of_space_(false) {}
+
+  bool out_of_space() const { return out_of_space_; }
+
+  // v8::ValueSerializer::Delegate:
+  void ThrowDataCloneError(v8::Local<v8::String> message) override {
+    isolate_->ThrowException(v8::Exception::Error(message));
+  }
+
+  void* ReallocateBufferMemory(void* old_buffer,
+                               size_t size,
+                               size_t* actual_size) override {
+    if (old_buffer || size > space_size_) {
+      out_of_space_ = true;
+      return nullptr;
+    }
+    *actual_size = space_size_;
+    return space_;
+  }
+
+  void FreeBufferMemory(void* buffer) override {
+    // The ring owns the memory.
+  }
+
+ private:
+  v8::Isolate* isolate_;
+  uint8_t* space_;
+  size_t space_size_;
+  bool out_of_space_;
+
+  DISALLOW_COPY_AND_ASSIGN(WriteDelegate);
+};
+
+SharedMemoryRing::SharedMemoryRing(
+    std::unique_ptr<base::SharedMemory> shared_memory,
+    size_t capacity)
+    : shared_memory_(std::move(shared_memory)),
+      capacity_(capacity),
+      sequence_(0),
+      position_(0) {
+}
+
+SharedMemoryRing::~SharedMemoryRing() {
+}
+
+// static
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Create(size_t capacity) {
+  if (capacity == 0 || capacity > kMaxCapacity)
+    return nullptr;
+
+  size_t size = sizeof(Header) + capacity;
+  std::unique_ptr<base::SharedMemory> shared_memory;
+  if (ChildThread::Get()) {
+    shared_memory =
+        content::RenderThread::Get()->HostAllocateSharedMemoryBuffer(size);
+  } else {
+    shared_memory.reset(new base::SharedMemory);
+    if (!shared_memory->CreateAndMapAnonymous(size))
+      return nullptr;
+  }
+
+  if (!shared_memory)
+    return nullptr;
+  if (!shared_memory->memory() && !shared_memory->Map(size))
+    return nullptr;
+
+  std::unique_ptr<SharedMemoryRing> ring(
+      new SharedMemoryRing(std::move(shared_memory), capacity));
+  new (ring->header()) Header();
+  ring->header()->read_position.store(0, std::memory_order_release);
+  return ring;
+}
+
+// static
+std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Open(
+    const base::SharedMemoryHandle& handle,
+    size_t capacity) {
+  size_t size = sizeof(Header) + capacity;
+  if (!handle.IsValid() || capacity == 0 || capacity > kMaxCapacity ||
+      handle.GetSize() < size)
+    return nullptr;
+
+  std::unique_ptr<base::SharedMemory> shared_memory(
+      new base::SharedMemory(handle, false));
+  if (!shared_memory->Map(size))
+    return nullptr;
+
+  return base::WrapUnique(
+      new SharedMemoryRing(std::move(shared_memory), capacity));
+}
+
+base::SharedMemoryHandle SharedMemoryRing::ShareHandle() const {
+  return shared_memory_->handle().Duplicate();
+}
+
+SharedMemoryRing::Header* SharedMemoryRing::header() const {
+  return static_cast<Header*>(shared_memory_->memory());
+}
+
+uint8_t* SharedMemoryRing::data() const {
+  return static_cast<uint8_t*>(shared_memory_->memory()) + sizeof(Header);
+}
+
+bool SharedMemoryRing::Write(v8::Isolate* isolate,
+                             v8::Local<v8::Value> value,
+                             uint64_t* sequence,
+                             uint64_t* position,
+                             uint32_t* size) {
+  uint64_t read_position =
+      header()->read_position.load(std::memory_order_acquire);
+  // The reader may be in a less trusted process.
+  if (read_position > position_ || position_ - read_position > capacity_)
+    return false;
+  size_t free_space = capacity_ - (position_ - read_position);
+  size_t offset = position_ % capacity_;
+  size_t contiguous = std::min(free_space, capacity_ - offset);
+
+  uint64_t write_position = position_;
+  bool out_of_space = false;
+  if (!WriteAt(isolate, value, write_position, contiguous, size,
+               &out_of_space)) {
+    // A value never wraps around, try again from the start of the ring if
+    // that leaves more room.
+    size_t skipped = capacity_ - offset;
+    if (!out_of_space || free_space <= skipped ||
+        free_space - skipped <= contiguous)
+      return false;
+    write_position += skipped;
+    if (!WriteAt(isolate, value, write_position, free_space - skipped, size,
+                 &out_of_space))
+      return false;
+  }
+
+  *sequence = sequence_++;
+  *position = write_position;
+  position_ = write_position + *size;
+  return true;
+}
+
+bool SharedMemoryRing::WriteAt(v8::Isolate* isolate,
+                               v8::Local<v8::Value> value,
+                               uint64_t position,
+                               size_t space,
+                               uint32_t* size,
+                               bool* out_of_space) {
+  *out_of_space = space == 0;
+  if (*out_of_space)
+    return false;
+
+  WriteDelegate delegate(isolate, data() + position % capacity_, space);
+  v8::TryCatch try_catch(isolate);
+  v8::ValueSerializer serializer(isolate, &delegate);
+  serializer.WriteHeader();
+  if (!serializer.WriteValue(isolate->GetCurrentContext(), value)
+           .FromMaybe(false)) {
+    *out_of_space = delegate.out_of_space();
+    if (!*out_of_space)
+      try_catch.ReThrow();
+    return false;
+  }
+
+  std::pair<uint8_t*, size_t> buffer = serializer.Release();
+  *size = buffer.second;
+  return true;
+}
+
+v8::MaybeLocal<v8::Value> SharedMemoryRing::Read(v8::Isolate* isolate,
+                                                 uint64_t sequence,
+                                                 uint64_t position,
+                                                 uint32_t size) {
+  // The writer is in another process, check everything.
+  uint64_t offset = position % capacity_;
+  if (sequence != sequence_ || size == 0 || size > capacity_ ||
+      position < position_ || offset + size > capacity_ ||
+      position + size - position_ > capacity_)
+    return v8::MaybeLocal<v8::Value>();
+  // Only the tail of the ring can be skipped.
+  if (position != position_ &&
+      (offset != 0 ||
+       position - position_ != capacity_ - position_ % capacity_))
+    return v8::MaybeLocal<v8::Value>();
+
+  // The writer can still change the record while it is being read, so the
+  // deserializer only ever sees a private copy of it.
+  std::vector<uint8_t> record(data() + offset, data() + offset + size);
+
+  v8::Local<v8::Value> value;
+  {
+    v8::TryCatch try_catch(isolate);
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::ValueDeserializer deserializer(isolate, record.data(), record.size());
+    deserializer.SetSupportsLegacyWireFormat(true);
+    if (deserializer.ReadHeader(context).FromMaybe(false))
+      deserializer.ReadValue(context).ToLocal(&value);
+  }
+
+  ++sequence_;
+  position_ = position + size;
+  header()->read_position.store(position_, std::memory_order_release);
+
+  if (value.IsEmpty())
+    return v8::MaybeLocal<v8::Value>();
+  return value;
+}
+
+}  // namespace brave
@@ -0,0 +1,102 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_EXTENSIONS_SHARED_MEMORY_RING_H_
+#define BRAVE_COMMON_EXTENSIONS_SHARED_MEMORY_RING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "base/macros.h"
+#include "base/memory/shared_memory_handle.h"
+#include "v8/include/v8.h"
+
+namespace base {
+class SharedMemory;
+}
+
+namespace brave {
+
+// One direction of a persistent shared memory channel between a frame and
+// the browser.
+//
+// The writer serializes values straight into the free part of the ring and
+// announces each of them with a small IPC carrying its sequence number,
+// position and size. The reader copies the value out, deserializes the copy
+// and hands the space back through a read position kept at the start of the
+// segment.
+// A writer that runs out of space gets an error, so the caller can fall back
+// to a one-off segment instead of waiting.
+class SharedMemoryRing {
+ public:
+  static const size_t kDefaultCapacity = 1024 * 1024;
+
+  ~SharedMemoryRing();
+
+  // Creates the writing end of a new ring of |capacity| bytes.
+  static std::unique_ptr<SharedMemoryRing> Create(size_t capacity);
+
+  // Maps the reading end of a ring created by another process.
+  static std::unique_ptr<SharedMemoryRing> Open(
+      const base::SharedMemoryHandle& handle,
+      size_t capacity);
+
+  // Returns a handle to send to the reading end.
+  base::SharedMemoryHandle ShareHandle() const;
+
+  size_t capacity() const { return capacity_; }
+
+  // Serializes |value| into the ring. Returns false if it does not fit in the
+  // free space, or with an exception thrown in |isolate| if it can't be
+  // serialized at all.
+  bool Write(v8::Isolate* isolate,
+             v8::Local<v8::Value> value,
+             uint64_t* sequence,
+             uint64_t* position,
+             uint32_t* size);
+
+  // Deserializes the value written at |position| and frees its space.
+  // Values must be read in the order they were written; an out of order or
+  // out of bounds message is rejected.
+  v8::MaybeLocal<v8::Value> Read(v8::Isolate* isolate,
+                                 uint64_t sequence,
+                                 uint64_t position,
+                                 uint32_t size);
+
+ private:
+  class WriteDelegate;
+  struct Header;
+
+  SharedMemoryRing(std::unique_ptr<base::SharedMemory> shared_memory,
+                   size_t capacity);
+
+  Header* header() const;
+  uint8_t* data() const;
+
+  // Serializes |value| at |position|, using at most |space| bytes. Sets
+  // |out_of_space| if it did not fit.
+  bool WriteAt(v8::Isolate* isolate,
+               v8::Local<v8::Value> value,
+               uint64_t position,
+               size_t space,
+               uint32_t* size,
+               bool* out_of_space);
+
+  std::unique_ptr<base::SharedMemory> shared_memory_;
+  const size_t capacity_;
+
+  // The next sequence number to write or read.
+  uint64_t sequence_;
+  // Where the next value goes (writer), or the end of the last value read
+  // (reader).
+  uint64_t position_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedMemoryRing);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_EXTENSIONS_SHARED_MEMORY_RING_H_
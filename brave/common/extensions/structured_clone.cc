@@ -0,0 +1,73 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/extensions/structured_clone.h"
+
+#include <utility>
+
+#include "base/macros.h"
+
+namespace brave {
+
+namespace {
+
+// Grows |data| as the serializer asks for memory, so the bytes end up in the
+// vector handed to IPC without another copy.
+class VectorDelegate : public v8::ValueSerializer::Delegate {
+ public:
+  VectorDelegate(v8::Isolate* isolate, std::vector<uint8_t>* data)
+      : isolate_(isolate), data_(data) {}
+
+  // v8::ValueSerializer::Delegate:
+  void ThrowDataCloneError(v8::Local<v8::String> message) override {
+    isolate_->ThrowException(v8::Exception::Error(message));
+  }
+
+  void* ReallocateBufferMemory(void* old_buffer,
+                               size_t size,
+                               size_t* actual_size) override {
+    data_->resize(size);
+    *actual_size = size;
+    return data_->data();
+  }
+
+  void FreeBufferMemory(void* buffer) override {
+    // |data_| owns the memory.
+  }
+
+ private:
+  v8::Isolate* isolate_;
+  std::vector<uint8_t>* data_;
+
+  DISALLOW_COPY_AND_ASSIGN(VectorDelegate);
+};
+
+}  // namespace
+
+bool SerializeValue(v8::Isolate* isolate,
+                    v8::Local<v8::Value> value,
+                    std::vector<uint8_t>* data) {
+  data->clear();
+  VectorDelegate delegate(isolate, data);
+  v8::ValueSerializer serializer(isolate, &delegate);
+  serializer.WriteHeader();
+  if (!serializer.WriteValue(isolate->GetCurrentContext(), value)
+           .FromMaybe(false))
+    return false;
+
+  std::pair<uint8_t*, size_t> buffer = serializer.Release();
+  data->resize(buffer.second);
+  return true;
+}
+
+v8::MaybeLocal<v8::Value> DeserializeValue(v8::Isolate* isolate,
+                                           const std::vector<uint8_t>& data) {
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::ValueDeserializer deserializer(isolate, data.data(), data.size());
+  if (!deserializer.ReadHeader(context).FromMaybe(false))
+    return v8::MaybeLocal<v8::Value>();
+  return deserializer.ReadValue(context);
+}
+
+}  // namespace brave
@@ -0,0 +1,30 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_EXTENSIONS_STRUCTURED_CLONE_H_
+#define BRAVE_COMMON_EXTENSIONS_STRUCTURED_CLONE_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "v8/include/v8.h"
+
+namespace brave {
+
+// Serializes |value| with v8::ValueSerializer straight into |data|, keeping
+// ArrayBuffers, typed arrays, Maps, Sets and Dates as they are. Returns false
+// with an exception thrown in |isolate| if |value| can't be cloned.
+bool SerializeValue(v8::Isolate* isolate,
+                    v8::Local<v8::Value> value,
+                    std::vector<uint8_t>* data);
+
+// Reads back a value written by SerializeValue, in the current context of
+// |isolate|. |data| may come from a less trusted process.
+v8::MaybeLocal<v8::Value> DeserializeValue(v8::Isolate* isolate,
+                                           const std::vector<uint8_t>& data);
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_EXTENSIONS_STRUCTURED_CLONE_H_
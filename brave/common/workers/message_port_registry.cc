@@ -0,0 +1,162 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/workers/message_port_registry.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/sequenced_task_runner.h"
+#include "brave/common/workers/worker_message.h"
+
+namespace brave {
+
+namespace {
+
+// Messages kept for an end nobody has bound yet.
+const size_t kMaxQueuedMessages = 1024;
+
+}  // namespace
+
+MessagePortRegistry::Port::Port()
+    : peer_id(0), bound(false), owner_process_id(kBrowserProcessId) {
+}
+
+MessagePortRegistry::Port::~Port() {
+}
+
+// static
+MessagePortRegistry* MessagePortRegistry::GetInstance() {
+  return base::Singleton<MessagePortRegistry>::get();
+}
+
+MessagePortRegistry::MessagePortRegistry() : next_port_id_(1) {
+}
+
+MessagePortRegistry::~MessagePortRegistry() {
+}
+
+void MessagePortRegistry::CreateChannel(int* port1, int* port2) {
+  base::AutoLock auto_lock(lock_);
+  *port1 = next_port_id_++;
+  *port2 = next_port_id_++;
+  ports_[*port1].peer_id = *port2;
+  ports_[*port2].peer_id = *port1;
+}
+
+bool MessagePortRegistry::Bind(
+    int port_id,
+    int owner_process_id,
+    scoped_refptr<base::SequencedTaskRunner> task_runner,
+    const DeliverCallback& deliver,
+    const base::Closure& closed) {
+  std::vector<std::unique_ptr<WorkerMessage>> queue;
+  {
+    base::AutoLock auto_lock(lock_);
+    auto it = ports_.find(port_id);
+    if (it == ports_.end() || it->second.bound)
+      return false;
+
+    Port& port = it->second;
+    port.bound = true;
+    port.owner_process_id = owner_process_id;
+    port.task_runner = task_runner;
+    port.deliver = deliver;
+    port.closed = closed;
+    queue.swap(port.queue);
+  }
+
+  for (auto& message : queue) {
+    task_runner->PostTask(FROM_HERE,
+        base::Bind(deliver, base::Passed(&message)));
+  }
+  return true;
+}
+
+bool MessagePortRegistry::PostMessage(int port_id,
+                                      int sender_process_id,
+                                      std::unique_ptr<WorkerMessage> message) {
+  scoped_refptr<base::SequencedTaskRunner> task_runner;
+  DeliverCallback deliver;
+  {
+    base::AutoLock auto_lock(lock_);
+    auto it = ports_.find(port_id);
+    if (it == ports_.end() || !it->second.bound ||
+        it->second.owner_process_id != sender_process_id)
+      return false;
+
+    auto peer = ports_.find(it->second.peer_id);
+    if (peer == ports_.end())
+      return false;
+
+    if (!peer->second.bound) {
+      if (peer->second.queue.size() >= kMaxQueuedMessages)
+        return false;
+      peer->second.queue.push_back(std::move(message));
+      return true;
+    }
+    task_runner = peer->second.task_runner;
+    deliver = peer->second.deliver;
+  }
+
+  return task_runner->PostTask(FROM_HERE,
+      base::Bind(deliver, base::Passed(&message)));
+}
+
+void MessagePortRegistry::Close(int port_id, int sender_process_id) {
+  std::vector<CloseNotification> notifications;
+  {
+    base::AutoLock auto_lock(lock_);
+    auto it = ports_.find(port_id);
+    if (it == ports_.end() ||
+        it->second.owner_process_id != sender_process_id)
+      return;
+    CloseLocked(port_id, &notifications);
+  }
+  Notify(notifications);
+}
+
+void MessagePortRegistry::CloseAllOwnedBy(int process_id) {
+  std::vector<CloseNotification> notifications;
+  {
+    base::AutoLock auto_lock(lock_);
+    std::vector<int> owned;
+    for (const auto& it : ports_) {
+      if (it.second.bound && it.second.owner_process_id == process_id)
+        owned.push_back(it.first);
+    }
+    for (int port_id : owned)
+      CloseLocked(port_id, &notifications);
+  }
+  Notify(notifications);
+}
+
+void MessagePortRegistry::CloseLocked(
+    int port_id,
+    std::vector<CloseNotification>* notifications) {
+  lock_.AssertAcquired();
+  auto it = ports_.find(port_id);
+  if (it == ports_.end())
+    return;
+
+  auto peer = ports_.find(it->second.peer_id);
+  if (peer != ports_.end()) {
+    if (peer->second.bound && !peer->second.closed.is_null()) {
+      notifications->push_back(
+          std::make_pair(peer->second.task_runner, peer->second.closed));
+    }
+    ports_.erase(peer);
+  }
+  ports_.erase(it);
+}
+
+// static
+void MessagePortRegistry::Notify(
+    const std::vector<CloseNotification>& notifications) {
+  for (const auto& notification : notifications)
+    notification.first->PostTask(FROM_HERE, notification.second);
+}
+
+}  // namespace brave
@@ -0,0 +1,108 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_WORKERS_MESSAGE_PORT_REGISTRY_H_
+#define BRAVE_COMMON_WORKERS_MESSAGE_PORT_REGISTRY_H_
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/singleton.h"
+#include "base/synchronization/lock.h"
+
+namespace base {
+class SequencedTaskRunner;
+}
+
+namespace brave {
+
+class WorkerMessage;
+
+// Pairs of entangled message ports, usable from any thread.
+//
+// Each end of a channel is bound to whoever receives its messages: a worker
+// thread, or a render frame through the IO thread. A message posted on one
+// end goes straight to the task runner of the other end, without involving
+// the UI thread. Messages sent to an end that is not bound yet are queued.
+class MessagePortRegistry {
+ public:
+  using DeliverCallback =
+      base::Callback<void(std::unique_ptr<WorkerMessage> message)>;
+
+  // The owner of the ports bound in the browser process.
+  static const int kBrowserProcessId = -1;
+
+  static MessagePortRegistry* GetInstance();
+
+  // Creates a new channel and returns the ids of its two ends.
+  void CreateChannel(int* port1, int* port2);
+
+  // Delivers the messages of |port_id| with |deliver|, run on |task_runner|.
+  // |closed| is run on |task_runner| too, if the other end closes the
+  // channel. |owner_process_id| is the render process allowed to post on the
+  // port. Returns false if the port does not exist or is already bound.
+  bool Bind(int port_id,
+            int owner_process_id,
+            scoped_refptr<base::SequencedTaskRunner> task_runner,
+            const DeliverCallback& deliver,
+            const base::Closure& closed);
+
+  // Sends |message| to the other end of |port_id|. Returns false if the port
+  // is closed or not owned by |sender_process_id|.
+  bool PostMessage(int port_id,
+                   int sender_process_id,
+                   std::unique_ptr<WorkerMessage> message);
+
+  // Closes the channel of |port_id|, dropping the messages still queued, and
+  // tells the other end if it is bound. Ports bound by a render process can
+  // only be closed by that process, and unbound ones only by the browser.
+  void Close(int port_id, int sender_process_id);
+
+  // Closes every channel with an end owned by |process_id|.
+  void CloseAllOwnedBy(int process_id);
+
+ private:
+  friend struct base::DefaultSingletonTraits<MessagePortRegistry>;
+
+  struct Port {
+    Port();
+    ~Port();
+
+    int peer_id;
+    bool bound;
+    int owner_process_id;
+    scoped_refptr<base::SequencedTaskRunner> task_runner;
+    DeliverCallback deliver;
+    base::Closure closed;
+    std::vector<std::unique_ptr<WorkerMessage>> queue;
+  };
+
+  // A |closed| callback to run on the task runner of its port.
+  using CloseNotification =
+      std::pair<scoped_refptr<base::SequencedTaskRunner>, base::Closure>;
+
+  MessagePortRegistry();
+  ~MessagePortRegistry();
+
+  // Closes the channel of |port_id|. The other end is added to
+  // |notifications|, to be told once the lock is released.
+  void CloseLocked(int port_id,
+                   std::vector<CloseNotification>* notifications);
+  static void Notify(const std::vector<CloseNotification>& notifications);
+
+  base::Lock lock_;
+  int next_port_id_;
+  std::map<int, Port> ports_;
+
+  DISALLOW_COPY_AND_ASSIGN(MessagePortRegistry);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_WORKERS_MESSAGE_PORT_REGISTRY_H_
@@ -46,7 +46,8 @@ V8WorkerThread::V8WorkerThread(const std::string& name,
                               atom::api::App* app) :
     base::Thread(name),
     module_name_(module_name),
-    app_(app) {
+    app_(app),
+    bindings_(nullptr) {
 }
 
 V8WorkerThread::~V8WorkerThread() {
@@ -80,9 +81,9 @@ void V8WorkerThread::Init() {
 
   js_env_.reset(new atom::JavascriptEnvironment());
 
+  bindings_ = new WorkerBindings(env()->script_context(), this);
   env()->module_system()->RegisterNativeHandler(
-      "worker", std::unique_ptr<extensions::NativeHandler>(
-          new WorkerBindings(env()->script_context(), this)));
+      "worker", std::unique_ptr<extensions::NativeHandler>(bindings_));
 
   memory_pressure_listener_.reset(new base::MemoryPressureListener(
       base::Bind(&V8WorkerThread::OnMemoryPressure,
@@ -106,6 +107,7 @@ void V8WorkerThread::CleanUp() {
   content::WorkerThreadRegistry::Instance()->WillStopCurrentWorkerThread();
   memory_pressure_listener_.reset();
   env()->OnMessageLoopDestroying();
+  bindings_ = nullptr;
   js_env_.reset();
   V8WorkerThread::Shutdown();
 }
@@ -20,6 +20,8 @@ class App;
 
 namespace brave {
 
+class WorkerBindings;
+
 class V8WorkerThread : public base::Thread {
  public:
   explicit V8WorkerThread(const std::string& name,
@@ -36,6 +38,7 @@ class V8WorkerThread : public base::Thread {
   atom::api::App* app() const { return app_; }
   atom::JavascriptEnvironment* env() const { return js_env_.get(); }
   const std::string& module_name() const { return module_name_; }
+  WorkerBindings* bindings() const { return bindings_; }
 
  private:
   void LoadModule();
@@ -45,6 +48,8 @@ class V8WorkerThread : public base::Thread {
   const std::string module_name_;
   atom::api::App* app_;
   std::unique_ptr<atom::JavascriptEnvironment> js_env_;
+  // Owned by the module system of |js_env_|.
+  WorkerBindings* bindings_;
   std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
 };
 
@@ -8,7 +8,10 @@
 #include "brave/common/workers/worker_bindings.h"
 
 #include "atom/browser/api/atom_api_app.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "brave/common/workers/message_port_registry.h"
 #include "brave/common/workers/v8_worker_thread.h"
+#include "brave/common/workers/worker_message.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/renderer/worker_thread_registry.h"
 #include "extensions/renderer/script_context.h"
@@ -30,16 +33,13 @@ bool SetReadOnlyProperty(v8::Local<v8::Context> context,
       static_cast<v8::PropertyAttribute>(v8::ReadOnly)));
 }
 
-void OnMessageInternal(const std::pair<uint8_t*, size_t>& buf) {
+void OnMessageInternal(std::unique_ptr<WorkerMessage> worker_message) {
   v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::HandleScope handle_scope(isolate);
   v8::Local<v8::Context> context = isolate->GetCurrentContext();
 
-  v8::ValueDeserializer deserializer(
-      isolate, buf.first, buf.second);
-  deserializer.SetSupportsLegacyWireFormat(true);
-  if (deserializer.ReadHeader(context).FromMaybe(false)) {
-    v8::Local<v8::Value> message =
-        deserializer.ReadValue(context).ToLocalChecked();
+  v8::Local<v8::Value> message;
+  if (worker_message->Deserialize(isolate).ToLocal(&message)) {
     v8::Local<v8::Object> global = context->Global();
     v8::Local<v8::Value> onmessage =
         global->Get(context, v8::String::NewFromUtf8(isolate, "onmessage",
@@ -53,7 +53,6 @@ void OnMessageInternal(const std::pair<uint8_t*, size_t>& buf) {
       (void)onmessage_fun->Call(context, global, 1, argv);
     }
   }
-  free(buf.first);
 }
 
 }  // namespace
@@ -64,7 +63,11 @@ WorkerBindings::WorkerBindings(extensions::ScriptContext* context,
       worker_(worker),
       weak_ptr_factory_(this) {}
 
-WorkerBindings::~WorkerBindings() {}
+WorkerBindings::~WorkerBindings() {
+  for (const auto& it : ports_)
+    MessagePortRegistry::GetInstance()->Close(
+        it.first, MessagePortRegistry::kBrowserProcessId);
+}
 
 void WorkerBindings::AddRoutes() {
   RouteHandlerFunction(
@@ -129,6 +132,14 @@ void WorkerBindings::AddRoutes() {
                                                  "worker", "close");
   context()->module_system()->SetNativeLazyField(
       v8_context->Global(), "onerror", "worker", "onerror");
+
+  // connect handler for message ports
+  maybe_set = v8_context->Global()->CreateDataProperty(
+      v8_context,
+      v8::String::NewFromUtf8(isolate, "onconnect", v8::NewStringType::kNormal)
+          .ToLocalChecked(),
+      v8::Null(isolate));
+  DCHECK(maybe_set.IsJust() && maybe_set.FromJust());
 }
 
 void WorkerBindings::OnErrorOnUIThread(const std::string& message,
@@ -175,20 +186,16 @@ void WorkerBindings::Close(
 }
 
 void WorkerBindings::PostMessageOnUIThread(
-    const std::pair<uint8_t*, size_t>& buf) {
-  v8::ValueDeserializer deserializer(
-      worker_->app()->isolate(), buf.first, buf.second);
-  deserializer.SetSupportsLegacyWireFormat(true);
-  if (deserializer.ReadHeader(
-      worker_->app()->isolate()->GetCurrentContext()).FromMaybe(false)) {
-    v8::Local<v8::Value> val = deserializer.ReadValue(
-        worker_->app()->isolate()->GetCurrentContext()).ToLocalChecked();
+    std::unique_ptr<WorkerMessage> message) {
+  v8::Isolate* isolate = worker_->app()->isolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Value> val;
+  if (message->Deserialize(isolate).ToLocal(&val)) {
     worker_->app()->Emit("worker-post-message", worker_->GetThreadId(), val);
   } else {
     worker_->app()->Emit("worker-onerror", worker_->GetThreadId(),
         "`postMessage` could not deserialize message buffer");
   }
-  free(buf.first);
 }
 
 void WorkerBindings::PostMessage(
@@ -199,46 +206,204 @@ void WorkerBindings::PostMessage(
     return;
   }
 
-  if (args.Length() > 1) {
-    context()->isolate()->ThrowException(v8::String::NewFromUtf8(
-        context()->isolate(), "`transferList` is not supported yet"));
+  // Throws on failure.
+  std::unique_ptr<WorkerMessage> message(new WorkerMessage);
+  if (!message->Serialize(context()->isolate(), args[0], args[1]))
     return;
-  }
-
-  v8::ValueSerializer serializer(context()->isolate());
-  serializer.WriteHeader();
-  if (serializer.WriteValue(
-      context()->v8_context(), args[0]).FromMaybe(false)) {
-    std::pair<uint8_t*, size_t> buffer = serializer.Release();
 
-    BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
-        base::Bind(&WorkerBindings::PostMessageOnUIThread,
-                    weak_ptr_factory_.GetWeakPtr(),
-                    std::move(buffer)));
-  } else {
-    context()->isolate()->ThrowException(v8::String::NewFromUtf8(
-        context()->isolate(), "`postMessage` could not serialize message"));
-  }
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+      base::Bind(&WorkerBindings::PostMessageOnUIThread,
+                  weak_ptr_factory_.GetWeakPtr(),
+                  base::Passed(&message)));
 }
 
 // static
 bool WorkerBindings::OnMessage(v8::Isolate* isolate,
                                 base::PlatformThreadId thread_id,
-                                v8::Local<v8::Value> message) {
-  v8::ValueSerializer serializer(isolate);
-  serializer.WriteHeader();
-  if (serializer.WriteValue(
-      isolate->GetCurrentContext(), message).FromMaybe(false)) {
-    std::pair<uint8_t*, size_t> buffer = serializer.Release();
-
-    base::TaskRunner* task_runner =
-        content::WorkerThreadRegistry::Instance()->GetTaskRunnerFor(thread_id);
-    task_runner->PostTask(FROM_HERE,
-        base::Bind(&OnMessageInternal,
-        std::move(buffer)));
-    return true;
+                                v8::Local<v8::Value> message,
+                                v8::Local<v8::Value> transfer_list) {
+  std::unique_ptr<WorkerMessage> worker_message(new WorkerMessage);
+  if (!worker_message->Serialize(isolate, message, transfer_list))
+    return false;
+
+  base::TaskRunner* task_runner =
+      content::WorkerThreadRegistry::Instance()->GetTaskRunnerFor(thread_id);
+  if (!task_runner)
+    return false;
+  task_runner->PostTask(FROM_HERE,
+      base::Bind(&OnMessageInternal,
+      base::Passed(&worker_message)));
+  return true;
+}
+
+// static
+bool WorkerBindings::ConnectPort(base::PlatformThreadId thread_id,
+                                 int port_id) {
+  base::TaskRunner* task_runner =
+      content::WorkerThreadRegistry::Instance()->GetTaskRunnerFor(thread_id);
+  // The task runner of a worker that is gone drops its tasks.
+  if (!task_runner ||
+      !task_runner->PostTask(
+          FROM_HERE,
+          base::Bind(&WorkerBindings::ConnectPortInternal, port_id))) {
+    MessagePortRegistry::GetInstance()->Close(
+        port_id, MessagePortRegistry::kBrowserProcessId);
+    return false;
+  }
+  return true;
+}
+
+// static
+void WorkerBindings::ConnectPortInternal(int port_id) {
+  V8WorkerThread* worker = V8WorkerThread::current();
+  if (!worker || !worker->bindings()) {
+    MessagePortRegistry::GetInstance()->Close(
+        port_id, MessagePortRegistry::kBrowserProcessId);
+    return;
+  }
+  worker->bindings()->OnConnectPort(port_id);
+}
+
+// static
+void WorkerBindings::DeliverPortMessage(
+    int port_id,
+    std::unique_ptr<WorkerMessage> message) {
+  V8WorkerThread* worker = V8WorkerThread::current();
+  if (worker && worker->bindings())
+    worker->bindings()->OnPortMessage(port_id, std::move(message));
+}
+
+// static
+void WorkerBindings::DeliverPortClosed(int port_id) {
+  V8WorkerThread* worker = V8WorkerThread::current();
+  if (worker && worker->bindings())
+    worker->bindings()->OnPortClosed(port_id);
+}
+
+// static
+void WorkerBindings::PortPostMessage(
+    const v8::FunctionCallbackInfo<v8::Value>& args) {
+  v8::Isolate* isolate = args.GetIsolate();
+  if (args.Length() < 1) {
+    isolate->ThrowException(v8::String::NewFromUtf8(
+        isolate, "`message` is a required field"));
+    return;
   }
-  return false;
+
+  // Throws on failure.
+  std::unique_ptr<WorkerMessage> message(new WorkerMessage);
+  if (!message->Serialize(isolate, args[0], args[1]))
+    return;
+
+  // Messages posted on a closed port are dropped, like on a MessagePort.
+  int port_id = args.Data().As<v8::Integer>()->Value();
+  MessagePortRegistry::GetInstance()->PostMessage(
+      port_id, MessagePortRegistry::kBrowserProcessId, std::move(message));
+}
+
+// static
+void WorkerBindings::PortClose(
+    const v8::FunctionCallbackInfo<v8::Value>& args) {
+  int port_id = args.Data().As<v8::Integer>()->Value();
+  MessagePortRegistry::GetInstance()->Close(
+      port_id, MessagePortRegistry::kBrowserProcessId);
+
+  V8WorkerThread* worker = V8WorkerThread::current();
+  if (worker && worker->bindings())
+    worker->bindings()->ports_.erase(port_id);
+}
+
+void WorkerBindings::OnConnectPort(int port_id) {
+  v8::Isolate* isolate = context()->isolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Context> v8_context = context()->v8_context();
+  v8::Context::Scope context_scope(v8_context);
+
+  if (!MessagePortRegistry::GetInstance()->Bind(
+          port_id, MessagePortRegistry::kBrowserProcessId,
+          base::ThreadTaskRunnerHandle::Get(),
+          base::Bind(&WorkerBindings::DeliverPortMessage, port_id),
+          base::Bind(&WorkerBindings::DeliverPortClosed, port_id)))
+    return;
+
+  v8::Local<v8::Integer> id = v8::Integer::New(isolate, port_id);
+  v8::Local<v8::Object> port = v8::Object::New(isolate);
+  port->Set(v8::String::NewFromUtf8(isolate, "postMessage"),
+            v8::Function::New(v8_context, &WorkerBindings::PortPostMessage, id)
+                .ToLocalChecked());
+  port->Set(v8::String::NewFromUtf8(isolate, "close"),
+            v8::Function::New(v8_context, &WorkerBindings::PortClose, id)
+                .ToLocalChecked());
+  port->Set(v8::String::NewFromUtf8(isolate, "onmessage"), v8::Null(isolate));
+  port->Set(v8::String::NewFromUtf8(isolate, "onclose"), v8::Null(isolate));
+  ports_[port_id].Reset(isolate, port);
+
+  v8::Local<v8::Object> global = v8_context->Global();
+  v8::Local<v8::Value> onconnect;
+  if (!global->Get(v8_context, v8::String::NewFromUtf8(isolate, "onconnect"))
+           .ToLocal(&onconnect) ||
+      !onconnect->IsFunction())
+    return;
+
+  v8::Local<v8::Value> ports[] = {port};
+  v8::Local<v8::Object> event = v8::Object::New(isolate);
+  event->Set(v8::String::NewFromUtf8(isolate, "ports"),
+             v8::Array::New(isolate, ports, arraysize(ports)));
+  v8::Local<v8::Value> argv[] = {event};
+  (void)onconnect.As<v8::Function>()->Call(v8_context, global, 1, argv);
+}
+
+void WorkerBindings::OnPortMessage(int port_id,
+                                   std::unique_ptr<WorkerMessage> message) {
+  auto it = ports_.find(port_id);
+  if (it == ports_.end())
+    return;
+
+  v8::Isolate* isolate = context()->isolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Context> v8_context = context()->v8_context();
+  v8::Context::Scope context_scope(v8_context);
+
+  v8::Local<v8::Value> data;
+  if (!message->Deserialize(isolate).ToLocal(&data))
+    return;
+
+  v8::Local<v8::Object> port = it->second.Get(isolate);
+  v8::Local<v8::Value> onmessage;
+  if (!port->Get(v8_context, v8::String::NewFromUtf8(isolate, "onmessage"))
+           .ToLocal(&onmessage) ||
+      !onmessage->IsFunction())
+    return;
+
+  v8::Local<v8::Object> event = v8::Object::New(isolate);
+  event->Set(v8::String::NewFromUtf8(isolate, "data"), data);
+  v8::Local<v8::Value> argv[] = {event};
+  (void)onmessage.As<v8::Function>()->Call(v8_context, port, 1, argv);
+}
+
+void WorkerBindings::OnPortClosed(int port_id) {
+  auto it = ports_.find(port_id);
+  if (it == ports_.end())
+    return;
+
+  v8::Isolate* isolate = context()->isolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Context> v8_context = context()->v8_context();
+  v8::Context::Scope context_scope(v8_context);
+
+  // The registry already forgot the channel, so there is nothing to close.
+  v8::Local<v8::Object> port = it->second.Get(isolate);
+  ports_.erase(it);
+
+  v8::Local<v8::Value> onclose;
+  if (!port->Get(v8_context, v8::String::NewFromUtf8(isolate, "onclose"))
+           .ToLocal(&onclose) ||
+      !onclose->IsFunction())
+    return;
+
+  v8::Local<v8::Object> event = v8::Object::New(isolate);
+  v8::Local<v8::Value> argv[] = {event};
+  (void)onclose.As<v8::Function>()->Call(v8_context, port, 1, argv);
 }
 
 }  // namespace brave
@@ -5,8 +5,9 @@
 #ifndef BRAVE_COMMON_WORKERS_WORKER_BINDINGS_H_
 #define BRAVE_COMMON_WORKERS_WORKER_BINDINGS_H_
 
+#include <map>
+#include <memory>
 #include <string>
-#include <utility>
 
 #include "base/compiler_specific.h"
 #include "base/macros.h"
@@ -17,6 +18,7 @@
 namespace brave {
 
 class V8WorkerThread;
+class WorkerMessage;
 
 class WorkerBindings : public extensions::ObjectBackedNativeHandler {
  public:
@@ -26,13 +28,35 @@ class WorkerBindings : public extensions::ObjectBackedNativeHandler {
   // ObjectBackedNativeHandler:
   void AddRoutes() override;
 
+  // Posts |message| to the worker running on |thread_id|, moving the
+  // ArrayBuffers in |transfer_list|. Returns false with an exception thrown
+  // in |isolate| if the message could not be serialized, or without one if
+  // there is no such worker.
   static bool OnMessage(v8::Isolate* isolate,
                         base::PlatformThreadId thread_id,
-                        v8::Local<v8::Value> message);
+                        v8::Local<v8::Value> message,
+                        v8::Local<v8::Value> transfer_list);
+
+  // Hands the message port |port_id| to the worker running on |thread_id|,
+  // as the port of a connect event. Returns false, closing the port, if
+  // there is no such worker.
+  static bool ConnectPort(base::PlatformThreadId thread_id, int port_id);
 
  private:
+  // Run on the worker thread, for the bindings of the current worker.
+  static void ConnectPortInternal(int port_id);
+  static void DeliverPortMessage(int port_id,
+                                 std::unique_ptr<WorkerMessage> message);
+  static void DeliverPortClosed(int port_id);
+  static void PortPostMessage(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void PortClose(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  void OnConnectPort(int port_id);
+  void OnPortMessage(int port_id, std::unique_ptr<WorkerMessage> message);
+  void OnPortClosed(int port_id);
+
   void Close(const v8::FunctionCallbackInfo<v8::Value>& args);
-  void PostMessageOnUIThread(const std::pair<uint8_t*, size_t>& buffer);
+  void PostMessageOnUIThread(std::unique_ptr<WorkerMessage> message);
   void PostMessage(const v8::FunctionCallbackInfo<v8::Value>& args);
   void OnErrorOnUIThread(const std::string& message, const std::string& stack);
   void OnError(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -40,6 +64,9 @@ class WorkerBindings : public extensions::ObjectBackedNativeHandler {
   V8WorkerThread* worker_;
   v8::Local<v8::Function> on_message_;
 
+  // The message ports connected to the worker, by id.
+  std::map<int, v8::Global<v8::Object>> ports_;
+
   base::WeakPtrFactory<WorkerBindings> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(WorkerBindings);
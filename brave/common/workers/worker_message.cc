@@ -0,0 +1,314 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/workers/worker_message.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "base/lazy_instance.h"
+#include "base/synchronization/lock.h"
+#include "gin/array_buffer.h"
+
+namespace brave {
+
+namespace {
+
+// Live SharedBackingStores, by the address of their memory.
+base::LazyInstance<std::map<void*, SharedBackingStore*>>::Leaky
+    g_shared_stores = LAZY_INSTANCE_INITIALIZER;
+base::LazyInstance<base::Lock>::Leaky g_shared_stores_lock =
+    LAZY_INSTANCE_INITIALIZER;
+
+gin::ArrayBufferAllocator* allocator() {
+  // Every isolate of the process is created with this allocator.
+  return gin::ArrayBufferAllocator::SharedInstance();
+}
+
+void ThrowError(v8::Isolate* isolate, const char* message) {
+  isolate->ThrowException(v8::Exception::Error(
+      v8::String::NewFromUtf8(isolate, message, v8::NewStringType::kNormal)
+          .ToLocalChecked()));
+}
+
+}  // namespace
+
+// The memory of a SharedArrayBuffer shared between isolates. Every
+// SharedArrayBuffer object viewing the memory holds a reference, so it is
+// freed once the last of them has been garbage collected.
+class SharedBackingStore
+    : public base::RefCountedThreadSafe<SharedBackingStore> {
+ public:
+  // Returns the store of |buffer|, taking over its memory if no store has it
+  // yet. Returns null for buffers externalized by someone else.
+  static scoped_refptr<SharedBackingStore> ForBuffer(
+      v8::Isolate* isolate,
+      v8::Local<v8::SharedArrayBuffer> buffer) {
+    if (buffer->ByteLength() == 0)
+      return new SharedBackingStore(nullptr, 0);
+
+    base::AutoLock auto_lock(g_shared_stores_lock.Get());
+    if (buffer->IsExternal()) {
+      auto it = g_shared_stores.Get().find(buffer->GetContents().Data());
+      if (it == g_shared_stores.Get().end())
+        return nullptr;
+      return it->second;
+    }
+
+    v8::SharedArrayBuffer::Contents contents = buffer->Externalize();
+    scoped_refptr<SharedBackingStore> store(
+        new SharedBackingStore(contents.Data(), contents.ByteLength()));
+    g_shared_stores.Get()[contents.Data()] = store.get();
+    store->Track(isolate, buffer);
+    return store;
+  }
+
+  // Creates a SharedArrayBuffer viewing the memory in |isolate|.
+  v8::Local<v8::SharedArrayBuffer> NewBuffer(v8::Isolate* isolate) {
+    v8::Local<v8::SharedArrayBuffer> buffer = v8::SharedArrayBuffer::New(
+        isolate, data_, length_, v8::ArrayBufferCreationMode::kExternalized);
+    Track(isolate, buffer);
+    return buffer;
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<SharedBackingStore>;
+
+  struct Holder {
+    v8::Global<v8::SharedArrayBuffer> handle;
+    scoped_refptr<SharedBackingStore> store;
+  };
+
+  SharedBackingStore(void* data, size_t length)
+      : data_(data), length_(length) {}
+
+  ~SharedBackingStore() {
+    if (!data_)
+      return;
+    {
+      base::AutoLock auto_lock(g_shared_stores_lock.Get());
+      g_shared_stores.Get().erase(data_);
+    }
+    allocator()->Free(data_, length_);
+  }
+
+  // Keeps the memory alive for as long as |buffer| is. References held by
+  // buffers still alive when their isolate is disposed are leaked.
+  void Track(v8::Isolate* isolate, v8::Local<v8::SharedArrayBuffer> buffer) {
+    Holder* holder = new Holder;
+    holder->handle.Reset(isolate, buffer);
+    holder->store = this;
+    holder->handle.SetWeak(holder, &SharedBackingStore::OnBufferCollected,
+                           v8::WeakCallbackType::kParameter);
+  }
+
+  static void OnBufferCollected(const v8::WeakCallbackInfo<Holder>& info) {
+    Holder* holder = info.GetParameter();
+    holder->handle.Reset();
+    delete holder;
+  }
+
+  void* const data_;
+  const size_t length_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedBackingStore);
+};
+
+class WorkerMessage::SerializerDelegate
+    : public v8::ValueSerializer::Delegate {
+ public:
+  SerializerDelegate(v8::Isolate* isolate, WorkerMessage* message)
+      : isolate_(isolate), message_(message) {}
+
+  // v8::ValueSerializer::Delegate:
+  void ThrowDataCloneError(v8::Local<v8::String> message) override {
+    isolate_->ThrowException(v8::Exception::Error(message));
+  }
+
+  v8::Maybe<uint32_t> GetSharedArrayBufferId(
+      v8::Isolate* isolate,
+      v8::Local<v8::SharedArrayBuffer> buffer) override {
+    scoped_refptr<SharedBackingStore> store =
+        SharedBackingStore::ForBuffer(isolate, buffer);
+    if (!store) {
+      ThrowError(isolate, "SharedArrayBuffer can not be shared");
+      return v8::Nothing<uint32_t>();
+    }
+
+    auto& shared_buffers = message_->shared_buffers_;
+    auto it = std::find(shared_buffers.begin(), shared_buffers.end(), store);
+    if (it != shared_buffers.end())
+      return v8::Just<uint32_t>(it - shared_buffers.begin());
+    shared_buffers.push_back(store);
+    return v8::Just<uint32_t>(shared_buffers.size() - 1);
+  }
+
+ private:
+  v8::Isolate* isolate_;
+  WorkerMessage* message_;
+
+  DISALLOW_COPY_AND_ASSIGN(SerializerDelegate);
+};
+
+class WorkerMessage::DeserializerDelegate
+    : public v8::ValueDeserializer::Delegate {
+ public:
+  explicit DeserializerDelegate(WorkerMessage* message) : message_(message) {}
+
+  // v8::ValueDeserializer::Delegate:
+  v8::MaybeLocal<v8::SharedArrayBuffer> GetSharedArrayBufferFromId(
+      v8::Isolate* isolate, uint32_t clone_id) override {
+    if (clone_id >= message_->shared_buffers_.size())
+      return v8::MaybeLocal<v8::SharedArrayBuffer>();
+    return message_->shared_buffers_[clone_id]->NewBuffer(isolate);
+  }
+
+ private:
+  WorkerMessage* message_;
+
+  DISALLOW_COPY_AND_ASSIGN(DeserializerDelegate);
+};
+
+WorkerMessage::WorkerMessage() : size_(0) {
+}
+
+WorkerMessage::~WorkerMessage() {
+  // Buffers of a message that was never delivered.
+  for (const auto& buffer : array_buffers_) {
+    if (buffer.data)
+      allocator()->Free(buffer.data, buffer.length);
+  }
+}
+
+bool WorkerMessage::Serialize(v8::Isolate* isolate,
+                              v8::Local<v8::Value> value,
+                              v8::Local<v8::Value> transfer_list) {
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+  std::vector<v8::Local<v8::ArrayBuffer>> array_buffers;
+  if (!transfer_list.IsEmpty() && !transfer_list->IsUndefined()) {
+    if (!transfer_list->IsArray()) {
+      ThrowError(isolate, "`transferList` must be an Array");
+      return false;
+    }
+    v8::Local<v8::Array> list = transfer_list.As<v8::Array>();
+    for (uint32_t i = 0; i < list->Length(); ++i) {
+      v8::Local<v8::Value> item;
+      if (!list->Get(context, i).ToLocal(&item))
+        return false;
+      if (!item->IsArrayBuffer()) {
+        ThrowError(isolate, "Only ArrayBuffers can be transferred");
+        return false;
+      }
+      v8::Local<v8::ArrayBuffer> buffer = item.As<v8::ArrayBuffer>();
+      if (!buffer->IsNeuterable() ||
+          std::find(array_buffers.begin(), array_buffers.end(), buffer) !=
+              array_buffers.end()) {
+        ThrowError(isolate, "ArrayBuffer can not be transferred");
+        return false;
+      }
+      array_buffers.push_back(buffer);
+    }
+  }
+
+  SerializerDelegate delegate(isolate, this);
+  v8::ValueSerializer serializer(isolate, &delegate);
+  serializer.WriteHeader();
+  for (size_t i = 0; i < array_buffers.size(); ++i)
+    serializer.TransferArrayBuffer(i, array_buffers[i]);
+  if (!serializer.WriteValue(context, value).FromMaybe(false)) {
+    shared_buffers_.clear();
+    return false;
+  }
+
+  std::pair<uint8_t*, size_t> buffer = serializer.Release();
+  data_.reset(buffer.first);
+  size_ = buffer.second;
+
+  // The value is written, move the memory of the transferred buffers out of
+  // |isolate|.
+  for (auto array_buffer : array_buffers) {
+    TransferredBuffer transferred;
+    transferred.length = array_buffer->ByteLength();
+    if (array_buffer->IsExternal()) {
+      // The memory belongs to someone else, e.g. a node::Buffer, so this one
+      // has to be copied after all.
+      transferred.data =
+          allocator()->AllocateUninitialized(transferred.length);
+      memcpy(transferred.data, array_buffer->GetContents().Data(),
+             transferred.length);
+    } else {
+      transferred.data = array_buffer->Externalize().Data();
+    }
+    array_buffer->Neuter();
+    array_buffers_.push_back(transferred);
+  }
+  return true;
+}
+
+v8::MaybeLocal<v8::Value> WorkerMessage::Deserialize(v8::Isolate* isolate) {
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+  DeserializerDelegate delegate(this);
+  v8::ValueDeserializer deserializer(isolate, data_.get(), size_, &delegate);
+  deserializer.SetSupportsLegacyWireFormat(true);
+  for (size_t i = 0; i < array_buffers_.size(); ++i) {
+    TransferredBuffer& transferred = array_buffers_[i];
+    deserializer.TransferArrayBuffer(i, v8::ArrayBuffer::New(
+        isolate, transferred.data, transferred.length,
+        v8::ArrayBufferCreationMode::kInternalized));
+    // Owned by |isolate| now.
+    transferred.data = nullptr;
+  }
+  // Buffers from another process are copied into memory of |isolate|, whose
+  // allocator may not be the one of this process' other isolates.
+  for (size_t i = 0; i < wire_buffers_.size(); ++i) {
+    const std::vector<uint8_t>& bytes = wire_buffers_[i];
+    v8::Local<v8::ArrayBuffer> buffer =
+        v8::ArrayBuffer::New(isolate, bytes.size());
+    if (!bytes.empty())
+      memcpy(buffer->GetContents().Data(), bytes.data(), bytes.size());
+    deserializer.TransferArrayBuffer(array_buffers_.size() + i, buffer);
+  }
+  wire_buffers_.clear();
+
+  if (!deserializer.ReadHeader(context).FromMaybe(false))
+    return v8::MaybeLocal<v8::Value>();
+  return deserializer.ReadValue(context);
+}
+
+bool WorkerMessage::ToWire(
+    std::vector<uint8_t>* data,
+    std::vector<std::vector<uint8_t>>* array_buffers) const {
+  if (!shared_buffers_.empty())
+    return false;
+
+  data->assign(data_.get(), data_.get() + size_);
+  array_buffers->clear();
+  for (const auto& buffer : array_buffers_) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(buffer.data);
+    array_buffers->emplace_back(bytes, bytes + buffer.length);
+  }
+  array_buffers->insert(array_buffers->end(), wire_buffers_.begin(),
+                        wire_buffers_.end());
+  return true;
+}
+
+// static
+std::unique_ptr<WorkerMessage> WorkerMessage::FromWire(
+    const std::vector<uint8_t>& data,
+    const std::vector<std::vector<uint8_t>>& array_buffers) {
+  std::unique_ptr<WorkerMessage> message(new WorkerMessage);
+  message->size_ = data.size();
+  message->data_.reset(static_cast<uint8_t*>(malloc(data.size())));
+  memcpy(message->data_.get(), data.data(), data.size());
+  message->wire_buffers_ = array_buffers;
+  return message;
+}
+
+}  // namespace brave
@@ -0,0 +1,81 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_WORKERS_WORKER_MESSAGE_H_
+#define BRAVE_COMMON_WORKERS_WORKER_MESSAGE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/free_deleter.h"
+#include "base/memory/ref_counted.h"
+#include "v8/include/v8.h"
+
+namespace brave {
+
+class SharedBackingStore;
+
+// A value serialized with v8::ValueSerializer in one isolate, to be
+// deserialized in another one, usually on another thread.
+//
+// ArrayBuffers in the transfer list are not copied: their memory is detached
+// from the sending isolate and handed to the receiving one. SharedArrayBuffers
+// anywhere in the value are shared, both isolates end up with a view of the
+// same memory.
+class WorkerMessage {
+ public:
+  WorkerMessage();
+  ~WorkerMessage();
+
+  // Serializes |value|. |transfer_list| can be undefined or an array of
+  // ArrayBuffers, which are neutered on success. On failure an exception is
+  // thrown in |isolate| and false is returned.
+  bool Serialize(v8::Isolate* isolate,
+                 v8::Local<v8::Value> value,
+                 v8::Local<v8::Value> transfer_list);
+
+  // Reads the value back in |isolate|, which takes ownership of the
+  // transferred buffers. Can only be called once.
+  v8::MaybeLocal<v8::Value> Deserialize(v8::Isolate* isolate);
+
+  // Copies the message into plain bytes that can be sent to another process.
+  // Fails for messages sharing SharedArrayBuffers. Transferred ArrayBuffers
+  // are copied, the receiving process gets them as transferred ones.
+  bool ToWire(std::vector<uint8_t>* data,
+              std::vector<std::vector<uint8_t>>* array_buffers) const;
+
+  // Reverses ToWire.
+  static std::unique_ptr<WorkerMessage> FromWire(
+      const std::vector<uint8_t>& data,
+      const std::vector<std::vector<uint8_t>>& array_buffers);
+
+ private:
+  class SerializerDelegate;
+  class DeserializerDelegate;
+
+  struct TransferredBuffer {
+    // Allocated with gin::ArrayBufferAllocator, owned by the message until it
+    // is deserialized.
+    void* data;
+    size_t length;
+  };
+
+  // Written by v8::ValueSerializer.
+  std::unique_ptr<uint8_t, base::FreeDeleter> data_;
+  size_t size_;
+  std::vector<TransferredBuffer> array_buffers_;
+  // Transferred buffers received from another process, see FromWire.
+  std::vector<std::vector<uint8_t>> wire_buffers_;
+  std::vector<scoped_refptr<SharedBackingStore>> shared_buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerMessage);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_WORKERS_WORKER_MESSAGE_H_
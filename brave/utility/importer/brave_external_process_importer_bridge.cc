@@ -4,20 +4,42 @@
 
 #include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "brave/utility/importer/brave_external_process_importer_bridge.h"
 
 #include "base/logging.h"
 #include "build/build_config.h"
+#include "chrome/common/importer/importer_url_row.h"
 
 using chrome::mojom::ProfileImportObserver;
 
 namespace {
 
 const int kNumCookiesToSend = 100;
+const size_t kNumHistoryRowsToSend = 100;
+
+// Rows sent to the browser and not consumed yet. A single group larger than
+// this is still sent once nothing else is in flight.
+const size_t kMaxRowsInFlight = 5000;
 
 }  // namespace
 
+void BraveExternalProcessImporterBridge::SetHistoryItems(
+    const std::vector<ImporterURLRow>& rows,
+    importer::VisitSource visit_source) {
+  (*observer_)->OnHistoryImportStart(rows.size());
+
+  for (size_t begin = 0; begin < rows.size();
+       begin += kNumHistoryRowsToSend) {
+    size_t end = std::min(rows.size(), begin + kNumHistoryRowsToSend);
+    WaitForRoom(end - begin);
+    (*observer_)->OnHistoryImportGroup(
+        std::vector<ImporterURLRow>(rows.begin() + begin, rows.begin() + end),
+        visit_source);
+  }
+}
+
 void BraveExternalProcessImporterBridge::SetCookies(
     const std::vector<ImportedCookieEntry>& cookies) {
   (*observer_)->OnCookiesImportStart(cookies.size());
@@ -33,6 +55,7 @@ void BraveExternalProcessImporterBridge::SetCookies(
         it + std::min(cookies_left, kNumCookiesToSend);
     cookies_group.assign(it, end_group);
 
+    WaitForRoom(cookies_group.size());
     (*observer_)->OnCookiesImportGroup(cookies_group);
     cookies_left -= end_group - it;
     it = end_group;
@@ -40,9 +63,40 @@ void BraveExternalProcessImporterBridge::SetCookies(
   DCHECK_EQ(0, cookies_left);
 }
 
+void BraveExternalProcessImporterBridge::NotifyItemStats(
+    importer::ImportItem item,
+    size_t rows,
+    base::TimeDelta elapsed) {
+  (*observer_)->OnImportItemStats(item, static_cast<uint32_t>(rows),
+                                  elapsed.InMicroseconds());
+}
+
+void BraveExternalProcessImporterBridge::RowsConsumed(size_t rows) {
+  base::AutoLock auto_lock(flow_lock_);
+  rows_in_flight_ -= std::min(rows, rows_in_flight_);
+  room_available_.Broadcast();
+}
+
+void BraveExternalProcessImporterBridge::StopWaitingForBrowser() {
+  base::AutoLock auto_lock(flow_lock_);
+  waiting_stopped_ = true;
+  room_available_.Broadcast();
+}
+
+void BraveExternalProcessImporterBridge::WaitForRoom(size_t rows) {
+  base::AutoLock auto_lock(flow_lock_);
+  while (!waiting_stopped_ && rows_in_flight_ > 0 &&
+         rows_in_flight_ + rows > kMaxRowsInFlight)
+    room_available_.Wait();
+  rows_in_flight_ += rows;
+}
+
 BraveExternalProcessImporterBridge::BraveExternalProcessImporterBridge(
     base::Value localized_strings,
     scoped_refptr<chrome::mojom::ThreadSafeProfileImportObserverPtr> observer)
-    : ExternalProcessImporterBridge(std::move(localized_strings), observer) {}
+    : ExternalProcessImporterBridge(std::move(localized_strings), observer),
+      room_available_(&flow_lock_),
+      rows_in_flight_(0),
+      waiting_stopped_(false) {}
 
 BraveExternalProcessImporterBridge::~BraveExternalProcessImporterBridge() {}
@@ -5,8 +5,13 @@
 #ifndef BRAVE_UTILITY_IMPORTER_BRAVE_EXTERNAL_PROCESS_IMPORTER_BRIDGE_H_
 #define BRAVE_UTILITY_IMPORTER_BRAVE_EXTERNAL_PROCESS_IMPORTER_BRIDGE_H_
 
+#include <stddef.h>
+
 #include <vector>
 
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
 #include "chrome/utility/importer/external_process_importer_bridge.h"
 
 struct ImportedCookieEntry;
@@ -20,10 +25,39 @@ class BraveExternalProcessImporterBridge :
       scoped_refptr<chrome::mojom::ThreadSafeProfileImportObserverPtr>
           observer);
 
+  // History and cookies are sent in groups that the browser hands on to JS
+  // as they arrive. Sending blocks the calling thread while the browser has
+  // not consumed enough of the earlier rows, so memory use is bounded by how
+  // fast JS keeps up rather than by the size of the profile.
+  void SetHistoryItems(const std::vector<ImporterURLRow>& rows,
+                       importer::VisitSource visit_source) override;
   void SetCookies(const std::vector<ImportedCookieEntry>& cookies);
+
+  // The browser is done with |rows| of the rows sent so far.
+  void RowsConsumed(size_t rows);
+
+  // Stops blocking senders, for when the import is cancelled or the browser
+  // went away.
+  void StopWaitingForBrowser();
+
+  // Reports that |item| handed |rows| rows to the bridge in |elapsed|. May be
+  // called from any thread, like the rest of the bridge.
+  void NotifyItemStats(importer::ImportItem item,
+                       size_t rows,
+                       base::TimeDelta elapsed);
+
  private:
   ~BraveExternalProcessImporterBridge() override;
 
+  // Waits until |rows| more rows can be sent.
+  void WaitForRoom(size_t rows);
+
+  base::Lock flow_lock_;
+  base::ConditionVariable room_available_;
+  // Guarded by |flow_lock_|.
+  size_t rows_in_flight_;
+  bool waiting_stopped_;
+
   DISALLOW_COPY_AND_ASSIGN(BraveExternalProcessImporterBridge);
 };
 
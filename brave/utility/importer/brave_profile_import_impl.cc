@@ -29,7 +29,15 @@ BraveProfileImportImpl::BraveProfileImportImpl(
     std::unique_ptr<service_manager::ServiceContextRef> service_ref)
     : ProfileImportImpl(std::move(service_ref)) {}
 
-BraveProfileImportImpl::~BraveProfileImportImpl() {}
+BraveProfileImportImpl::~BraveProfileImportImpl() {
+  // The browser is gone, don't leave the import thread waiting for it.
+  if (bridge())
+    bridge()->StopWaitingForBrowser();
+}
+
+BraveExternalProcessImporterBridge* BraveProfileImportImpl::bridge() {
+  return static_cast<BraveExternalProcessImporterBridge*>(bridge_.get());
+}
 
 void BraveProfileImportImpl::StartImport(
     const importer::SourceProfile& source_profile,
@@ -69,3 +77,14 @@ void BraveProfileImportImpl::StartImport(
                                 source_profile, items,
                                 base::RetainedRef(bridge_)));
 }
+
+void BraveProfileImportImpl::CancelImport() {
+  if (bridge())
+    bridge()->StopWaitingForBrowser();
+  ProfileImportImpl::CancelImport();
+}
+
+void BraveProfileImportImpl::ImportRowsConsumed(uint32_t rows) {
+  if (bridge())
+    bridge()->RowsConsumed(rows);
+}
@@ -9,6 +9,8 @@
 
 #include "chrome/utility/importer/profile_import_impl.h"
 
+class BraveExternalProcessImporterBridge;
+
 class BraveProfileImportImpl : public ProfileImportImpl {
  public:
   explicit BraveProfileImportImpl(
@@ -21,6 +23,10 @@ class BraveProfileImportImpl : public ProfileImportImpl {
                    uint16_t items,
                    base::Value localized_strings,
                    chrome::mojom::ProfileImportObserverPtr observer) override;
+  void CancelImport() override;
+  void ImportRowsConsumed(uint32_t rows) override;
+
+  BraveExternalProcessImporterBridge* bridge();
 
   DISALLOW_COPY_AND_ASSIGN(BraveProfileImportImpl);
 };
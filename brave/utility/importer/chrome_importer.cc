@@ -8,6 +8,7 @@
 #include <string>
 
 #include "brave/utility/importer/brave_external_process_importer_bridge.h"
+#include "base/bind.h"
 #include "base/files/file_util.h"
 #include "base/json/json_reader.h"
 #include "base/macros.h"
@@ -16,6 +17,8 @@
 #include "base/strings/utf_string_conversions.h"
 #include "base/values.h"
 #include "brave/common/importer/imported_cookie_entry.h"
+#include "brave/utility/importer/import_item_runner.h"
+#include "brave/utility/importer/sqlite_snapshot.h"
 #include "build/build_config.h"
 #include "chrome/common/importer/imported_bookmark_entry.h"
 #include "chrome/common/importer/importer_bridge.h"
@@ -64,46 +67,52 @@ void ChromeImporter::StartImport(const importer::SourceProfile& source_profile,
   bridge_ = bridge;
   source_path_ = source_profile.source_path;
 
-  // The order here is important!
   bridge_->NotifyStarted();
 
-  if ((items & importer::HISTORY) && !cancelled()) {
-    bridge_->NotifyItemStarted(importer::HISTORY);
-    ImportHistory();
-    bridge_->NotifyItemEnded(importer::HISTORY);
+  // The items read separate files, so they run side by side. Passwords stay
+  // on the import thread, where the keyring backends expect to be used.
+  brave_importer::ImportItemRunner runner(
+      static_cast<BraveExternalProcessImporterBridge*>(bridge_.get()));
+  if ((items & importer::HISTORY) && !import_cancelled()) {
+    runner.Post(importer::HISTORY,
+                base::BindOnce(&ChromeImporter::ImportHistory, this));
   }
 
-  if ((items & importer::FAVORITES) && !cancelled()) {
-    bridge_->NotifyItemStarted(importer::FAVORITES);
-    ImportBookmarks();
-    bridge_->NotifyItemEnded(importer::FAVORITES);
+  if ((items & importer::FAVORITES) && !import_cancelled()) {
+    runner.Post(importer::FAVORITES,
+                base::BindOnce(&ChromeImporter::ImportBookmarks, this));
   }
 
-  if ((items & importer::COOKIES) && !cancelled()) {
-    bridge_->NotifyItemStarted(importer::COOKIES);
-    ImportCookies();
-    bridge_->NotifyItemEnded(importer::COOKIES);
+  if ((items & importer::COOKIES) && !import_cancelled()) {
+    runner.Post(importer::COOKIES,
+                base::BindOnce(&ChromeImporter::ImportCookies, this));
   }
 
-  if ((items & importer::PASSWORDS) && !cancelled()) {
-    bridge_->NotifyItemStarted(importer::PASSWORDS);
-    ImportPasswords();
-    bridge_->NotifyItemEnded(importer::PASSWORDS);
+  if ((items & importer::PASSWORDS) && !import_cancelled()) {
+    runner.Run(importer::PASSWORDS,
+               base::BindOnce(&ChromeImporter::ImportPasswords, this));
   }
+  runner.Wait();
 
   bridge_->NotifyEnded();
 }
 
-void ChromeImporter::ImportHistory() {
+void ChromeImporter::Cancel() {
+  cancel_flag_.Set();
+  Importer::Cancel();
+}
+
+size_t ChromeImporter::ImportHistory() {
   base::FilePath history_path =
     source_path_.Append(
       base::FilePath::StringType(FILE_PATH_LITERAL("History")));
-  if (!base::PathExists(history_path))
-    return;
+  brave_importer::SQLiteSnapshot snapshot;
+  if (!snapshot.Create(history_path))
+    return 0;
 
   sql::Connection db;
-  if (!db.Open(history_path))
-    return;
+  if (!db.Open(snapshot.path()))
+    return 0;
 
   const char query[] =
     "SELECT url, title, last_visit_time, typed_count, visit_count "
@@ -112,7 +121,7 @@ void ChromeImporter::ImportHistory() {
   sql::Statement s(db.GetUniqueStatement(query));
 
   std::vector<ImporterURLRow> rows;
-  while (s.Step() && !cancelled()) {
+  while (s.Step() && !import_cancelled()) {
     GURL url(s.ColumnString(0));
 
     ImporterURLRow row(url);
@@ -126,11 +135,13 @@ void ChromeImporter::ImportHistory() {
     rows.push_back(row);
   }
 
-  if (!rows.empty() && !cancelled())
-    bridge_->SetHistoryItems(rows, importer::VISIT_SOURCE_CHROME_IMPORTED);
+  if (rows.empty() || import_cancelled())
+    return 0;
+  bridge_->SetHistoryItems(rows, importer::VISIT_SOURCE_CHROME_IMPORTED);
+  return rows.size();
 }
 
-void ChromeImporter::ImportBookmarks() {
+size_t ChromeImporter::ImportBookmarks() {
   std::string bookmarks_content;
   base::FilePath bookmarks_path =
     source_path_.Append(
@@ -140,7 +151,7 @@ void ChromeImporter::ImportBookmarks() {
     base::JSONReader::Read(bookmarks_content);
   const base::DictionaryValue* bookmark_dict;
   if (!bookmarks_json || !bookmarks_json->GetAsDictionary(&bookmark_dict))
-    return;
+    return 0;
   std::vector<ImportedBookmarkEntry> bookmarks;
   const base::DictionaryValue* roots;
   const base::DictionaryValue* bookmark_bar;
@@ -166,31 +177,36 @@ void ChromeImporter::ImportBookmarks() {
     }
   }
   // Write into profile.
-  if (!bookmarks.empty() && !cancelled()) {
+  size_t rows = 0;
+  if (!bookmarks.empty() && !import_cancelled()) {
     const base::string16& first_folder_name =
       base::UTF8ToUTF16("Imported from Chrome");
     bridge_->AddBookmarks(bookmarks, first_folder_name);
+    rows += bookmarks.size();
   }
 
   // Import favicons.
   base::FilePath favicons_path =
     source_path_.Append(
       base::FilePath::StringType(FILE_PATH_LITERAL("Favicons")));
-  if (!base::PathExists(favicons_path))
-    return;
+  brave_importer::SQLiteSnapshot snapshot;
+  if (!snapshot.Create(favicons_path))
+    return rows;
 
   sql::Connection db;
-  if (!db.Open(favicons_path))
-    return;
+  if (!db.Open(snapshot.path()))
+    return rows;
 
   FaviconMap favicon_map;
   ImportFaviconURLs(&db, &favicon_map);
   // Write favicons into profile.
-  if (!favicon_map.empty() && !cancelled()) {
+  if (!favicon_map.empty() && !import_cancelled()) {
     favicon_base::FaviconUsageDataList favicons;
     LoadFaviconData(&db, favicon_map, &favicons);
     bridge_->SetFavicons(favicons);
+    rows += favicons.size();
   }
+  return rows;
 }
 
 void ChromeImporter::ImportFaviconURLs(
@@ -199,7 +215,7 @@ void ChromeImporter::ImportFaviconURLs(
   const char query[] = "SELECT icon_id, page_url FROM icon_mapping;";
   sql::Statement s(db->GetUniqueStatement(query));
 
-  while (s.Step() && !cancelled()) {
+  while (s.Step() && !import_cancelled()) {
     int64_t icon_id = s.ColumnInt64(0);
     GURL url = GURL(s.ColumnString(1));
     (*favicon_map)[icon_id].insert(url);
@@ -246,16 +262,17 @@ void ChromeImporter::LoadFaviconData(
   }
 }
 
-void ChromeImporter::ImportCookies() {
+size_t ChromeImporter::ImportCookies() {
   base::FilePath cookies_path =
     source_path_.Append(
       base::FilePath::StringType(FILE_PATH_LITERAL("Cookies")));
-  if (!base::PathExists(cookies_path))
-    return;
+  brave_importer::SQLiteSnapshot snapshot;
+  if (!snapshot.Create(cookies_path))
+    return 0;
 
   sql::Connection db;
-  if (!db.Open(cookies_path))
-    return;
+  if (!db.Open(snapshot.path()))
+    return 0;
 
   const char query[] =
     "SELECT host_key, name, value, path, expires_utc, secure, httponly, "
@@ -263,8 +280,15 @@ void ChromeImporter::ImportCookies() {
 
   sql::Statement s(db.GetUniqueStatement(query));
 
+  net::CookieCryptoDelegate* delegate =
+    cookie_config::GetCookieCryptoDelegate();
+#if defined(OS_LINUX)
+  if (delegate)
+    OSCrypt::SetConfig(std::make_unique<os_crypt::Config>());
+#endif
+
   std::vector<ImportedCookieEntry> cookies;
-  while (s.Step() && !cancelled()) {
+  while (s.Step() && !import_cancelled()) {
     ImportedCookieEntry cookie;
     base::string16 host;
     base::string16 host_key = s.ColumnString16(0);
@@ -286,13 +310,8 @@ void ChromeImporter::ImportCookies() {
     cookie.secure = s.ColumnBool(5);
     cookie.httponly = s.ColumnBool(6);
     std::string encrypted_value = s.ColumnString(7);
-    net::CookieCryptoDelegate* delegate =
-      cookie_config::GetCookieCryptoDelegate();
     std::string value;
     if (!encrypted_value.empty() && delegate) {
-#if defined(OS_LINUX)
-      OSCrypt::SetConfig(std::make_unique<os_crypt::Config>());
-#endif
       if (!delegate->DecryptString(encrypted_value, &value)) {
         continue;
       }
@@ -304,21 +323,29 @@ void ChromeImporter::ImportCookies() {
     cookies.push_back(cookie);
   }
 
-  if (!cookies.empty() && !cancelled())
-    static_cast<BraveExternalProcessImporterBridge*>(bridge_.get())->
-        SetCookies(cookies);
+  if (cookies.empty() || import_cancelled())
+    return 0;
+  static_cast<BraveExternalProcessImporterBridge*>(bridge_.get())->
+      SetCookies(cookies);
+  return cookies.size();
 }
 
-void ChromeImporter::ImportPasswords() {
+size_t ChromeImporter::ImportPasswords() {
+  size_t rows = 0;
 #if !defined(USE_X11)
   base::FilePath passwords_path =
     source_path_.Append(
       base::FilePath::StringType(FILE_PATH_LITERAL("Login Data")));
+  // LoginDatabase migrates the schema it opens, which must not happen to the
+  // other browser's database.
+  brave_importer::SQLiteSnapshot snapshot;
+  if (!snapshot.Create(passwords_path))
+    return 0;
 
-  password_manager::LoginDatabase database(passwords_path);
+  password_manager::LoginDatabase database(snapshot.path());
   if (!database.Init()) {
     LOG(ERROR) << "LoginDatabase Init() failed";
-    return;
+    return 0;
   }
 
   std::vector<std::unique_ptr<autofill::PasswordForm>> forms;
@@ -327,6 +354,7 @@ void ChromeImporter::ImportPasswords() {
     for (size_t i = 0; i < forms.size(); ++i) {
       bridge_->SetPasswordForm(*forms[i].get());
     }
+    rows += forms.size();
   }
   std::vector<std::unique_ptr<autofill::PasswordForm>> blacklist;
   success = database.GetBlacklistLogins(&blacklist);
@@ -334,6 +362,7 @@ void ChromeImporter::ImportPasswords() {
     for (size_t i = 0; i < blacklist.size(); ++i) {
       bridge_->SetPasswordForm(*blacklist[i].get());
     }
+    rows += blacklist.size();
   }
 #else
   base::FilePath prefs_path =
@@ -343,13 +372,13 @@ void ChromeImporter::ImportPasswords() {
   scoped_refptr<JsonPrefStore> prefs = new JsonPrefStore(prefs_path);
   int local_profile_id;
   if (prefs->ReadPrefs() != PersistentPrefStore::PREF_READ_ERROR_NONE) {
-    return;
+    return 0;
   }
   if (!prefs->GetValue(password_manager::prefs::kLocalProfileId, &value)) {
-    return;
+    return 0;
   }
   if (!value->GetAsInteger(&local_profile_id)) {
-    return;
+    return 0;
   }
 
   std::unique_ptr<PasswordStoreX::NativeBackend> backend;
@@ -387,6 +416,7 @@ void ChromeImporter::ImportPasswords() {
       for (size_t i = 0; i < forms.size(); ++i) {
         bridge_->SetPasswordForm(*forms[i].get());
       }
+      rows += forms.size();
     }
     std::vector<std::unique_ptr<autofill::PasswordForm>> blacklist;
     success = backend->GetBlacklistLogins(&blacklist);
@@ -394,9 +424,11 @@ void ChromeImporter::ImportPasswords() {
       for (size_t i = 0; i < blacklist.size(); ++i) {
         bridge_->SetPasswordForm(*blacklist[i].get());
       }
+      rows += blacklist.size();
     }
   }
 #endif
+  return rows;
 }
 
 void ChromeImporter::RecursiveReadBookmarksFolder(
@@ -5,6 +5,7 @@
 #ifndef BRAVE_UTILITY_IMPORTER_CHROME_IMPORTER_H_
 #define BRAVE_UTILITY_IMPORTER_CHROME_IMPORTER_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <map>
@@ -15,6 +16,7 @@
 #include "base/files/file_path.h"
 #include "base/macros.h"
 #include "base/nix/xdg_util.h"
+#include "base/synchronization/atomic_flag.h"
 #include "build/build_config.h"
 #include "chrome/utility/importer/importer.h"
 #include "components/favicon_base/favicon_usage_data.h"
@@ -37,16 +39,21 @@ class ChromeImporter : public Importer {
   void StartImport(const importer::SourceProfile& source_profile,
                    uint16_t items,
                    ImporterBridge* bridge) override;
+  void Cancel() override;
 
  private:
   ~ChromeImporter() override;
 
+  // Like cancelled(), but safe to read from the workers items run on.
+  bool import_cancelled() const { return cancel_flag_.IsSet(); }
+
   static base::nix::DesktopEnvironment GetDesktopEnvironment();
 
-  void ImportBookmarks();
-  void ImportHistory();
-  void ImportCookies();
-  void ImportPasswords();
+  // Each returns the number of rows handed to the bridge.
+  size_t ImportBookmarks();
+  size_t ImportHistory();
+  size_t ImportCookies();
+  size_t ImportPasswords();
 
   // Multiple URLs can share the same favicon; this is a map
   // of URLs -> IconIDs that we load as a temporary step before
@@ -72,6 +79,7 @@ class ChromeImporter : public Importer {
   double chromeTimeToDouble(int64_t time);
 
   base::FilePath source_path_;
+  base::AtomicFlag cancel_flag_;
 
   DISALLOW_COPY_AND_ASSIGN(ChromeImporter);
 };
@@ -6,6 +6,7 @@
 
 #include <vector>
 
+#include "base/bind.h"
 #include "base/files/file_enumerator.h"
 #include "base/files/file_util.h"
 #include "base/macros.h"
@@ -13,6 +14,8 @@
 #include "base/strings/utf_string_conversions.h"
 #include "brave/common/importer/imported_cookie_entry.h"
 #include "brave/utility/importer/brave_external_process_importer_bridge.h"
+#include "brave/utility/importer/import_item_runner.h"
+#include "brave/utility/importer/sqlite_snapshot.h"
 #include "build/build_config.h"
 #include "chrome/grit/generated_resources.h"
 #include "components/autofill/core/common/password_form.h"
@@ -22,6 +25,8 @@
 
 namespace brave {
 
+using brave_importer::SQLiteSnapshot;
+
 FirefoxImporter::FirefoxImporter() {
 }
 
@@ -31,33 +36,52 @@ FirefoxImporter::~FirefoxImporter() {
 void FirefoxImporter::StartImport(const importer::SourceProfile& source_profile,
                                   uint16_t items,
                                   ImporterBridge* bridge) {
+  source_path_ = source_profile.source_path;
+
+  // The base importer notifies that the import started, so our own items
+  // only begin once it returns.
   ::FirefoxImporter::StartImport(source_profile, items, bridge);
 
-  bridge_ = bridge;
-  source_path_ = source_profile.source_path;
-  if ((items & importer::COOKIES) && !cancelled()) {
-    bridge_->NotifyItemStarted(importer::COOKIES);
-    ImportCookies();
-    bridge_->NotifyItemEnded(importer::COOKIES);
+  // Cookies come from their own database, so they are read while the site
+  // password prefs are imported on this thread.
+  scoped_refptr<BraveExternalProcessImporterBridge> brave_bridge =
+      static_cast<BraveExternalProcessImporterBridge*>(bridge);
+  brave_importer::ImportItemRunner runner(brave_bridge.get());
+  if ((items & importer::COOKIES) && !import_cancelled()) {
+    runner.Post(importer::COOKIES,
+                base::BindOnce(&FirefoxImporter::ImportCookies, this,
+                               brave_bridge));
   }
-  if ((items & importer::PASSWORDS) && !cancelled()) {
+
+  bridge_ = bridge;
+  // The base importer started PASSWORDS and leaves ending it to us.
+  if ((items & importer::PASSWORDS) && !import_cancelled()) {
     ImportSitePasswordPrefs();
     bridge_->NotifyItemEnded(importer::PASSWORDS);
   }
+  runner.Wait();
 
   bridge_->NotifyEnded();
 }
 
+void FirefoxImporter::Cancel() {
+  cancel_flag_.Set();
+  ::FirefoxImporter::Cancel();
+}
+
 
-void FirefoxImporter::ImportCookies() {
+size_t FirefoxImporter::ImportCookies(
+    scoped_refptr<BraveExternalProcessImporterBridge> bridge) {
   base::FilePath file = source_path_.AppendASCII("cookies.sqlite");
-  if (!base::PathExists(file)) {
-    return;
+  // Firefox keeps its databases locked while it runs.
+  SQLiteSnapshot snapshot;
+  if (!snapshot.Create(file)) {
+    return 0;
   }
 
   sql::Connection db;
-  if (!db.Open(file)) {
-    return;
+  if (!db.Open(snapshot.path())) {
+    return 0;
   }
 
   const char query[] =
@@ -67,7 +91,7 @@ void FirefoxImporter::ImportCookies() {
   sql::Statement s(db.GetUniqueStatement(query));
 
   std::vector<ImportedCookieEntry> cookies;
-  while (s.Step() && !cancelled()) {
+  while (s.Step() && !import_cancelled()) {
     ImportedCookieEntry cookie;
     base::string16 domain(base::UTF8ToUTF16("."));
     domain.append(s.ColumnString16(0));
@@ -91,19 +115,21 @@ void FirefoxImporter::ImportCookies() {
     cookies.push_back(cookie);
   }
 
-  if (!cookies.empty() && !cancelled())
-    static_cast<BraveExternalProcessImporterBridge*>(bridge_.get())->
-        SetCookies(cookies);
+  if (cookies.empty() || import_cancelled())
+    return 0;
+  bridge->SetCookies(cookies);
+  return cookies.size();
 }
 
 void FirefoxImporter::ImportSitePasswordPrefs() {
   base::FilePath file = source_path_.AppendASCII("permissions.sqlite");
-  if (!base::PathExists(file)) {
+  SQLiteSnapshot snapshot;
+  if (!snapshot.Create(file)) {
     return;
   }
 
   sql::Connection db;
-  if (!db.Open(file)) {
+  if (!db.Open(snapshot.path())) {
     return;
   }
 
@@ -119,7 +145,7 @@ void FirefoxImporter::ImportSitePasswordPrefs() {
   std::vector<autofill::PasswordForm> forms;
   sql::Statement s(db.GetUniqueStatement(query));
 
-  while (s.Step() && !cancelled()) {
+  while (s.Step() && !import_cancelled()) {
     autofill::PasswordForm form;
     form.origin = GURL(s.ColumnString16(0));
     form.signon_realm = form.origin.GetOrigin().spec();
@@ -128,7 +154,7 @@ void FirefoxImporter::ImportSitePasswordPrefs() {
     forms.push_back(form);
   }
 
-  if (!cancelled()) {
+  if (!import_cancelled()) {
     for (size_t i = 0; i < forms.size(); ++i) {
         bridge_->SetPasswordForm(forms[i]);
     }
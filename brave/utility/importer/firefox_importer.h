@@ -7,8 +7,14 @@
 
 #include "chrome/utility/importer/firefox_importer.h"
 
+#include <stddef.h>
+
 #include <string>
 
+#include "base/synchronization/atomic_flag.h"
+
+class BraveExternalProcessImporterBridge;
+
 namespace brave {
 
 class FirefoxImporter : public ::FirefoxImporter {
@@ -19,14 +25,22 @@ class FirefoxImporter : public ::FirefoxImporter {
   void StartImport(const importer::SourceProfile& source_profile,
                    uint16_t items,
                    ImporterBridge* bridge) override;
+  void Cancel() override;
 
  private:
   ~FirefoxImporter();
 
-  void ImportCookies();
+  // Like cancelled(), but safe to read from the workers items run on.
+  bool import_cancelled() const { return cancel_flag_.IsSet(); }
+
+  // Returns the number of cookies handed to |bridge|. Runs on a worker, so
+  // it gets its own reference to the bridge.
+  size_t ImportCookies(
+      scoped_refptr<BraveExternalProcessImporterBridge> bridge);
   void ImportSitePasswordPrefs();
 
   base::FilePath source_path_;
+  base::AtomicFlag cancel_flag_;
 
   DISALLOW_COPY_AND_ASSIGN(FirefoxImporter);
 };
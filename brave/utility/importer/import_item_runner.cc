@@ -0,0 +1,76 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/utility/importer/import_item_runner.h"
+
+#include <memory>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/task_scheduler/post_task.h"
+#include "base/time/time.h"
+#include "brave/utility/importer/brave_external_process_importer_bridge.h"
+
+namespace brave_importer {
+
+namespace {
+
+// Import items read profile files and must finish for the import to end, so
+// they hold up shutdown of the utility process. They wait in the bridge while
+// the browser is behind.
+constexpr base::TaskTraits kImportItemTaskTraits = {
+    base::MayBlock(), base::WithBaseSyncPrimitives(),
+    base::TaskPriority::USER_VISIBLE,
+    base::TaskShutdownBehavior::BLOCK_SHUTDOWN};
+
+}  // namespace
+
+ImportItemRunner::ImportItemRunner(BraveExternalProcessImporterBridge* bridge)
+    : bridge_(bridge) {
+}
+
+ImportItemRunner::~ImportItemRunner() {
+  Wait();
+}
+
+void ImportItemRunner::Post(importer::ImportItem item,
+                            ItemCallback callback) {
+  pending_.push_back(std::make_unique<base::WaitableEvent>(
+      base::WaitableEvent::ResetPolicy::MANUAL,
+      base::WaitableEvent::InitialState::NOT_SIGNALED));
+  // |pending_| outlives the task, Wait() runs before it is destroyed.
+  base::PostTaskWithTraits(
+      FROM_HERE, kImportItemTaskTraits,
+      base::BindOnce(&ImportItemRunner::RunItem, bridge_, item,
+                     std::move(callback),
+                     base::Unretained(pending_.back().get())));
+}
+
+void ImportItemRunner::Run(importer::ImportItem item, ItemCallback callback) {
+  RunItem(bridge_, item, std::move(callback), nullptr);
+}
+
+void ImportItemRunner::Wait() {
+  for (const auto& done : pending_)
+    done->Wait();
+  pending_.clear();
+}
+
+// static
+void ImportItemRunner::RunItem(
+    scoped_refptr<BraveExternalProcessImporterBridge> bridge,
+    importer::ImportItem item,
+    ItemCallback callback,
+    base::WaitableEvent* done) {
+  bridge->NotifyItemStarted(item);
+  base::TimeTicks start = base::TimeTicks::Now();
+  size_t rows = std::move(callback).Run();
+  bridge->NotifyItemStats(item, rows, base::TimeTicks::Now() - start);
+  bridge->NotifyItemEnded(item);
+  if (done)
+    done->Signal();
+}
+
+}  // namespace brave_importer
@@ -0,0 +1,61 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_UTILITY_IMPORTER_IMPORT_ITEM_RUNNER_H_
+#define BRAVE_UTILITY_IMPORTER_IMPORT_ITEM_RUNNER_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "chrome/common/importer/importer_data_types.h"
+
+namespace base {
+class WaitableEvent;
+}
+
+class BraveExternalProcessImporterBridge;
+
+namespace brave_importer {
+
+// Runs the independent items of an import at the same time, each wrapped in
+// NotifyItemStarted() and NotifyItemEnded() and followed by its row count and
+// duration through NotifyItemStats(). Items run on the task scheduler except
+// those that must stay on the import thread, and Wait() returns once all of
+// them are done. An item returns the number of rows it handed to the bridge.
+class ImportItemRunner {
+ public:
+  using ItemCallback = base::OnceCallback<size_t()>;
+
+  explicit ImportItemRunner(BraveExternalProcessImporterBridge* bridge);
+  ~ImportItemRunner();
+
+  // Runs |callback| on a worker.
+  void Post(importer::ImportItem item, ItemCallback callback);
+
+  // Runs |callback| now, on the calling thread, while posted items go on.
+  void Run(importer::ImportItem item, ItemCallback callback);
+
+  // Blocks until every posted item has finished.
+  void Wait();
+
+ private:
+  static void RunItem(scoped_refptr<BraveExternalProcessImporterBridge> bridge,
+                      importer::ImportItem item,
+                      ItemCallback callback,
+                      base::WaitableEvent* done);
+
+  scoped_refptr<BraveExternalProcessImporterBridge> bridge_;
+  std::vector<std::unique_ptr<base::WaitableEvent>> pending_;
+
+  DISALLOW_COPY_AND_ASSIGN(ImportItemRunner);
+};
+
+}  // namespace brave_importer
+
+#endif  // BRAVE_UTILITY_IMPORTER_IMPORT_ITEM_RUNNER_H_
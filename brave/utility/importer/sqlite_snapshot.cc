@@ -0,0 +1,126 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/utility/importer/sqlite_snapshot.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "sql/connection.h"
+
+namespace brave_importer {
+
+namespace {
+
+// Files SQLite keeps next to a database that are needed to read it
+// consistently. The shared memory index (-shm) is rebuilt from the log.
+const base::FilePath::CharType* const kSidecarSuffixes[] = {
+  FILE_PATH_LITERAL("-wal"),
+  FILE_PATH_LITERAL("-journal"),
+};
+
+// A checkpoint between copying the database and its log would leave a copy
+// that mixes two states, so the copy is retried if either file changed or
+// the copy fails its integrity check.
+const int kMaxCopyAttempts = 3;
+
+struct FileStamp {
+  bool exists;
+  int64_t size;
+  base::Time last_modified;
+
+  bool operator==(const FileStamp& other) const {
+    return exists == other.exists && size == other.size &&
+           last_modified == other.last_modified;
+  }
+};
+
+FileStamp GetFileStamp(const base::FilePath& path) {
+  base::File::Info info;
+  FileStamp stamp;
+  stamp.exists = base::GetFileInfo(path, &info);
+  stamp.size = stamp.exists ? info.size : 0;
+  stamp.last_modified = stamp.exists ? info.last_modified : base::Time();
+  return stamp;
+}
+
+base::FilePath SidecarPath(const base::FilePath& path,
+                           const base::FilePath::CharType* suffix) {
+  return base::FilePath(path.value() + suffix);
+}
+
+// Copies |path| and each of its sidecar files that exists into |dir|. Sets
+// |stable| if none of them changed while being copied.
+bool CopyOnce(const base::FilePath& path,
+              const base::FilePath& dir,
+              bool* stable) {
+  std::vector<base::FilePath> files(1, path);
+  for (const base::FilePath::CharType* suffix : kSidecarSuffixes)
+    files.push_back(SidecarPath(path, suffix));
+
+  std::vector<FileStamp> before;
+  for (const base::FilePath& file : files)
+    before.push_back(GetFileStamp(file));
+  if (!before[0].exists)
+    return false;
+
+  for (size_t i = 0; i < files.size(); ++i) {
+    base::FilePath copy = dir.Append(files[i].BaseName());
+    base::DeleteFile(copy, false);
+    if (before[i].exists && !base::CopyFile(files[i], copy))
+      return false;
+  }
+
+  *stable = true;
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (!(GetFileStamp(files[i]) == before[i]))
+      *stable = false;
+  }
+  return true;
+}
+
+// Size and modification time miss a database rewritten in place, so the
+// copy itself is checked too.
+bool IsIntact(const base::FilePath& copy) {
+  sql::Connection db;
+  std::vector<std::string> messages;
+  return db.Open(copy) && db.FullIntegrityCheck(&messages) &&
+         messages.size() == 1 && messages[0] == "ok";
+}
+
+}  // namespace
+
+SQLiteSnapshot::SQLiteSnapshot() {
+}
+
+SQLiteSnapshot::~SQLiteSnapshot() {
+}
+
+bool SQLiteSnapshot::Create(const base::FilePath& path) {
+  if (!base::PathExists(path) || !temp_dir_.CreateUniqueTempDir())
+    return false;
+
+  base::FilePath copy = temp_dir_.GetPath().Append(path.BaseName());
+  bool intact = false;
+  for (int attempt = 0; attempt < kMaxCopyAttempts; ++attempt) {
+    bool stable = false;
+    if (!CopyOnce(path, temp_dir_.GetPath(), &stable))
+      return false;
+    intact = IsIntact(copy);
+    if (stable && intact)
+      break;
+  }
+  // If the browser kept writing, the last copy is still used when it is
+  // consistent.
+  if (!intact)
+    return false;
+  path_ = copy;
+  return true;
+}
+
+}  // namespace brave_importer
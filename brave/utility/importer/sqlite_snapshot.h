@@ -0,0 +1,39 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_UTILITY_IMPORTER_SQLITE_SNAPSHOT_H_
+#define BRAVE_UTILITY_IMPORTER_SQLITE_SNAPSHOT_H_
+
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/macros.h"
+
+namespace brave_importer {
+
+// A private copy of a SQLite database of another browser, so it can be read
+// while that browser still has the database open and locked. The copy
+// includes the write-ahead log or rollback journal, which SQLite replays when
+// the copy is opened, and is deleted with the snapshot.
+class SQLiteSnapshot {
+ public:
+  SQLiteSnapshot();
+  ~SQLiteSnapshot();
+
+  // Copies the database at |path|. Returns false if it does not exist, could
+  // not be copied, or kept changing until no consistent copy was taken.
+  bool Create(const base::FilePath& path);
+
+  // The copy to open, empty until Create() succeeds.
+  const base::FilePath& path() const { return path_; }
+
+ private:
+  base::ScopedTempDir temp_dir_;
+  base::FilePath path_;
+
+  DISALLOW_COPY_AND_ASSIGN(SQLiteSnapshot);
+};
+
+}  // namespace brave_importer
+
+#endif  // BRAVE_UTILITY_IMPORTER_SQLITE_SNAPSHOT_H_
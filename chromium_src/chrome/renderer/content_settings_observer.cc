@@ -48,6 +48,23 @@ using blink::WebView;
 using content::DocumentState;
 using content::NavigationState;
 
+namespace {
+
+// Number of recent decisions kept per frame.
+const size_t kRecentSettingsCacheSize = 32;
+
+// Content settings patterns only look at the scheme, host and port of
+// non-file URLs, so decisions for those can be shared across the origin.
+std::string GetSettingCacheKey(const GURL& url) {
+  if (url.SchemeIsFile() || url.SchemeIsFileSystem() || url.SchemeIsBlob())
+    return url.spec();
+  if (!url.IsStandard())
+    return url.scheme() + ":";
+  return url.GetOrigin().spec();
+}
+
+}  // namespace
+
 ContentSettingsObserver::ContentSettingsObserver(
     content::RenderFrame* render_frame,
     extensions::Dispatcher* extension_dispatcher,
@@ -61,6 +78,8 @@ ContentSettingsObserver::ContentSettingsObserver(
 #endif
       content_settings_manager_(NULL),
       allow_running_insecure_content_(false),
+      recent_settings_(kRecentSettingsCacheSize),
+      recent_settings_generation_(0),
       is_interstitial_page_(false),
       current_request_id_(0),
       should_whitelist_(should_whitelist) {
@@ -246,7 +265,7 @@ bool ContentSettingsObserver::AllowDatabase(const WebString& name,
       blink::WebStringToGURL(frame->GetSecurityOrigin().ToString()));
   if (content_settings_manager_->content_settings()) {
     allow =
-        content_settings_manager_->GetSetting(
+        GetContentSetting(
           ContentSettingsManager::GetOriginOrURL(frame),
           secondary_url,
           "cookies",
@@ -274,7 +293,7 @@ void ContentSettingsObserver::RequestFileSystemAccessAsync(
       blink::WebStringToGURL(frame->GetSecurityOrigin().ToString()));
   if (content_settings_manager_->content_settings()) {
     allow =
-        content_settings_manager_->GetSetting(
+        GetContentSetting(
           ContentSettingsManager::GetOriginOrURL(frame),
           secondary_url,
           "cookies",
@@ -297,7 +316,7 @@ bool ContentSettingsObserver::AllowImage(bool enabled_per_settings,
   GURL secondary_url(image_url);
   if (content_settings_manager_->content_settings()) {
     allow =
-        content_settings_manager_->GetSetting(
+        GetContentSetting(
             ContentSettingsManager::GetOriginOrURL(
                 render_frame()->GetWebFrame()),
             secondary_url,
@@ -322,7 +341,7 @@ bool ContentSettingsObserver::AllowIndexedDB(const WebString& name,
       blink::WebStringToGURL(frame->GetSecurityOrigin().ToString()));
   if (content_settings_manager_->content_settings()) {
     allow =
-        content_settings_manager_->GetSetting(
+        GetContentSetting(
             ContentSettingsManager::GetOriginOrURL(frame),
             secondary_url,
             "cookies",
@@ -415,7 +434,7 @@ bool ContentSettingsObserver::AllowScriptFromSource(
   GURL secondary_url(script_url);
   if (content_settings_manager_->content_settings()) {
     allow =
-        content_settings_manager_->GetSetting(
+        GetContentSetting(
           ContentSettingsManager::GetOriginOrURL(render_frame()->GetWebFrame()),
           secondary_url,
           "javascript",
@@ -448,7 +467,7 @@ bool ContentSettingsObserver::AllowStorage(bool local) {
   bool allow = true;
   if (content_settings_manager_->content_settings()) {
     allow =
-        content_settings_manager_->GetSetting(
+        GetContentSetting(
           ContentSettingsManager::GetOriginOrURL(frame),
           blink::WebStringToGURL(frame->GetSecurityOrigin().ToString()),
           "cookies",
@@ -501,7 +520,7 @@ bool ContentSettingsObserver::AllowMutationEvents(bool default_value) {
   bool allow = default_value;
   if (content_settings_manager_->content_settings()) {
     allow =
-        content_settings_manager_->GetSetting(
+        GetContentSetting(
             ContentSettingsManager::GetOriginOrURL(
                 render_frame()->GetWebFrame()),
             GURL(),
@@ -523,7 +542,7 @@ bool ContentSettingsObserver::AllowRunningInsecureContent(
   GURL secondary_url(resource_url);
   if (content_settings_manager_->content_settings()) {
     allow =
-        content_settings_manager_->GetSetting(
+        GetContentSetting(
             ContentSettingsManager::GetOriginOrURL(
                 render_frame()->GetWebFrame()),
             secondary_url,
@@ -544,7 +563,7 @@ bool ContentSettingsObserver::AllowAutoplay(bool default_value) {
     WebFrame* frame = render_frame()->GetWebFrame();
     auto origin = frame->ToWebLocalFrame()->GetDocument().GetSecurityOrigin();
     allow =
-        content_settings_manager_->GetSetting(
+        GetContentSetting(
             ContentSettingsManager::GetOriginOrURL(frame),
             blink::WebStringToGURL(origin.ToString()),
             "autoplay",
@@ -592,6 +611,32 @@ void ContentSettingsObserver::ClearBlockedContentSettings() {
   cached_script_permissions_.clear();
 }
 
+ContentSetting ContentSettingsObserver::GetContentSetting(
+    const GURL& primary_url,
+    const GURL& secondary_url,
+    const std::string& content_type,
+    bool default_value) {
+  if (recent_settings_generation_ != content_settings_manager_->generation()) {
+    recent_settings_.Clear();
+    recent_settings_generation_ = content_settings_manager_->generation();
+  }
+
+  std::string key = content_type;
+  key += default_value ? "\n1\n" : "\n0\n";
+  key += GetSettingCacheKey(primary_url);
+  key += '\n';
+  key += GetSettingCacheKey(secondary_url);
+
+  auto it = recent_settings_.Get(key);
+  if (it != recent_settings_.end())
+    return it->second;
+
+  ContentSetting setting = content_settings_manager_->GetSetting(
+      primary_url, secondary_url, content_type, default_value);
+  recent_settings_.Put(key, setting);
+  return setting;
+}
+
 bool ContentSettingsObserver::IsWhitelistedForContentSettings() const {
   // Whitelist ftp directory listings, as they require JavaScript to function
   // properly.
@@ -7,7 +7,9 @@
 
 #include <map>
 #include <set>
+#include <string>
 
+#include "base/containers/mru_cache.h"
 #include "components/content_settings/core/common/content_settings.h"
 #include "components/content_settings/core/common/content_settings_types.h"
 #include "content/public/renderer/render_frame_observer.h"
@@ -110,6 +112,12 @@ class ContentSettingsObserver
   void OnLoadBlockedPlugins(const std::string& identifier);
 
   // Helpers.
+  // Asks |content_settings_manager_|, going through |recent_settings_|.
+  ContentSetting GetContentSetting(const GURL& primary_url,
+                                   const GURL& secondary_url,
+                                   const std::string& content_type,
+                                   bool default_value);
+
   // True if |render_frame()| contains content that is white-listed for content
   // settings.
   bool IsWhitelistedForContentSettings() const;
@@ -140,6 +148,11 @@ class ContentSettingsObserver
   // Caches the result of AllowScript.
   std::map<blink::WebFrame*, bool> cached_script_permissions_;
 
+  // Caches recent results of GetContentSetting. Valid as long as the
+  // generation of |content_settings_manager_| doesn't change.
+  base::MRUCache<std::string, ContentSetting> recent_settings_;
+  uint64_t recent_settings_generation_;
+
   std::set<std::string> temporarily_allowed_plugins_;
   bool is_interstitial_page_;
 
@@ -71,9 +71,17 @@ Worker.prototype.start = function (cb) {
   this.id = app._startWorker(this.module_name)
 }
 
-Worker.prototype.postMessage = function (message) {
+// The ArrayBuffers in |transferList| are moved to the worker, not copied.
+Worker.prototype.postMessage = function (message, transferList) {
   const evt = {data: message}
-  app._postMessage(this.id, evt)
+  app._postMessage(this.id, evt, transferList)
+}
+
+// Hands one end of a channel from app.createMessageChannel() to the worker,
+// which receives it as event.ports[0] of its onconnect handler. Returns false,
+// closing the port, if the worker is not running.
+Worker.prototype.connect = function (port) {
+  return app._connectWorkerPort(this.id, port)
 }
 
 Worker.prototype.terminate = function () {
@@ -125,6 +133,149 @@ app.createWorker = function (module_name) {
   return worker
 }
 
+// A fixed set of workers running |module_name|, kept warm across jobs. Each
+// job is one message posted to an idle worker, and the next message that
+// worker posts back is the result of the job.
+function WorkerPool (module_name, size) {
+  this.module_name = module_name
+  this.size = size
+  this.workers = new Map()
+  this.idle = []
+  this.pending = []
+  this.starting = 0
+  this.terminated = false
+  this.listeners = {
+    'worker-start': (e, worker_id) => this._onStart(worker_id),
+    'worker-stop': (e, worker_id) => this._onStop(worker_id),
+    'worker-post-message': (e, worker_id, message) => {
+      this._onMessage(worker_id, message)
+    },
+    'worker-onerror': (e, worker_id, message, stack) => {
+      this._onError(worker_id, message, stack)
+    }
+  }
+  Object.keys(this.listeners).forEach((name) => {
+    app.on(name, this.listeners[name])
+  })
+}
+
+WorkerPool.prototype.run = function (message, transferList, callback) {
+  if (typeof transferList === 'function') {
+    callback = transferList
+    transferList = undefined
+  }
+  if (this.terminated) {
+    callback && callback(new Error('The worker pool has been terminated'))
+    return
+  }
+  this.pending.push({message, transferList, callback})
+  this._dispatch()
+}
+
+WorkerPool.prototype.terminate = function () {
+  if (this.terminated) return
+  this.terminated = true
+  Object.keys(this.listeners).forEach((name) => {
+    app.removeListener(name, this.listeners[name])
+  })
+
+  const error = new Error('The worker pool has been terminated')
+  const jobs = this.pending
+  for (const worker of this.workers.values()) {
+    app.stopWorker(worker.id)
+    worker.job && jobs.push(worker.job)
+  }
+  this.workers.clear()
+  this.idle = []
+  this.pending = []
+  jobs.forEach((job) => job.callback && job.callback(error))
+}
+
+WorkerPool.prototype._dispatch = function () {
+  while (this.pending.length > 0 && this.idle.length > 0) {
+    const worker = this.workers.get(this.idle.shift())
+    const job = this.pending.shift()
+    try {
+      app._postMessage(worker.id, {data: job.message}, job.transferList)
+      worker.job = job
+    } catch (error) {
+      this.idle.push(worker.id)
+      job.callback && job.callback(error)
+    }
+  }
+
+  // Start workers for the jobs nobody is going to pick up.
+  while (this.pending.length > this.starting &&
+         this.workers.size < this.size) {
+    const worker_id = app._startWorker(this.module_name,
+                                       this.module_name + '_pool_worker')
+    if (worker_id === -1) break
+    this.workers.set(worker_id, {id: worker_id, job: null, started: false})
+    this.starting++
+  }
+}
+
+WorkerPool.prototype._onStart = function (worker_id) {
+  const worker = this.workers.get(worker_id)
+  if (!worker || worker.started) return
+  worker.started = true
+  this.starting--
+  if (!worker.error) {
+    this.idle.push(worker_id)
+    this._dispatch()
+  }
+}
+
+WorkerPool.prototype._onStop = function (worker_id) {
+  const worker = this.workers.get(worker_id)
+  if (!worker) return
+  this.workers.delete(worker_id)
+  this.idle = this.idle.filter((id) => id !== worker_id)
+  if (!worker.started) this.starting--
+  worker.job && worker.job.callback &&
+    worker.job.callback(new Error(worker.error || 'The worker stopped'))
+
+  if (worker.error && !worker.job) {
+    // The module failed to load, another worker would fail the same way.
+    const jobs = this.pending
+    this.pending = []
+    jobs.forEach((job) => job.callback && job.callback(new Error(worker.error)))
+  } else {
+    this._dispatch()
+  }
+}
+
+WorkerPool.prototype._onMessage = function (worker_id, message) {
+  const worker = this.workers.get(worker_id)
+  if (!worker || !worker.job) return
+  const job = worker.job
+  worker.job = null
+  this.idle.push(worker_id)
+  job.callback && job.callback(null, message)
+  this._dispatch()
+}
+
+WorkerPool.prototype._onError = function (worker_id, message, stack) {
+  const worker = this.workers.get(worker_id)
+  if (!worker) return
+  if (!worker.job) {
+    worker.error = message
+    return
+  }
+  const job = worker.job
+  worker.job = null
+  this.idle.push(worker_id)
+  const error = new Error(message)
+  if (stack) error.stack = stack
+  job.callback && job.callback(error)
+  this._dispatch()
+}
+
+app.createWorkerPool = function (module_name, options = {}) {
+  const size = options.size || require('os').cpus().length
+  return new WorkerPool(module_name, size)
+}
+
 app.allowNTLMCredentialsForAllDomains = function (allow) {
   if (!process.noDeprecations) {
     deprecate.warn('app.allowNTLMCredentialsForAllDomains', 'session.allowNTLMCredentialsForDomains')
@@ -97,10 +97,20 @@ WebContents.prototype.sendShared = function (channel, shared) {
   if (shared == null) throw new Error('Missing required `shared` argument')
   return this._sendShared(channel, shared)
 }
+// Returns false without sending anything when the renderer has not caught up
+// with the previous messages yet.
+WebContents.prototype.sendRing = function (channel, value) {
+  if (channel == null) throw new Error('Missing required `channel` argument')
+  return this._sendRing(channel, value)
+}
 WebContents.prototype.send = function (channel, ...args) {
   if (channel == null) throw new Error('Missing required `channel` argument')
   return this._send(channel, args)
 }
+WebContents.prototype.sendCloned = function (channel, ...args) {
+  if (channel == null) throw new Error('Missing required `channel` argument')
+  return this._sendCloned(channel, args)
+}
 
 WebContents.prototype.clone = function(...args) {
   if (args.length === 0) {
@@ -280,5 +290,17 @@ module.exports = {
 
   getAllWebContents () {
     return binding.getAllWebContents()
+  },
+
+  getIPCSenderStats () {
+    return binding.getIPCSenderStats()
+  },
+
+  setTabDiscardPolicy (options) {
+    binding.setTabDiscardPolicy(options)
+  },
+
+  getTabDiscardStats () {
+    return binding.getTabDiscardStats()
   }
 }
@@ -334,4 +334,162 @@ describe('app module', function () {
       assert.equal(typeof app.isAccessibilitySupportEnabled(), 'boolean')
     })
   })
+
+  describe('app.createMessageChannel()', function () {
+    var w = null
+
+    afterEach(function () {
+      ipcMain.removeAllListeners('port-ready')
+      ipcMain.removeAllListeners('port-message')
+      return closeWindow(w).then(function () { w = null })
+    })
+
+    it('returns two distinct ports', function () {
+      const channel = app.createMessageChannel()
+      assert.equal(typeof channel.port1, 'number')
+      assert.equal(typeof channel.port2, 'number')
+      assert.notEqual(channel.port1, channel.port2)
+    })
+
+    it('delivers messages between the ends of a channel', function (done) {
+      w = new BrowserWindow({
+        show: false
+      })
+      ipcMain.once('port-ready', function () {
+        const channel = app.createMessageChannel()
+        w.webContents.connectMessagePort(channel.port1)
+        w.webContents.connectMessagePort(channel.port2)
+      })
+      ipcMain.once('port-message', function (event, data) {
+        assert.equal(data, 'ping')
+        done()
+      })
+      w.loadURL('file://' + path.join(__dirname, 'fixtures', 'pages', 'message-port.html'))
+    })
+  })
+
+  describe('message ports between a worker and a frame', function () {
+    let w = null
+    let worker = null
+
+    afterEach(function () {
+      ipcMain.removeAllListeners('port-ready')
+      ipcMain.removeAllListeners('port-message')
+      if (worker) {
+        worker.onmessage = null
+        worker.terminate()
+        worker = null
+      }
+      return closeWindow(w).then(function () { w = null })
+    })
+
+    it('delivers messages both ways and closes the worker end on reload', function (done) {
+      w = new BrowserWindow({
+        show: false
+      })
+      worker = app.createWorker('fixtures/workers/port_echo')
+      worker.onerror = function (message) {
+        done(new Error(message))
+      }
+      worker.onmessage = function (event) {
+        assert.equal(event.data, 'port-closed')
+        done()
+      }
+      ipcMain.once('port-ready', function () {
+        const channel = app.createMessageChannel()
+        assert.equal(worker.connect(channel.port1), true)
+        w.webContents.connectMessagePort(channel.port2)
+      })
+      ipcMain.once('port-message', function (event, data) {
+        // The frame posted it to the worker, which echoed it back.
+        assert.deepEqual(data, {greeting: 'ping'})
+        w.webContents.reload()
+      })
+      worker.start(function () {
+        w.loadURL('file://' + path.join(__dirname, 'fixtures', 'pages', 'worker-port.html'))
+      })
+    })
+  })
+
+  describe('app.createWorkerPool(moduleName, options)', function () {
+    let pool = null
+
+    afterEach(function () {
+      if (pool) {
+        pool.terminate()
+        pool = null
+      }
+    })
+
+    it('spreads tasks across its workers', function (done) {
+      this.timeout(10000)
+      pool = app.createWorkerPool('fixtures/workers/pool_task', {size: 2})
+      const workerIds = new Set()
+      let remaining = 4
+      for (let i = 0; i < 4; i++) {
+        pool.run({value: i, delay: 200}, function (error, result) {
+          if (error) return done(error)
+          assert.equal(result.value, i)
+          workerIds.add(result.workerId)
+          if (--remaining === 0) {
+            assert.equal(workerIds.size, 2)
+            done()
+          }
+        })
+      }
+    })
+
+    it('passes task errors to the callback and keeps the worker', function (done) {
+      pool = app.createWorkerPool('fixtures/workers/pool_task', {size: 1})
+      pool.run({fail: 'task failed'}, function (error) {
+        assert.ok(error)
+        assert.equal(error.message, 'task failed')
+        pool.run({value: 'next'}, function (error, result) {
+          if (error) return done(error)
+          assert.equal(result.value, 'next')
+          done()
+        })
+      })
+    })
+
+    it('fails pending tasks when terminated', function (done) {
+      pool = app.createWorkerPool('fixtures/workers/pool_task', {size: 1})
+      let remaining = 3
+      for (let i = 0; i < 3; i++) {
+        pool.run({value: i, delay: 500}, function (error) {
+          assert.ok(error)
+          assert.ok(/terminated/.test(error.message))
+          if (--remaining === 0) done()
+        })
+      }
+      pool.terminate()
+      pool.run({value: 'late'}, function (error) {
+        assert.ok(/terminated/.test(error.message))
+      })
+    })
+  })
+
+  describe('worker.postMessage(message, transferList)', function () {
+    it('detaches the transferred ArrayBuffers of the sender', function (done) {
+      const transfer = remote.require(path.join(__dirname, 'fixtures', 'module', 'worker-transfer.js'))
+      transfer(function (sentByteLength, receivedByteLength) {
+        assert.equal(sentByteLength, 0)
+        assert.equal(receivedByteLength, 16)
+        done()
+      })
+    })
+  })
+
+  describe('worker.connect(port)', function () {
+    it('returns false once the worker has stopped', function (done) {
+      const worker = app.createWorker('spec-worker-without-source')
+      worker.onerror = function () {}
+      worker.once('stop', function () {
+        const channel = app.createMessageChannel()
+        assert.equal(worker.connect(channel.port1), false)
+        done()
+      })
+      worker.start()
+    })
+  })
 })
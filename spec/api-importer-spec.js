@@ -0,0 +1,46 @@
+const assert = require('assert')
+const path = require('path')
+
+const {remote} = require('electron')
+const {importer} = remote.require('electron')
+
+describe('importer module', function () {
+  this.timeout(20000)
+
+  const fixtures = path.resolve(__dirname, 'fixtures')
+
+  afterEach(function () {
+    importer.setStreamingOptions({})
+    importer.removeAllListeners('add-bookmarks')
+    importer.removeAllListeners('import-success')
+    importer.removeAllListeners('import-dismiss')
+  })
+
+  describe('importer.setStreamingOptions({chunkSize, maxPendingChunks})', function () {
+    it('waits for chunkProcessed before emitting the next chunk', function (done) {
+      let unacked = 0
+      let bookmarks = 0
+      importer.on('add-bookmarks', function (event, chunk) {
+        unacked++
+        bookmarks += chunk.length
+        assert.equal(chunk.length, 1)
+        assert.equal(unacked, 1)
+        setTimeout(function () {
+          unacked--
+          importer.chunkProcessed()
+        }, 50)
+      })
+      importer.once('import-success', function () {
+        assert.equal(bookmarks, 3)
+        done()
+      })
+      importer.once('import-dismiss', function () {
+        done(new Error('import was dismissed'))
+      })
+
+      importer.initialize()
+      importer.setStreamingOptions({chunkSize: 1, maxPendingChunks: 1})
+      importer.importHTML(path.join(fixtures, 'importer', 'bookmarks.html'))
+    })
+  })
+})
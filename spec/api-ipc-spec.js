@@ -423,6 +423,103 @@ describe('ipc module', function () {
     })
   })
 
+  describe('ipcRenderer.sendCloned', function () {
+    afterEach(function () {
+      ipcRenderer.removeAllListeners('cloned-message-result')
+    })
+
+    it('keeps typed arrays, Maps and Dates intact', function (done) {
+      ipcRenderer.once('cloned-message-result', function (event, result) {
+        assert.deepEqual(result, {
+          bytes: [1, 2, 3],
+          map: [['a', 1], ['b', {c: 2}]],
+          date: 1500000000000,
+          nestedBytes: [4, 5],
+          nestedDate: 0,
+          name: 'outer'
+        })
+        done()
+      })
+      ipcRenderer.sendCloned('cloned-message',
+        new Uint8Array([1, 2, 3]),
+        new Map([['a', 1], ['b', {c: 2}]]),
+        new Date(1500000000000),
+        {name: 'outer', nested: {bytes: new Uint8Array([4, 5]), date: new Date(0)}})
+    })
+
+    it('throws for values that can not be cloned', function () {
+      assert.throws(function () {
+        ipcRenderer.sendCloned('cloned-message', function () {})
+      })
+    })
+  })
+
+  describe('webContents.sendCloned', function () {
+    afterEach(function () {
+      ipcRenderer.removeAllListeners('cloned-reply')
+    })
+
+    it('keeps typed arrays, Maps and Dates intact', function (done) {
+      ipcRenderer.once('cloned-reply', function (event, bytes, map, date, object) {
+        assert.ok(bytes instanceof Uint8Array)
+        assert.deepEqual(Array.from(bytes), [1, 2, 3])
+
+        assert.ok(map instanceof Map)
+        assert.equal(map.size, 2)
+        assert.equal(map.get('a'), 1)
+        assert.deepEqual(map.get('b'), {c: 2})
+
+        assert.ok(date instanceof Date)
+        assert.equal(date.getTime(), 1500000000000)
+
+        assert.equal(object.name, 'outer')
+        assert.ok(object.nested.bytes instanceof Uint8Array)
+        assert.deepEqual(Array.from(object.nested.bytes), [4, 5])
+        assert.ok(object.nested.date instanceof Date)
+        assert.equal(object.nested.date.getTime(), 0)
+        done()
+      })
+      ipcRenderer.send('send-cloned')
+    })
+  })
+
+  describe('event.sender', function () {
+    it('is cached per frame until the frame is deleted', function (done) {
+      this.timeout(10000)
+      const senders = remote.require(path.join(fixtures, 'module', 'ipc-sender.js'))
+      const first = senders.count()
+      const before = webContents.getIPCSenderStats()
+
+      w = new BrowserWindow({
+        show: false
+      })
+      senders.waitFor(first + 2, function () {
+        // Both messages of the page got the same wrapper.
+        assert.equal(senders.isSameSender(first, first + 1), true)
+        const loaded = webContents.getIPCSenderStats()
+        assert.equal(loaded.created, before.created + 1)
+        assert.ok(loaded.reused >= before.reused + 1)
+        assert.equal(loaded.cached, before.cached + 1)
+
+        w.webContents.once('crashed', function () {
+          senders.waitFor(first + 4, function () {
+            assert.equal(senders.isSameSender(first, first + 2), false)
+            assert.equal(senders.isSameSender(first + 2, first + 3), true)
+            const reloaded = webContents.getIPCSenderStats()
+            assert.equal(reloaded.created, loaded.created + 1)
+            // RenderFrameDeleted dropped the wrapper of the crashed frame, so
+            // only the reloaded one is cached.
+            assert.equal(reloaded.cached, before.cached + 1)
+            done()
+          })
+          w.webContents.reload()
+        })
+        w.webContents.send('crash')
+      })
+      w.loadURL('file://' + path.join(fixtures, 'pages', 'sender-ping.html'))
+    })
+  })
+
   describe('ipc.sendSync', function () {
     afterEach(function () {
       ipcMain.removeAllListeners('send-sync-message')
@@ -485,6 +582,33 @@ describe('ipc module', function () {
     })
   })
 
+  describe('ipcRenderer.sendRing', function () {
+    afterEach(function () {
+      ipcMain.removeAllListeners('ring-ready')
+      ipcMain.removeAllListeners('ring-pong')
+    })
+
+    it('round-trips messages across navigations', function (done) {
+      w = new BrowserWindow({
+        show: false
+      })
+      let loads = 0
+      ipcMain.on('ring-ready', function () {
+        loads++
+        assert.equal(w.webContents.sendRing('ring-ping', 'ping ' + loads), true)
+      })
+      ipcMain.on('ring-pong', function (event, value) {
+        assert.equal(value, 'ping ' + loads)
+        if (loads < 3) {
+          w.webContents.reload()
+        } else {
+          done()
+        }
+      })
+      w.loadURL('file://' + path.join(fixtures, 'pages', 'ring-echo.html'))
+    })
+  })
+
   describe('remote listeners', function () {
     it('can be added and removed correctly', function () {
       w = new BrowserWindow({
@@ -59,4 +59,82 @@ describe('nativeImage module', () => {
       assert.equal(image.getSize().width, 256)
     })
   })
+
+  describe('encoding', () => {
+    const logoPath = path.join(__dirname, 'fixtures', 'assets', 'logo.png')
+
+    it('round trips through toDataURL', () => {
+      const image = nativeImage.createFromPath(logoPath)
+      const dataURL = image.toDataURL()
+      assert(dataURL.startsWith('data:image/png;base64,'))
+      const decoded = nativeImage.createFromDataURL(dataURL)
+      assert.deepEqual(decoded.getSize(), image.getSize())
+      assert.equal(decoded.toDataURL(), dataURL)
+      assert(decoded.toPNG().equals(image.toPNG()))
+    })
+
+    it('returns empty buffers for empty images', () => {
+      const image = nativeImage.createEmpty()
+      assert.equal(image.toPNG().length, 0)
+      assert.equal(image.toJPEG(90).length, 0)
+      assert.equal(image.toDataURL(), 'data:image/png;base64,')
+    })
+  })
+
+  describe('async methods', () => {
+    const logoPath = path.join(__dirname, 'fixtures', 'assets', 'logo.png')
+
+    it('createFromPathAsync loads images', (done) => {
+      nativeImage.createFromPathAsync(logoPath, (image) => {
+        assert.deepEqual(image.getSize(), {width: 538, height: 190})
+        done()
+      })
+    })
+
+    it('createFromPathAsync returns an empty image for invalid paths', (done) => {
+      nativeImage.createFromPathAsync('does-not-exist.png', (image) => {
+        assert(image.isEmpty())
+        done()
+      })
+    })
+
+    it('round trips through toPNGAsync and createFromBufferAsync', (done) => {
+      const image = nativeImage.createFromPath(logoPath)
+      image.toPNGAsync((buffer) => {
+        assert(buffer.equals(image.toPNG()))
+        nativeImage.createFromBufferAsync(buffer, (decoded) => {
+          assert.deepEqual(decoded.getSize(), image.getSize())
+          done()
+        })
+      })
+    })
+
+    it('toDataURLAsync matches toDataURL', (done) => {
+      const image = nativeImage.createFromPath(logoPath)
+      image.toDataURLAsync((dataURL) => {
+        assert.equal(dataURL, image.toDataURL())
+        done()
+      })
+    })
+
+    it('resizeAsync keeps the aspect ratio', (done) => {
+      const image = nativeImage.createFromPath(logoPath)
+      image.resizeAsync({width: 269}, (resized) => {
+        assert.deepEqual(resized.getSize(), {width: 269, height: 95})
+        done()
+      })
+    })
+
+    it('resizeBatch resizes every image to every size', (done) => {
+      const image = nativeImage.createFromPath(logoPath)
+      nativeImage.resizeBatch([image, image], [{width: 100, height: 50}, {height: 19}], (results) => {
+        assert.equal(results.length, 2)
+        for (const row of results) {
+          assert.deepEqual(row[0].getSize(), {width: 100, height: 50})
+          assert.deepEqual(row[1].getSize(), {width: 53, height: 19})
+        }
+        done()
+      })
+    })
+  })
 })
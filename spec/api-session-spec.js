@@ -2,6 +2,7 @@ const assert = require('assert')
 const http = require('http')
 const path = require('path')
 const fs = require('fs')
+const os = require('os')
 const {closeWindow} = require('./window-helpers')
 
 const {ipcRenderer, remote} = require('electron')
@@ -125,6 +126,99 @@ describe('session module', function () {
       })
     })
 
+    it('should query cookies in chunks', function (done) {
+      const names = ['q1', 'q2', 'q3']
+      let pending = names.length
+      names.forEach(function (name) {
+        session.defaultSession.cookies.set({
+          url: url,
+          name: name,
+          value: name
+        }, function (error) {
+          if (error) return done(error)
+          if (--pending > 0) return
+          const found = []
+          session.defaultSession.cookies.query({
+            url: url
+          }, {chunkSize: 1}, function (error, chunk, last) {
+            if (error) return done(error)
+            assert(chunk.length <= 1)
+            chunk.forEach(function (cookie) {
+              if (names.includes(cookie.name)) found.push(cookie.name)
+            })
+            if (last) {
+              assert.deepEqual(found.sort(), names)
+              done()
+            }
+          })
+        })
+      })
+    })
+
+    it('should filter by domain when querying', function (done) {
+      session.defaultSession.cookies.query({
+        domain: '127.0.0.1'
+      }, function (error, chunk, last) {
+        if (error) return done(error)
+        chunk.forEach(function (cookie) {
+          assert.equal(cookie.domain.replace(/^\./, ''), '127.0.0.1')
+        })
+        if (last) done()
+      })
+    })
+
+    it('should set and remove cookies in batches', function (done) {
+      const cookies = [
+        {url: url, name: 'b1', value: 'b1'},
+        {url: '', name: 'b2', value: 'b2'},
+        {url: url, name: 'b3', value: 'b3'}
+      ]
+      session.defaultSession.cookies.setBatch(cookies, function (error, failed) {
+        assert.equal(error.message, 'Setting cookie failed')
+        assert.deepEqual(failed, [1])
+        session.defaultSession.cookies.get({url: url}, function (error, list) {
+          if (error) return done(error)
+          const names = list.map((cookie) => cookie.name)
+          assert(names.includes('b1'))
+          assert(names.includes('b3'))
+          session.defaultSession.cookies.removeBatch([
+            {url: url, name: 'b1'},
+            {url: url, name: 'b3'}
+          ], function (error, failed) {
+            if (error) return done(error)
+            assert.deepEqual(failed, [])
+            session.defaultSession.cookies.get({url: url}, function (error, list) {
+              if (error) return done(error)
+              const names = list.map((cookie) => cookie.name)
+              assert(!names.includes('b1'))
+              assert(!names.includes('b3'))
+              done()
+            })
+          })
+        })
+      })
+    })
+
+    it('should export cookies', function (done) {
+      const exportPath = path.join(os.tmpdir(), 'cookies-export-' + Date.now() + '.txt')
+      session.defaultSession.cookies.set({
+        url: url,
+        name: 'e1',
+        value: 'e1'
+      }, function (error) {
+        if (error) return done(error)
+        session.defaultSession.cookies.exportAll(exportPath, function (error, count) {
+          if (error) return done(error)
+          const lines = fs.readFileSync(exportPath, 'utf8').split('\n')
+          fs.unlinkSync(exportPath)
+          assert.equal(lines[0], '# Netscape HTTP Cookie File')
+          assert(count >= 1)
+          assert(lines.some((line) => line.endsWith('\te1\te1')))
+          done()
+        })
+      })
+    })
+
     it('should remove cookies', function (done) {
       session.defaultSession.cookies.set({
         url: url,
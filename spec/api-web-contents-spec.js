@@ -5,7 +5,7 @@ const path = require('path')
 const {closeWindow} = require('./window-helpers')
 
 const {remote} = require('electron')
-const {BrowserWindow, webContents} = remote
+const {BrowserWindow, session, webContents} = remote
 
 const isCi = remote.getGlobal('isCi')
 
@@ -48,6 +48,97 @@ describe('webContents module', function () {
     })
   })
 
+  describe('getTabDiscardStats() API', function () {
+    let tab = null
+
+    afterEach(function () {
+      webContents.setTabDiscardPolicy({
+        memoryBudget: 0,
+        checkInterval: 60000,
+        minInactiveTime: 600000
+      })
+      if (tab) {
+        tab.destroy()
+        tab = null
+      }
+    })
+
+    const createBackgroundTab = function (callback) {
+      const url = 'file://' + path.join(fixtures, 'pages', 'a.html')
+      webContents.createTab(w.webContents, session.defaultSession, {url, active: false}, function (contents) {
+        tab = contents
+        tab.once('did-finish-load', function () {
+          callback(tab)
+        })
+      })
+    }
+
+    // Any renderer uses more than a byte, so the budget discards every
+    // background tab.
+    const overBudget = {memoryBudget: 1, checkInterval: 100, minInactiveTime: 0}
+
+    it('reports what the discard policy did', function () {
+      const stats = webContents.getTabDiscardStats()
+      assert.equal(typeof stats.runs, 'number')
+      assert.equal(typeof stats.tabsDiscarded, 'number')
+      assert.equal(typeof stats.tabsVetoed, 'number')
+      assert.equal(typeof stats.bytesReclaimed, 'number')
+    })
+
+    it('accepts a partial policy', function () {
+      assert.doesNotThrow(function () {
+        webContents.setTabDiscardPolicy({memoryBudget: 512 * 1024 * 1024})
+        webContents.setTabDiscardPolicy({enabled: true})
+      })
+    })
+
+    it('rejects negative numbers', function () {
+      assert.throws(function () {
+        webContents.setTabDiscardPolicy({checkInterval: -1})
+      }, /checkInterval/)
+      assert.throws(function () {
+        webContents.setTabDiscardPolicy({minInactiveTime: -1})
+      }, /minInactiveTime/)
+      assert.throws(function () {
+        webContents.setTabDiscardPolicy({memoryBudget: -1})
+      }, /memoryBudget/)
+    })
+
+    it('discards a background tab over the memory budget', function (done) {
+      createBackgroundTab(function (tab) {
+        const before = webContents.getTabDiscardStats()
+        tab.once('discarded', function () {
+          const after = webContents.getTabDiscardStats()
+          assert.ok(after.tabsDiscarded > before.tabsDiscarded)
+          assert.ok(after.bytesReclaimed > before.bytesReclaimed)
+          done()
+        })
+        webContents.setTabDiscardPolicy(overBudget)
+      })
+    })
+
+    it('keeps a tab whose will-discard listener prevents it', function (done) {
+      createBackgroundTab(function (tab) {
+        const before = webContents.getTabDiscardStats()
+        tab.on('will-discard', function (event) {
+          event.preventDefault()
+        })
+        tab.once('discarded', function () {
+          done(new Error('the tab was discarded'))
+        })
+        tab.once('discard-aborted', function () {
+          webContents.setTabDiscardPolicy({memoryBudget: 0})
+          const after = webContents.getTabDiscardStats()
+          assert.ok(after.tabsVetoed > before.tabsVetoed)
+          assert.equal(after.tabsDiscarded, before.tabsDiscarded)
+          tab.removeAllListeners('discarded')
+          done()
+        })
+        webContents.setTabDiscardPolicy(overBudget)
+      })
+    })
+  })
+
   describe('getFocusedWebContents() API', function () {
     it('returns the focused web contents', function (done) {
       if (isCi) return done()
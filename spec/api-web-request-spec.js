@@ -11,6 +11,9 @@ describe('webRequest module', function () {
       res.statusCode = 301
       res.setHeader('Location', 'http://' + req.rawHeaders[1])
       res.end()
+    } else if (req.url === '/tab-with-frame') {
+      res.setHeader('Content-Type', 'text/html')
+      res.end('<iframe src="/tab-frame"></iframe>')
     } else {
       res.setHeader('Custom', ['Header'])
       var content = req.url
@@ -85,6 +88,29 @@ describe('webRequest module', function () {
       })
     })
 
+    it('reports the tabId of a tab and of its iframes', function (done) {
+      const webview = new WebView()
+      const tabIds = {}
+      ses.webRequest.onBeforeRequest(function (details, callback) {
+        if (details.url === defaultURL + 'tab-with-frame') {
+          tabIds.mainFrame = details.tabId
+        } else if (details.url === defaultURL + 'tab-frame') {
+          tabIds.subFrame = details.tabId
+        }
+        callback({})
+      })
+      webview.addEventListener('did-finish-load', function () {
+        const tabId = webview.getWebContents().getId()
+        document.body.removeChild(webview)
+        assert.notEqual(tabId, -1)
+        assert.equal(tabIds.mainFrame, tabId)
+        assert.equal(tabIds.subFrame, tabId)
+        done()
+      })
+      webview.src = defaultURL + 'tab-with-frame'
+      document.body.appendChild(webview)
+    })
+
     it('receives details object', function (done) {
       ses.webRequest.onBeforeRequest(function (details, callback) {
         assert.equal(typeof details.id, 'number')
@@ -156,6 +182,86 @@ describe('webRequest module', function () {
     })
   })
 
+  describe('webRequest.setRules', function () {
+    afterEach(function () {
+      ses.webRequest.setRules([])
+    })
+
+    it('can block requests', function (done) {
+      ses.webRequest.setRules([
+        {action: 'block', urls: [defaultURL + 'blocked/*']}
+      ])
+      $.ajax({
+        url: defaultURL + 'blocked/test',
+        success: function () {
+          done('unexpected success')
+        },
+        error: function () {
+          done()
+        }
+      })
+    })
+
+    it('can redirect requests', function (done) {
+      ses.webRequest.setRules([
+        {action: 'redirect', urls: [defaultURL + 'from'], redirectURL: defaultURL + 'to'}
+      ])
+      $.ajax({
+        url: defaultURL + 'from',
+        success: function (data) {
+          assert.equal(data, '/to')
+          done()
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('can modify request headers', function (done) {
+      ses.webRequest.setRules([
+        {action: 'modifyHeaders', requestHeaders: {Accept: '*/*;test/header'}}
+      ])
+      $.ajax({
+        url: defaultURL,
+        success: function (data) {
+          assert.equal(data, '/header/received')
+          done()
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('rejects rules with invalid URL patterns', function () {
+      assert.throws(function () {
+        ses.webRequest.setRules([{action: 'block', urls: ['not a pattern']}])
+      })
+      assert.throws(function () {
+        ses.webRequest.setRules([
+          {action: 'block', urls: ['*://*/*'], firstPartyUrls: 'oops'}
+        ])
+      })
+    })
+
+    it('only matches the given resource types', function (done) {
+      ses.webRequest.setRules([
+        {action: 'block', resourceTypes: ['image']}
+      ])
+      $.ajax({
+        url: defaultURL,
+        success: function (data) {
+          assert.equal(data, '/')
+          done()
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+  })
+
   describe('webRequest.onBeforeSendHeaders', function () {
     afterEach(function () {
       ses.webRequest.onBeforeSendHeaders(null)
@@ -433,6 +539,37 @@ describe('webRequest module', function () {
     })
   })
 
+  describe('batched webRequest.onCompleted', function () {
+    afterEach(function () {
+      ses.webRequest.onCompleted(null)
+    })
+
+    it('receives an array of details objects', function (done) {
+      ses.webRequest.onCompleted({batch: {interval: 10}}, function (detailsArray) {
+        assert(Array.isArray(detailsArray))
+        assert(detailsArray.length > 0)
+        assert.equal(detailsArray[0].statusCode, 200)
+        ses.webRequest.getBatchStats(function (stats) {
+          assert(stats.batched >= detailsArray.length)
+          assert(stats.delivered <= stats.batched)
+          done()
+        })
+      })
+      $.ajax({
+        url: defaultURL,
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('throws for invalid batch options', function () {
+      assert.throws(function () {
+        ses.webRequest.onCompleted({batch: {size: 0}}, function () {})
+      })
+    })
+  })
+
   describe('webRequest.onErrorOccurred', function () {
     afterEach(function () {
       ses.webRequest.onErrorOccurred(null)
@@ -940,5 +940,16 @@ describe('asar package', function () {
         height: 1024
       })
     })
+
+    it('caches the archive lookup of the image directory', function () {
+      var getStats = process.binding('atom_common_asar').getArchivePathCacheStats
+      var p = path.join(fixtures, 'assets', 'logo.png')
+      nativeImage.createFromPath(p)
+      var before = getStats()
+      nativeImage.createFromPath(p)
+      var after = getStats()
+      assert(after.hits > before.hits)
+      assert.equal(after.misses, before.misses)
+    })
   })
 })
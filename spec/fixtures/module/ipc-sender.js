@@ -0,0 +1,32 @@
+// Keeps the event.sender of every 'sender-ping' message in the main process,
+// where the objects themselves can be compared. Through remote the spec would
+// only see proxies.
+const {ipcMain} = require('electron')
+
+const senders = []
+let waiting = null
+
+ipcMain.on('sender-ping', function (event) {
+  senders.push(event.sender)
+  if (waiting && senders.length >= waiting.count) {
+    const callback = waiting.callback
+    waiting = null
+    callback()
+  }
+})
+
+exports.count = function () {
+  return senders.length
+}
+
+exports.waitFor = function (count, callback) {
+  if (senders.length >= count) {
+    callback()
+  } else {
+    waiting = {count, callback}
+  }
+}
+
+exports.isSameSender = function (a, b) {
+  return senders[a] === senders[b]
+}
@@ -0,0 +1,17 @@
+// Runs in the main process, where the ArrayBuffer is the one handed to the
+// worker rather than a copy made by remote.
+const {app} = require('electron')
+
+module.exports = function (callback) {
+  const worker = app.createWorker('fixtures/workers/echo')
+  let sentByteLength = null
+  worker.onmessage = function (event) {
+    worker.terminate()
+    callback(sentByteLength, event.data.byteLength)
+  }
+  worker.start(function () {
+    const buffer = new ArrayBuffer(16)
+    worker.postMessage(buffer, [buffer])
+    sentByteLength = buffer.byteLength
+  })
+}
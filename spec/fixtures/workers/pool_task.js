@@ -0,0 +1,14 @@
+// Tells the pool specs which worker ran a task.
+const workerId = Math.random()
+
+self.onmessage = function (event) {
+  const task = event.data
+  try {
+    if (task.fail) throw new Error(task.fail)
+    const end = Date.now() + (task.delay || 0)
+    while (Date.now() < end) {}
+    postMessage({workerId: workerId, value: task.value})
+  } catch (error) {
+    onerror(error)
+  }
+}
@@ -0,0 +1,9 @@
+self.onconnect = function (event) {
+  const port = event.ports[0]
+  port.onmessage = function (e) {
+    port.postMessage(e.data)
+  }
+  port.onclose = function () {
+    postMessage('port-closed')
+  }
+}
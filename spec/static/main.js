@@ -27,6 +27,8 @@ process.port = 0 // will be used by crash-reporter spec.
 app.commandLine.appendSwitch('js-flags', '--expose_gc')
 app.commandLine.appendSwitch('ignore-certificate-errors')
 app.commandLine.appendSwitch('disable-renderer-backgrounding')
+// Workers load their modules relative to the spec directory.
+app.commandLine.appendSwitch('source-root', path.join(__dirname, '..'))
 
 // Accessing stdout in the main process will result in the process.stdout
 // throwing UnknownSystemError in renderer process sometimes. This line makes
@@ -70,6 +72,29 @@ ipcMain.on('echo', function (event, msg) {
   event.returnValue = msg
 })
 
+// Reports how the arguments of ipcRenderer.sendCloned arrived, since remote
+// can't hand typed arrays, Maps or Dates back to the spec as they are.
+ipcMain.on('cloned-message', function (event, bytes, map, date, object) {
+  event.sender.send('cloned-message-result', {
+    bytes: bytes instanceof Uint8Array ? Array.from(bytes) : null,
+    map: map instanceof Map ? Array.from(map) : null,
+    date: date instanceof Date ? date.getTime() : null,
+    nestedBytes: object.nested.bytes instanceof Uint8Array
+      ? Array.from(object.nested.bytes) : null,
+    nestedDate: object.nested.date instanceof Date
+      ? object.nested.date.getTime() : null,
+    name: object.name
+  })
+})
+
+ipcMain.on('send-cloned', function (event) {
+  event.sender.sendCloned('cloned-reply',
+    new Uint8Array([1, 2, 3]),
+    new Map([['a', 1], ['b', {c: 2}]]),
+    new Date(1500000000000),
+    {name: 'outer', nested: {bytes: new Uint8Array([4, 5]), date: new Date(0)}})
+})
+
 const coverage = new Coverage({
   outputPath: path.join(__dirname, '..', '..', 'out', 'coverage')
 })